@@ -0,0 +1,28 @@
+#include "asset_source.hpp"
+#include "mapped_file.hpp"
+#include "hash.hpp"
+
+namespace nwt{
+namespace {
+    int64_t lastWriteTime(const std::filesystem::path& path) {
+        return static_cast<int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+    }
+}
+
+AssetSource AssetSource::fromFile(const std::filesystem::path& path) {
+    const MappedFile file(path);
+    return { Hash::HashBytes(file.data(), file.size()), file.size(), lastWriteTime(path) };
+}
+
+bool AssetSource::isStale(const std::filesystem::path& path) const {
+    std::error_code error;
+    const uint64_t currentSize = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    if (currentSize != size) {
+        return true;
+    }
+    return lastWriteTime(path) != modifiedTime && fromFile(path).hash != hash;
+}
+}
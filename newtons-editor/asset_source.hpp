@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+namespace nwt{
+    // Identifies the source file a cached asset was built from
+    struct AssetSource{
+        uint64_t hash;
+        uint64_t size;
+        int64_t modifiedTime;
+
+        static AssetSource fromFile(const std::filesystem::path& path);
+
+        // Whether path no longer matches this source. A touched but unchanged file keeps its cache, the file is only
+        // hashed when its modification time differs. A missing source never makes a cache stale, it is all there is.
+        bool isStale(const std::filesystem::path& path) const;
+    };
+}
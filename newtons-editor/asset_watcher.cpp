@@ -0,0 +1,111 @@
+#include "asset_watcher.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <utility>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace nwt{
+AssetWatcher::AssetWatcher(std::vector<std::filesystem::path> directories)
+    : _directories(std::move(directories)) {
+#if defined(__linux__)
+    _inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    _thread = std::jthread([this](std::stop_token stopToken) { watch(stopToken); });
+}
+
+AssetWatcher::~AssetWatcher() {
+    _thread.request_stop();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+#if defined(__linux__)
+    if (_inotify >= 0) {
+        close(_inotify);
+    }
+#endif
+}
+
+std::vector<std::filesystem::path> AssetWatcher::changes() {
+    const std::lock_guard lock(_mutex);
+    return std::exchange(_changes, {});
+}
+
+void AssetWatcher::report(std::filesystem::path path) {
+    const std::lock_guard lock(_mutex);
+    // Saving a file can raise several events, the reader only needs to hear about it once
+    if (std::find(_changes.begin(), _changes.end(), path) == _changes.end()) {
+        _changes.push_back(std::move(path));
+    }
+}
+
+#if defined(__linux__)
+void AssetWatcher::watch(std::stop_token stopToken) {
+    if (_inotify < 0) {
+        return;
+    }
+
+    // Close-write covers files written in place, moved-to covers editors and tools that save through a rename
+    std::map<int, std::filesystem::path> directories;
+    for (const std::filesystem::path& directory : _directories) {
+        const int descriptor = inotify_add_watch(_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (descriptor >= 0) {
+            directories[descriptor] = directory;
+        }
+    }
+
+    alignas(inotify_event) char buffer[4096];
+    while (!stopToken.stop_requested()) {
+        // The timeout only bounds how long a stop request waits
+        pollfd descriptor{ _inotify, POLLIN, 0 };
+        if (poll(&descriptor, 1, 100) <= 0) {
+            continue;
+        }
+
+        const ssize_t length = read(_inotify, buffer, sizeof(buffer));
+        for (ssize_t offset = 0; offset < length;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            const auto directory = directories.find(event->wd);
+            if (event->len > 0 && directory != directories.end()) {
+                report(directory->second / event->name);
+            }
+            offset += sizeof(inotify_event) + event->len;
+        }
+    }
+}
+#else
+void AssetWatcher::watch(std::stop_token stopToken) {
+    const auto scan = [this] {
+        std::map<std::filesystem::path, std::filesystem::file_time_type> times;
+        for (const std::filesystem::path& directory : _directories) {
+            std::error_code error;
+            for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+                if (entry.is_regular_file(error)) {
+                    times[directory / entry.path().filename()] = entry.last_write_time(error);
+                }
+            }
+        }
+        return times;
+    };
+
+    std::map<std::filesystem::path, std::filesystem::file_time_type> known = scan();
+    while (!stopToken.stop_requested()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        std::map<std::filesystem::path, std::filesystem::file_time_type> current = scan();
+        for (const auto& [path, time] : current) {
+            const auto it = known.find(path);
+            if (it == known.end() || it->second != time) {
+                report(path);
+            }
+        }
+        known = std::move(current);
+    }
+}
+#endif
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nwt{
+    // Reports files written in a set of directories, from a background thread. On Linux the thread waits on inotify,
+    // elsewhere it polls the modification times of the files twice a second.
+    class AssetWatcher{
+    public:
+        explicit AssetWatcher(std::vector<std::filesystem::path> directories);
+        ~AssetWatcher();
+
+        AssetWatcher(const AssetWatcher&) = delete;
+        AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+        // Files changed since the last call, each once, as watched directory / file name
+        std::vector<std::filesystem::path> changes();
+
+    private:
+        void watch(std::stop_token stopToken);
+        void report(std::filesystem::path path);
+
+        std::vector<std::filesystem::path> _directories;
+        std::mutex _mutex;
+        std::vector<std::filesystem::path> _changes;
+        int _inotify = -1;
+        std::jthread _thread;
+    };
+}
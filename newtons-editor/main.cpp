@@ -15,10 +15,14 @@
 #include <algorithm>
 #include <fstream>
 #include <unordered_map>
-
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-#include "obj_reader.hpp"
+#include <memory>
+#include <future>
+#include <functional>
+#include <span>
+
+#include "asset_watcher.hpp"
+#include "mesh_cache.hpp"
+#include "texture.hpp"
 #include "hash.hpp"
 #include "vertex.hpp"
 #include "transformationMatrices.hpp"
@@ -58,8 +62,10 @@ class NewtonsVulkanEngine {
 public:
 	void run()
 	{
+		startAssetLoads();
 		initWindow();
 		initVulkan();
+		_assetWatcher = std::make_unique<AssetWatcher>(std::vector<std::filesystem::path>{ "models", "imgs", "shaders" });
 		mainLoop();
 		cleanup();
 	}
@@ -99,6 +105,8 @@ private:
 	std::vector<void*> _uniformBuffersMapped;
 	VkDescriptorPool _descriptorPool;
 	std::vector<VkDescriptorSet> _descriptorSets;
+	// Mapped texture cache, the image format and mip levels come from it
+	std::unique_ptr<TextureCache> _texture;
 	VkImage _textureImage;
 	VkDeviceMemory _textureImageMemory;
 	VkImageView _textureImageView;
@@ -117,11 +125,36 @@ private:
 		VK_KHR_SWAPCHAIN_EXTENSION_NAME,
 	};
 
-	std::vector<Vertex> vertices;
-	std::vector<uint32_t> indices;
+	// Started at launch so loading and decoding overlap window, device and pipeline creation, the first upload waits on them
+	std::future<std::unique_ptr<MeshCache>> _modelLoad;
+	std::future<std::unique_ptr<TextureCache>> _textureLoad;
+
+	// Sources are watched after the first upload, a changed one is loaded again on a background thread and its new
+	// buffers replace the old ones at the start of a later frame
+	std::unique_ptr<AssetWatcher> _assetWatcher;
+	bool _modelReloadRequested = false;
+	bool _textureReloadRequested = false;
+	// Bumped when the texture is replaced, a frame's descriptor set is rewritten when it is behind
+	uint64_t _textureGeneration = 0;
+	std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> _descriptorTextureGenerations{};
+
+	// Resources that in flight frames may still use, destroyed once the frame they were retired in has finished
+	struct RetiredResource {
+		uint64_t frame;
+		std::function<void()> destroy;
+	};
+	std::vector<RetiredResource> _retiredResources;
+	uint64_t _frameNumber = 0;
+
+	// Views into _model, which keeps the mapped cache file alive
+	std::unique_ptr<MeshCache> _model;
+	std::span<const Vertex> vertices;
+	std::span<const uint32_t> indices;
 
 	const std::string MODEL_PATH = "models/viking_room.obj";
+	const std::string MODEL_CACHE_PATH = "models/viking_room.nmesh";
 	const std::string TEXTURE_PATH = "imgs/viking_room.png";
+	const std::string TEXTURE_CACHE_PATH = "imgs/viking_room.ntex";
 
 #ifdef DEBUG
 	static constexpr bool enableValidationLayers = true;
@@ -129,6 +162,15 @@ private:
 	static constexpr bool enableValidationLayers = false;
 #endif
 
+	// The model and camera are fixed, so their matrices are folded at compile time
+	static constexpr Transform modelTransform{ {2.0f, 0.0f, 0.0f}, Quaternion::fromEuler(0.0f * Mathf::DegToRad, 90.0f * Mathf::DegToRad, -90.0f * Mathf::DegToRad), {1.0f, 1.0f, -1.0f } };
+	static constexpr Vec3 cameraPosition{ 0.0f, 2.0f, -5.0f };
+	static constexpr float fieldOfView = 60.0f * Mathf::DegToRad;
+	static constexpr float nearPlane = 0.01f;
+	static constexpr float farPlane = 100.0f;
+	// A level of detail is drawn once its deviation from the full mesh projects to at most this many pixels
+	static constexpr float maxLodPixelError = 1.0f;
+
 private:
 	void initWindow()
 	{
@@ -147,16 +189,33 @@ private:
 		app->_framebufferResized = true;
 	}
 
+	void startAssetLoads()
+	{
+		_modelLoad = std::async(std::launch::async, [this] { return MeshCache::load(MODEL_PATH, MODEL_CACHE_PATH); });
+	}
+
+	// Needs the physical device: the cache is only reused if it holds the format the device can sample, so asking for
+	// BC7 and falling back to RGBA8 would re-encode the texture on every launch of a device without BC support
+	void startTextureLoad()
+	{
+		VkPhysicalDeviceFeatures features;
+		vkGetPhysicalDeviceFeatures(_physicalDevice, &features);
+		const TextureFormat format = features.textureCompressionBC ? TextureFormat::BC7 : TextureFormat::RGBA8;
+		_textureLoad = std::async(std::launch::async, [this, format] { return TextureCache::load(TEXTURE_PATH, TEXTURE_CACHE_PATH, format); });
+	}
+
 	void initVulkan()
 	{
 		createInstance();
 		createSurface();
 		pickPhysicalDevice();
+		startTextureLoad();
 		createLogicalDevice();
 		createSwapChain();
 		createImageViews();
 		createRenderPass();
 		createDescriptorSetLayout();
+		createPipelineLayout();
 		createGraphicsPipeline();
 		createCommandPool();
 		createDepthResources();
@@ -187,6 +246,9 @@ private:
 
 	void cleanup()
 	{
+		_assetWatcher.reset();
+		destroyRetiredResources(true);
+
 		cleanupSwapchain();
 
 
@@ -496,8 +558,12 @@ private:
 		//float queuePriority = 1.0f;
 		//queueCreateInfo.pQueuePriorities = &queuePriority;
 
+		VkPhysicalDeviceFeatures supportedFeatures;
+		vkGetPhysicalDeviceFeatures(_physicalDevice, &supportedFeatures);
+
 		VkPhysicalDeviceFeatures deviceFeatures = {};
 		deviceFeatures.samplerAnisotropy = VK_TRUE;
+		deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
 
 		VkDeviceCreateInfo createInfo = {};
 		createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -662,12 +728,39 @@ private:
 
 	}
 
+	// Created once, the pipelines that shader reloads rebuild all share it
+	void createPipelineLayout() {
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &_descriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 0; // Optional
+		pipelineLayoutInfo.pPushConstantRanges = nullptr; // Optional
+
+		if (vkCreatePipelineLayout(_device, &pipelineLayoutInfo, nullptr, &_pipelineLayout) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create pipeline layout!");
+		}
+	}
+
+	// Replaces _graphicsPipeline only once the new one exists, so a failed shader reload leaves the old one in place
 	void createGraphicsPipeline() {
 		auto vertShaderCode = readShaderFile("shaders/vert.spv");
 		auto fragShaderCode = readShaderFile("shaders/frag.spv");
 
-		VkShaderModule vertShaderModule = CreateShaderModule(vertShaderCode);
-		VkShaderModule fragShaderModule = CreateShaderModule(fragShaderCode);
+		// The modules are only needed while the pipeline is created, whether that succeeds or throws
+		struct ShaderModules {
+			VkDevice device;
+			VkShaderModule vert = VK_NULL_HANDLE;
+			VkShaderModule frag = VK_NULL_HANDLE;
+			~ShaderModules() {
+				vkDestroyShaderModule(device, frag, nullptr);
+				vkDestroyShaderModule(device, vert, nullptr);
+			}
+		} modules{ _device };
+		modules.vert = CreateShaderModule(vertShaderCode);
+		modules.frag = CreateShaderModule(fragShaderCode);
+		const VkShaderModule vertShaderModule = modules.vert;
+		const VkShaderModule fragShaderModule = modules.frag;
 
 		VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
 		vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -793,17 +886,6 @@ private:
 		depthStencil.front = {}; // Optional
 		depthStencil.back = {}; // Optional
 
-		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		pipelineLayoutInfo.setLayoutCount = 1;
-		pipelineLayoutInfo.pSetLayouts = &_descriptorSetLayout;
-		pipelineLayoutInfo.pushConstantRangeCount = 0; // Optional
-		pipelineLayoutInfo.pPushConstantRanges = nullptr; // Optional
-
-		if (vkCreatePipelineLayout(_device, &pipelineLayoutInfo, nullptr, &_pipelineLayout) != VK_SUCCESS) {
-			throw std::runtime_error("failed to create pipeline layout!");
-		}
-
 		VkGraphicsPipelineCreateInfo pipelineInfo{};
 		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 		pipelineInfo.stageCount = 2;
@@ -822,12 +904,11 @@ private:
 		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
 		pipelineInfo.basePipelineIndex = -1; // Optional
 
-		if (vkCreateGraphicsPipelines(_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &_graphicsPipeline) != VK_SUCCESS) {
+		VkPipeline pipeline;
+		if (vkCreateGraphicsPipelines(_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create graphics pipeline!");
 		}
-
-		vkDestroyShaderModule(_device, fragShaderModule, nullptr);
-		vkDestroyShaderModule(_device, vertShaderModule, nullptr);
+		_graphicsPipeline = pipeline;
 	}
 
 	VkShaderModule CreateShaderModule(const std::vector<char>& code) {
@@ -964,6 +1045,8 @@ private:
 			throw std::runtime_error("failed to begin recording command buffer!");
 		}
 
+		recordAssetReloads(commandBuffer);
+
 		VkRenderPassBeginInfo renderPassInfo{};
 		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 		renderPassInfo.renderPass = _renderPass;
@@ -1003,9 +1086,23 @@ private:
 		scissor.extent = _swapChainExtent;
 		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
+		if (_descriptorTextureGenerations[_currentFrame] != _textureGeneration) {
+			writeTextureDescriptor(_currentFrame);
+		}
 		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipelineLayout, 0, 1, &_descriptorSets[_currentFrame], 0, nullptr);
 
-		vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
+		// One draw per material, or per run of visible meshlets when the mesh has them. There is only the one texture
+		// so far so they all share the descriptor set.
+		const MeshLod& lod = _model->lods()[selectLod()];
+		constexpr Mat4x4 model = modelTransform.localToWorldMatrix();
+		constexpr Mat4x4 view = Mat4x4::lookAt(cameraPosition, Vec3(0.0f, 0.0f, 0.0f));
+		const Mat4x4 proj = Mat4x4::perspective(fieldOfView, _swapChainExtent.width / (float)_swapChainExtent.height, nearPlane, farPlane);
+		// Culling happens in the space of the mesh, where the meshlet bounds are
+		const std::array<Vec4, 6> planes = frustumPlanes(proj * view * model);
+		const Vec4 localCamera = model.affineInverse() * Vec4(cameraPosition.x, cameraPosition.y, cameraPosition.z, 1.0f);
+		for (const SubMesh& subMesh : _model->subMeshes(lod)) {
+			drawVisibleMeshlets(commandBuffer, subMesh, planes, Vec3(localCamera.x, localCamera.y, localCamera.z));
+		}
 
 		vkCmdEndRenderPass(commandBuffer);
 		if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
@@ -1018,6 +1115,7 @@ private:
 		//auto start = std::chrono::high_resolution_clock::now();
 
 		vkWaitForFences(_device, 1, &_inFlightFences[_currentFrame], VK_TRUE, UINT64_MAX);
+		destroyRetiredResources(false);
 
 		uint32_t imageIndex;
 		VkResult result = vkAcquireNextImageKHR(_device, _swapChain, UINT64_MAX, _imageAvailableSemaphores[_currentFrame], VK_NULL_HANDLE, &imageIndex);
@@ -1081,6 +1179,7 @@ private:
 		}
 
 		_currentFrame = (_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+		_frameNumber++;
 
 		//auto end = std::chrono::high_resolution_clock::now();
 		//LOG((end - start) / 1000000.0f);
@@ -1128,44 +1227,46 @@ private:
 	}
 
 	void createVertexBuffer() {
-		VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
-
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingBufferMemory;
-		createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
-
-		void* data;
-		vkMapMemory(_device, stagingBufferMemory, 0, bufferSize, 0, &data);
-		memcpy(data, vertices.data(), (size_t)bufferSize);
-		vkUnmapMemory(_device, stagingBufferMemory);
-
-		createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, _vertexBuffer, _vertexBufferMemory);
-
-		copyBuffer(stagingBuffer, _vertexBuffer, bufferSize);
-
-
-		vkDestroyBuffer(_device, stagingBuffer, nullptr);
-		vkFreeMemory(_device, stagingBufferMemory, nullptr);
+		VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+		uploadBuffer(commandBuffer, vertices.data(), vertices.size_bytes(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, _vertexBuffer, _vertexBufferMemory);
+		endSingleTimeCommands(commandBuffer);
 	}
 
 	void createIndexBuffer() {
-		VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
+		VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+		uploadBuffer(commandBuffer, indices.data(), indices.size_bytes(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, _indexBuffer, _indexBufferMemory);
+		endSingleTimeCommands(commandBuffer);
+	}
 
+	// Records copying data into a new device local buffer, the staging buffer is retired with the current frame
+	void uploadBuffer(VkCommandBuffer commandBuffer, const void* data, VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer& buffer, VkDeviceMemory& bufferMemory) {
 		VkBuffer stagingBuffer;
 		VkDeviceMemory stagingBufferMemory;
-		createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+		createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
 
-		void* data;
-		vkMapMemory(_device, stagingBufferMemory, 0, bufferSize, 0, &data);
-		memcpy(data, indices.data(), (size_t)bufferSize);
+		void* mapped;
+		vkMapMemory(_device, stagingBufferMemory, 0, size, 0, &mapped);
+		memcpy(mapped, data, static_cast<size_t>(size));
 		vkUnmapMemory(_device, stagingBufferMemory);
 
-		createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, _indexBuffer, _indexBufferMemory);
+		createBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, bufferMemory);
+
+		VkBufferCopy copyRegion{};
+		copyRegion.size = size;
+		vkCmdCopyBuffer(commandBuffer, stagingBuffer, buffer, 1, &copyRegion);
 
-		copyBuffer(stagingBuffer, _indexBuffer, bufferSize);
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = buffer;
+		barrier.offset = 0;
+		barrier.size = VK_WHOLE_SIZE;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
 
-		vkDestroyBuffer(_device, stagingBuffer, nullptr);
-		vkFreeMemory(_device, stagingBufferMemory, nullptr);
+		retireBuffer(stagingBuffer, stagingBufferMemory);
 	}
 
 	uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
@@ -1207,16 +1308,6 @@ private:
 		vkBindBufferMemory(_device, buffer, bufferMemory, 0);
 	}
 
-	void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
-		VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
-		VkBufferCopy copyRegion{};
-		copyRegion.size = size;
-		vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-
-		endSingleTimeCommands(commandBuffer);
-	}
-
 	void createDescriptorSetLayout() {
 		VkDescriptorSetLayoutBinding uboLayoutBinding{};
 		uboLayoutBinding.binding = 0;
@@ -1264,16 +1355,68 @@ private:
 
 		TransformationMatrices ubo{};
 
-		Transform modelTransform({2.0f, 0.0f, 0.0f}, Quaternion::fromEuler(0.0f * Mathf::DegToRad, 90.0f * Mathf::DegToRad, -90.0f * Mathf::DegToRad), {1.0f, 1.0f, -1.0f });
-		ubo.model = modelTransform.localToWorldMatrix();
-		ubo.view = Mat4x4::lookAt(Vec3(0.0f, 2.0f, -5.0f), Vec3(0.0f, 0.0f, 0.0f));
-		ubo.proj = Mat4x4::perspective(60.0f * Mathf::DegToRad, _swapChainExtent.width / (float)_swapChainExtent.height, 0.01f, 100.0f);
+		constexpr Mat4x4 model = modelTransform.localToWorldMatrix();
+		constexpr Mat4x4 view = Mat4x4::lookAt(cameraPosition, Vec3(0.0f, 0.0f, 0.0f));
+		ubo.model = model;
+		ubo.view = view;
+		ubo.proj = Mat4x4::perspective(fieldOfView, _swapChainExtent.width / (float)_swapChainExtent.height, nearPlane, farPlane);
 		ubo.proj[5] *= -1;
 
 		memcpy(_uniformBuffersMapped[currentFrame], &ubo, sizeof(ubo));
 	}
 
 
+	// Draws the meshlets of subMesh that are inside the frustum and face the camera, a meshlet's triangles are an index range
+	// and neighbouring meshlets neighbouring ranges, so every run of visible meshlets is a single draw
+	void drawVisibleMeshlets(VkCommandBuffer commandBuffer, const SubMesh& subMesh, std::span<const Vec4, 6> planes, const Vec3& localCamera) const {
+		const std::span<const Meshlet> meshlets = _model->meshlets(subMesh);
+		if (meshlets.empty()) {
+			vkCmdDrawIndexed(commandBuffer, subMesh.indexCount, 1, subMesh.firstIndex, 0, 0);
+			return;
+		}
+
+		uint32_t runFirstIndex = 0;
+		uint32_t runIndexCount = 0;
+		for (const Meshlet& meshlet : meshlets) {
+			if (isOutsideFrustum(meshlet, planes) || isBackfacing(meshlet, localCamera)) {
+				continue;
+			}
+			if (runIndexCount > 0 && meshlet.firstIndex != runFirstIndex + runIndexCount) {
+				vkCmdDrawIndexed(commandBuffer, runIndexCount, 1, runFirstIndex, 0, 0);
+				runIndexCount = 0;
+			}
+			if (runIndexCount == 0) {
+				runFirstIndex = meshlet.firstIndex;
+			}
+			runIndexCount += 3 * meshlet.triangleCount;
+		}
+		if (runIndexCount > 0) {
+			vkCmdDrawIndexed(commandBuffer, runIndexCount, 1, runFirstIndex, 0, 0);
+		}
+	}
+
+	// Coarsest level of detail whose error, at the distance of the nearest point of the model's bounding sphere,
+	// covers at most maxLodPixelError pixels on screen
+	uint32_t selectLod() const {
+		const std::span<const MeshLod> lods = _model->lods();
+		const Vec3 boundsMin = _model->header().boundsMin;
+		const Vec3 boundsMax = _model->header().boundsMax;
+		const Vec3 center = (boundsMin + boundsMax) * 0.5f;
+		const float scale = std::max({ Mathf::abs(modelTransform.scale.x), Mathf::abs(modelTransform.scale.y), Mathf::abs(modelTransform.scale.z) });
+		const float radius = 0.5f * (boundsMax - boundsMin).magnitude() * scale;
+
+		constexpr Mat4x4 model = modelTransform.localToWorldMatrix();
+		const Vec4 worldCenter = model * Vec4(center.x, center.y, center.z, 1.0f);
+		const float distance = std::max((Vec3(worldCenter.x, worldCenter.y, worldCenter.z) - cameraPosition).magnitude() - radius, nearPlane);
+		const float pixelsPerUnit = scale * static_cast<float>(_swapChainExtent.height) / (2.0f * distance * Mathf::tan(fieldOfView * 0.5f));
+
+		uint32_t lod = 0;
+		while (lod + 1 < lods.size() && lods[lod + 1].error * pixelsPerUnit <= maxLodPixelError) {
+			lod++;
+		}
+		return lod;
+	}
+
 	void createDescriptorPool() {
 
 		std::array<VkDescriptorPoolSize, 2> poolSize{};
@@ -1345,14 +1488,19 @@ private:
 	}
 
 	void createTextureImage() {
-		int texHeight, texWidth, texChannels;
-		stbi_uc* pixels = stbi_load(TEXTURE_PATH.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+		// The cache is encoded offline or by startTextureLoad, so only the upload happens here
+		_texture = _textureLoad.get();
 
-		VkDeviceSize imageSize = texWidth * texHeight * 4;
+		VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+		uploadTexture(commandBuffer, *_texture, _textureImage, _textureImageMemory);
+		endSingleTimeCommands(commandBuffer);
+	}
 
-		if (!pixels) {
-			throw std::runtime_error("failed to load texture image!");
-		}
+	// Records the upload of every level of texture into a new image, the staging buffer is retired with the current frame
+	void uploadTexture(VkCommandBuffer commandBuffer, const TextureCache& texture, VkImage& image, VkDeviceMemory& imageMemory) {
+		const std::span<const uint8_t> payload = texture.payload();
+		VkDeviceSize imageSize = payload.size();
+		const uint32_t mipLevels = texture.header().levelCount;
 
 		VkBuffer stagingBuffer;
 		VkDeviceMemory stagingBufferMemory;
@@ -1360,32 +1508,42 @@ private:
 
 		void* data;
 		vkMapMemory(_device, stagingBufferMemory, 0, imageSize, 0, &data);
-		memcpy(data, pixels, static_cast<size_t>(imageSize));
+		memcpy(data, payload.data(), static_cast<size_t>(imageSize));
 		vkUnmapMemory(_device, stagingBufferMemory);
 
-		stbi_image_free(pixels);
-
-		createImage(static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, _textureImage, _textureImageMemory);
+		std::vector<VkBufferImageCopy> regions;
+		for (const TextureCacheLevel& level : texture.levels()) {
+			VkBufferImageCopy region{};
+			region.bufferOffset = level.offset;
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = static_cast<uint32_t>(regions.size());
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
+			region.imageOffset = { 0, 0, 0 };
+			region.imageExtent = { level.width, level.height, 1 };
+			regions.push_back(region);
+		}
 
-		transitionImageLayout(_textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+		const VkFormat format = texture.vkFormat();
+		createImage(texture.header().width, texture.header().height, format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, imageMemory, mipLevels);
 
-		copyBufferToImage(stagingBuffer, _textureImage, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight));
+		transitionImageLayout(commandBuffer, image, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
 
-		transitionImageLayout(_textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		copyBufferToImage(commandBuffer, stagingBuffer, image, regions);
 
-		vkDestroyBuffer(_device, stagingBuffer, nullptr);
-		vkFreeMemory(_device, stagingBufferMemory, nullptr);
+		transitionImageLayout(commandBuffer, image, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mipLevels);
 
+		retireBuffer(stagingBuffer, stagingBufferMemory);
 	}
 
-	void createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory) {
+	void createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory, uint32_t mipLevels = 1) {
 		VkImageCreateInfo imageInfo{};
 		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 		imageInfo.imageType = VK_IMAGE_TYPE_2D;
 		imageInfo.extent.width = static_cast<uint32_t>(width);
 		imageInfo.extent.height = static_cast<uint32_t>(height);
 		imageInfo.extent.depth = 1;
-		imageInfo.mipLevels = 1;
+		imageInfo.mipLevels = mipLevels;
 		imageInfo.arrayLayers = 1;
 		imageInfo.format = format;
 		imageInfo.tiling = tiling;
@@ -1447,9 +1605,7 @@ private:
 		vkFreeCommandBuffers(_device, _commandPool, 1, &commandBuffer);
 	}
 
-	void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout) {
-		VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
+	void transitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels = 1) {
 		VkImageMemoryBarrier barrier{};
 		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
 		barrier.oldLayout = oldLayout;
@@ -1459,7 +1615,7 @@ private:
 		barrier.image = image;
 		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		barrier.subresourceRange.baseMipLevel = 0;
-		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.levelCount = mipLevels;
 		barrier.subresourceRange.baseArrayLayer = 0;
 		barrier.subresourceRange.layerCount = 1;
 
@@ -1492,48 +1648,25 @@ private:
 			0, nullptr,
 			1, &barrier
 		);
-
-		endSingleTimeCommands(commandBuffer);
 	}
 
-	void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height) {
-		VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
-		VkBufferImageCopy region{};
-		region.bufferOffset = 0;
-		region.bufferRowLength = 0;
-		region.bufferImageHeight = 0;
-
-		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		region.imageSubresource.mipLevel = 0;
-		region.imageSubresource.baseArrayLayer = 0;
-		region.imageSubresource.layerCount = 1;
-
-		region.imageOffset = { 0, 0, 0 };
-		region.imageExtent = {
-			width,
-			height,
-			1
-		};
-
+	void copyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkImage image, const std::vector<VkBufferImageCopy>& regions) {
 		vkCmdCopyBufferToImage(
 			commandBuffer,
 			buffer,
 			image,
 			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-			1,
-			&region
+			static_cast<uint32_t>(regions.size()),
+			regions.data()
 		);
-
-		endSingleTimeCommands(commandBuffer);
 	}
 
 	void createTextureImageView() {
 
-		_textureImageView = createImageView(_textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT);
+		_textureImageView = createImageView(_textureImage, _texture->vkFormat(), VK_IMAGE_ASPECT_COLOR_BIT, _texture->header().levelCount);
 	}
 
-	VkImageView createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags) {
+	VkImageView createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels = 1) {
 		VkImageViewCreateInfo viewInfo{};
 		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
 		viewInfo.image = image;
@@ -1541,7 +1674,7 @@ private:
 		viewInfo.format = format;
 		viewInfo.subresourceRange.aspectMask = aspectFlags;
 		viewInfo.subresourceRange.baseMipLevel = 0;
-		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.levelCount = mipLevels;
 		viewInfo.subresourceRange.baseArrayLayer = 0;
 		viewInfo.subresourceRange.layerCount = 1;
 
@@ -1574,7 +1707,8 @@ private:
 		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
 		samplerInfo.mipLodBias = 0.0f;
 		samplerInfo.minLod = 0.0f;
-		samplerInfo.maxLod = 0.0f;
+		// Unclamped so a reloaded texture with more levels can keep the sampler
+		samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
 
 		if (vkCreateSampler(_device, &samplerInfo, nullptr, &_textureSampler) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create texture sampler!");
@@ -1616,41 +1750,156 @@ private:
 	}
 
 	void loadModel() {
-		obj::Object objModel;
-		obj::ReadObjFile(MODEL_PATH.c_str(), objModel);
-		std::unordered_map<Vertex, uint32_t> map;
-
-		indices.reserve(objModel.indices.size());
-		for (auto& index : objModel.indices) {
-			Vertex vertex{};
-
-			vertex.pos = {
-				objModel.vertices[3 * index.vertex_index + 0],
-				objModel.vertices[3 * index.vertex_index + 1],
-				objModel.vertices[3 * index.vertex_index + 2],
-			};
-
-			vertex.texCoord = {
-				objModel.tex_coords[2 * index.tex_coord_index + 0],
-				1.0f - objModel.tex_coords[2 * index.tex_coord_index + 1]
-			};
+		_model = _modelLoad.get();
+		vertices = _model->vertices();
+		indices = _model->indices();
+	}
 
-			vertex.color = { 1.0f, 1.0f, 1.0f };
+	template<typename T>
+	static bool isReady(const std::future<T>& future) {
+		return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	}
 
-			if (!map.contains(vertex)) {
-				map[vertex] = static_cast<uint32_t>(vertices.size());
-				vertices.push_back(vertex);
+	// Starts loads for sources the watcher reported and records the upload of finished ones into commandBuffer, before
+	// anything is bound. The replaced resources are retired instead of destroyed, earlier frames may still use them.
+	void recordAssetReloads(VkCommandBuffer commandBuffer) {
+		bool shadersChanged = false;
+		for (const std::filesystem::path& path : _assetWatcher ? _assetWatcher->changes() : std::vector<std::filesystem::path>()) {
+			if (path == std::filesystem::path(MODEL_PATH))
+				_modelReloadRequested = true;
+			else if (path == std::filesystem::path(TEXTURE_PATH))
+				_textureReloadRequested = true;
+			else if (path.extension() == ".spv")
+				shadersChanged = true;
+		}
+
+		// A change during a load starts another one once it is done, the file may have been read half written
+		if (_modelReloadRequested && !_modelLoad.valid()) {
+			_modelReloadRequested = false;
+			_modelLoad = std::async(std::launch::async, [this] { return MeshCache::load(MODEL_PATH, MODEL_CACHE_PATH); });
+		}
+		if (_textureReloadRequested && !_textureLoad.valid()) {
+			_textureReloadRequested = false;
+			const TextureFormat format = _texture->header().format;
+			_textureLoad = std::async(std::launch::async, [this, format] { return TextureCache::load(TEXTURE_PATH, TEXTURE_CACHE_PATH, format); });
+		}
+
+		if (isReady(_modelLoad)) {
+			// The new buffers are uploaded first, the current ones stay bound if that fails
+			VkBuffer vertexBuffer = VK_NULL_HANDLE, indexBuffer = VK_NULL_HANDLE;
+			VkDeviceMemory vertexBufferMemory = VK_NULL_HANDLE, indexBufferMemory = VK_NULL_HANDLE;
+			try {
+				std::unique_ptr<MeshCache> model = _modelLoad.get();
+				const std::span<const Vertex> modelVertices = model->vertices();
+				const std::span<const uint32_t> modelIndices = model->indices();
+				uploadBuffer(commandBuffer, modelVertices.data(), modelVertices.size_bytes(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer, vertexBufferMemory);
+				uploadBuffer(commandBuffer, modelIndices.data(), modelIndices.size_bytes(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer, indexBufferMemory);
+
+				retireBuffer(_vertexBuffer, _vertexBufferMemory);
+				retireBuffer(_indexBuffer, _indexBufferMemory);
+				_vertexBuffer = vertexBuffer;
+				_vertexBufferMemory = vertexBufferMemory;
+				_indexBuffer = indexBuffer;
+				_indexBufferMemory = indexBufferMemory;
+				_model = std::move(model);
+				vertices = modelVertices;
+				indices = modelIndices;
+				LOG("reloaded " << MODEL_PATH);
+			}
+			catch (const std::exception& e) {
+				// An upload may already be recorded, so what was created is retired with the frame
+				retireBuffer(vertexBuffer, vertexBufferMemory);
+				retireBuffer(indexBuffer, indexBufferMemory);
+				LOG("failed to reload " << MODEL_PATH << ": " << e.what());
 			}
+		}
 
-			//LOG(vertex.pos.x << " " << vertex.pos.y << " " << vertex.pos.z);
+		if (isReady(_textureLoad)) {
+			VkImage image = VK_NULL_HANDLE;
+			VkDeviceMemory imageMemory = VK_NULL_HANDLE;
+			VkImageView view = VK_NULL_HANDLE;
+			try {
+				std::unique_ptr<TextureCache> texture = _textureLoad.get();
+				uploadTexture(commandBuffer, *texture, image, imageMemory);
+				view = createImageView(image, texture->vkFormat(), VK_IMAGE_ASPECT_COLOR_BIT, texture->header().levelCount);
+
+				retire([this, image = _textureImage, memory = _textureImageMemory, view = _textureImageView] {
+					vkDestroyImageView(_device, view, nullptr);
+					vkDestroyImage(_device, image, nullptr);
+					vkFreeMemory(_device, memory, nullptr);
+				});
+				_textureImage = image;
+				_textureImageMemory = imageMemory;
+				_textureImageView = view;
+				_texture = std::move(texture);
+				_textureGeneration++;
+				LOG("reloaded " << TEXTURE_PATH);
+			}
+			catch (const std::exception& e) {
+				retire([this, image, imageMemory, view] {
+					vkDestroyImageView(_device, view, nullptr);
+					vkDestroyImage(_device, image, nullptr);
+					vkFreeMemory(_device, imageMemory, nullptr);
+				});
+				LOG("failed to reload " << TEXTURE_PATH << ": " << e.what());
+			}
+		}
 
-			indices.push_back(map[vertex]);
-			// if (indices.size() % 3 == 0){
-			// 	std::swap(indices[indices.size() - 2], indices[indices.size() - 3]); // INFO: test for clockwise drawing order
-			// }
+		if (shadersChanged) {
+			// Only the pipeline is rebuilt, the layout and descriptor sets stay valid for the new shaders
+			const VkPipeline pipeline = _graphicsPipeline;
+			try {
+				createGraphicsPipeline();
+				retire([this, pipeline] { vkDestroyPipeline(_device, pipeline, nullptr); });
+				LOG("reloaded shaders");
+			}
+			catch (const std::exception& e) {
+				LOG("failed to reload shaders: " << e.what());
+			}
 		}
+	}
+
+	// Points a frame's combined image sampler at the current texture, the frame's fence must have been waited on
+	void writeTextureDescriptor(uint32_t frame) {
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		imageInfo.imageView = _textureImageView;
+		imageInfo.sampler = _textureSampler;
+
+		VkWriteDescriptorSet descriptorWrite{};
+		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrite.dstSet = _descriptorSets[frame];
+		descriptorWrite.dstBinding = 1;
+		descriptorWrite.dstArrayElement = 0;
+		descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		descriptorWrite.descriptorCount = 1;
+		descriptorWrite.pImageInfo = &imageInfo;
+
+		vkUpdateDescriptorSets(_device, 1, &descriptorWrite, 0, nullptr);
+		_descriptorTextureGenerations[frame] = _textureGeneration;
+	}
+
+	void retire(std::function<void()> destroy) {
+		_retiredResources.push_back({ _frameNumber, std::move(destroy) });
+	}
 
-		
+	void retireBuffer(VkBuffer buffer, VkDeviceMemory memory) {
+		retire([this, buffer, memory] {
+			vkDestroyBuffer(_device, buffer, nullptr);
+			vkFreeMemory(_device, memory, nullptr);
+		});
+	}
+
+	// Called after waiting on the current frame's fence, which means every frame up to MAX_FRAMES_IN_FLIGHT ago has
+	// finished. all is for shutdown, once the device is idle.
+	void destroyRetiredResources(bool all) {
+		const auto finished = [&](const RetiredResource& resource) { return all || resource.frame + MAX_FRAMES_IN_FLIGHT <= _frameNumber; };
+		for (RetiredResource& resource : _retiredResources) {
+			if (finished(resource)) {
+				resource.destroy();
+			}
+		}
+		std::erase_if(_retiredResources, finished);
 	}
 
 	static std::vector<char> readShaderFile(const std::string& filename) {
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nwt {
+	/// <summary>
+	/// Read only memory mapping of a whole file, the contents stay valid for the lifetime of the object.
+	/// </summary>
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::filesystem::path& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		std::string_view view() const { return { _data, _size }; }
+		const char* data() const { return _data; }
+		size_t size() const { return _size; }
+
+	private:
+		void unmap();
+
+		const char* _data = nullptr;
+		size_t _size = 0;
+#if defined(_WIN32)
+		HANDLE _file = INVALID_HANDLE_VALUE;
+		HANDLE _mapping = nullptr;
+#endif
+	};
+
+	inline MappedFile::MappedFile(MappedFile&& other) noexcept {
+		*this = std::move(other);
+	}
+
+	inline MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			unmap();
+			_data = std::exchange(other._data, nullptr);
+			_size = std::exchange(other._size, 0);
+#if defined(_WIN32)
+			_file = std::exchange(other._file, INVALID_HANDLE_VALUE);
+			_mapping = std::exchange(other._mapping, nullptr);
+#endif
+		}
+		return *this;
+	}
+
+	inline MappedFile::~MappedFile() {
+		unmap();
+	}
+
+#if defined(_WIN32)
+	inline MappedFile::MappedFile(const std::filesystem::path& path) {
+		_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (_file == INVALID_HANDLE_VALUE) {
+			throw std::runtime_error("Failed to open file " + path.string());
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(_file, &size)) {
+			unmap();
+			throw std::runtime_error("Failed to read the size of " + path.string());
+		}
+		_size = static_cast<size_t>(size.QuadPart);
+		// Empty files can't be mapped, they are just an empty view
+		if (_size == 0) {
+			return;
+		}
+
+		_mapping = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		_data = _mapping ? static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+		if (!_data) {
+			unmap();
+			throw std::runtime_error("Failed to map file " + path.string());
+		}
+	}
+
+	inline void MappedFile::unmap() {
+		if (_data) {
+			UnmapViewOfFile(_data);
+		}
+		if (_mapping) {
+			CloseHandle(_mapping);
+		}
+		if (_file != INVALID_HANDLE_VALUE) {
+			CloseHandle(_file);
+		}
+		_data = nullptr;
+		_size = 0;
+		_mapping = nullptr;
+		_file = INVALID_HANDLE_VALUE;
+	}
+#else
+	inline MappedFile::MappedFile(const std::filesystem::path& path) {
+		const int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			throw std::runtime_error("Failed to open file " + path.string());
+		}
+
+		struct stat info;
+		if (fstat(fd, &info) != 0) {
+			close(fd);
+			throw std::runtime_error("Failed to read the size of " + path.string());
+		}
+		const size_t size = static_cast<size_t>(info.st_size);
+		// Empty files can't be mapped, they are just an empty view
+		if (size == 0) {
+			close(fd);
+			return;
+		}
+
+		void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		// The mapping keeps its own reference to the file
+		close(fd);
+		if (data == MAP_FAILED) {
+			throw std::runtime_error("Failed to map file " + path.string());
+		}
+		madvise(data, size, MADV_SEQUENTIAL);
+		_data = static_cast<const char*>(data);
+		_size = size;
+	}
+
+	inline void MappedFile::unmap() {
+		if (_data) {
+			munmap(const_cast<char*>(_data), _size);
+		}
+		_data = nullptr;
+		_size = 0;
+	}
+#endif
+}
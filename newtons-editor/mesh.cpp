@@ -1,18 +1,280 @@
 #include "mesh.hpp"
+#include "mathf.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+#include "tangents.hpp"
+
+#include <algorithm>
+#include <thread>
 
 namespace nwt{
+namespace {
+    // Below this a thread costs more than the triangles it takes over
+    constexpr size_t minTrianglesPerThread = 4096;
+
+    // Unnormalized normal of a triangle, its length is twice the area, and the angles at its three corners
+    struct WeightedTriangle{
+        Vec3 normal;
+        float angles[3];
+    };
+
+    WeightedTriangle weighTriangle(const Vec3& p0, const Vec3& p1, const Vec3& p2) {
+        const Vec3 e01 = p1 - p0;
+        const Vec3 e02 = p2 - p0;
+        const Vec3 e12 = p2 - p1;
+        const Vec3 normal = Vec3::cross(e01, e02);
+        // atan2 of the cross and dot products stays accurate for thin triangles, where acos of the cosine does not
+        const float twiceArea = normal.magnitude();
+        return { normal, {
+            Mathf::fastAtan2(twiceArea, Vec3::dot(e01, e02)),
+            Mathf::fastAtan2(twiceArea, -Vec3::dot(e01, e12)),
+            Mathf::fastAtan2(twiceArea, Vec3::dot(e02, e12)),
+        } };
+    }
+
+    // Adds the corners of triangles [begin, end) into sums, 3 floats per vertex
+    void accumulateNormals(const Mesh& mesh, size_t begin, size_t end, float* sums) {
+        const auto add = [&](size_t triangle, const Vec3& normal, const float (&angles)[3]) {
+            for (size_t corner = 0; corner < 3; corner++) {
+                float* sum = sums + 3 * static_cast<size_t>(mesh.indices[3 * triangle + corner]);
+                sum[0] += normal.x * angles[corner];
+                sum[1] += normal.y * angles[corner];
+                sum[2] += normal.z * angles[corner];
+            }
+        };
+
+        size_t triangle = begin;
+#if defined(NWT_SIMD_ENABLED)
+        // Four triangles per step with their coordinates in separate registers. The sums are still added one corner
+        // at a time, corners of one step can share a vertex.
+        using simd::f32x4;
+        for (; triangle + 4 <= end; triangle += 4) {
+            alignas(16) float coordinates[3][3][4];
+            for (size_t lane = 0; lane < 4; lane++) {
+                for (size_t corner = 0; corner < 3; corner++) {
+                    const Vec3Packed& position = mesh.vertices[mesh.indices[3 * (triangle + lane) + corner]];
+                    coordinates[corner][0][lane] = position.x;
+                    coordinates[corner][1][lane] = position.y;
+                    coordinates[corner][2][lane] = position.z;
+                }
+            }
+
+            f32x4 e01[3], e02[3], e12[3];
+            for (size_t axis = 0; axis < 3; axis++) {
+                const f32x4 p0 = simd::load(coordinates[0][axis]);
+                const f32x4 p1 = simd::load(coordinates[1][axis]);
+                const f32x4 p2 = simd::load(coordinates[2][axis]);
+                e01[axis] = simd::sub(p1, p0);
+                e02[axis] = simd::sub(p2, p0);
+                e12[axis] = simd::sub(p2, p1);
+            }
+            const auto dot = [](const f32x4 (&a)[3], const f32x4 (&b)[3]) {
+                return simd::madd(a[2], b[2], simd::madd(a[1], b[1], simd::mul(a[0], b[0])));
+            };
+
+            const f32x4 normal[3] = {
+                simd::sub(simd::mul(e01[1], e02[2]), simd::mul(e01[2], e02[1])),
+                simd::sub(simd::mul(e01[2], e02[0]), simd::mul(e01[0], e02[2])),
+                simd::sub(simd::mul(e01[0], e02[1]), simd::mul(e01[1], e02[0])),
+            };
+            const f32x4 twiceArea = simd::sqrt(dot(normal, normal));
+
+            alignas(16) float normals[3][4], angles[3][4];
+            simd::store(normals[0], normal[0]);
+            simd::store(normals[1], normal[1]);
+            simd::store(normals[2], normal[2]);
+            simd::store(angles[0], simd::atan2(twiceArea, dot(e01, e02)));
+            simd::store(angles[1], simd::atan2(twiceArea, simd::neg(dot(e01, e12))));
+            simd::store(angles[2], simd::atan2(twiceArea, dot(e02, e12)));
+
+            for (size_t lane = 0; lane < 4; lane++) {
+                add(triangle + lane, Vec3(normals[0][lane], normals[1][lane], normals[2][lane]), { angles[0][lane], angles[1][lane], angles[2][lane] });
+            }
+        }
+#endif
+        for (; triangle < end; triangle++) {
+            const WeightedTriangle weighted = weighTriangle(
+                mesh.vertices[mesh.indices[3 * triangle + 0]],
+                mesh.vertices[mesh.indices[3 * triangle + 1]],
+                mesh.vertices[mesh.indices[3 * triangle + 2]]);
+            add(triangle, weighted.normal, weighted.angles);
+        }
+    }
+
+    // A vertex without triangles keeps a zero normal
+    Vec3Packed normalizeSum(const Vec3& sum) {
+        const float length = sum.magnitude();
+        return length > 0.0f ? Vec3Packed(sum / length) : Vec3Packed(0.0f, 0.0f, 0.0f);
+    }
+}
+
 void Mesh::recalculateNormals()
 {
-    normals.clear();
+    const size_t vertexCount = vertices.size();
+    const size_t triangleCount = indices.size() / 3;
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    const size_t threads = std::clamp<size_t>(triangleCount / minTrianglesPerThread, 1, cores);
+
+    // Each thread clears its own part, clearing all of it up front would touch the memory on one core
+    const size_t stride = 3 * vertexCount;
+    if (_normalSums.size() < threads * stride) {
+        _normalSums.resize(threads * stride);
+    }
+    parallelFor(threads, static_cast<unsigned>(threads), [&](size_t firstThread, size_t lastThread) {
+        for (size_t thread = firstThread; thread < lastThread; thread++) {
+            float* sums = _normalSums.data() + thread * stride;
+            std::fill(sums, sums + stride, 0.0f);
+            accumulateNormals(*this, triangleCount * thread / threads, triangleCount * (thread + 1) / threads, sums);
+        }
+    });
+
+    normals.resize(vertexCount);
+    parallelFor(vertexCount, static_cast<unsigned>(threads), [&](size_t begin, size_t end) {
+        for (size_t vertex = begin; vertex < end; vertex++) {
+            Vec3 sum(0.0f, 0.0f, 0.0f);
+            for (size_t thread = 0; thread < threads; thread++) {
+                const float* sums = _normalSums.data() + thread * stride + 3 * vertex;
+                sum += Vec3(sums[0], sums[1], sums[2]);
+            }
+            normals[vertex] = normalizeSum(sum);
+        }
+    });
+}
+
+void Mesh::recalculateNormals(std::span<const uint32_t> dirtyVertices)
+{
+    if (_triangleOffsets.size() != vertices.size() + 1) {
+        rebuildAdjacency();
+    }
+    if (normals.size() != vertices.size()) {
+        recalculateNormals();
+        return;
+    }
+
+    // Stamps instead of a cleared flag per vertex keep the update proportional to the dirty region
+    if (++_visitStamp == 0) {
+        std::fill(_visited.begin(), _visited.end(), 0);
+        _visitStamp = 1;
+    }
+    std::vector<uint32_t>& affected = _affected;
+    affected.clear();
+    for (const uint32_t dirty : dirtyVertices) {
+        for (uint32_t i = _triangleOffsets[dirty]; i < _triangleOffsets[dirty + 1]; i++) {
+            for (size_t corner = 0; corner < 3; corner++) {
+                const uint32_t vertex = indices[3 * static_cast<size_t>(_vertexTriangles[i]) + corner];
+                if (_visited[vertex] != _visitStamp) {
+                    _visited[vertex] = _visitStamp;
+                    affected.push_back(vertex);
+                }
+            }
+        }
+    }
+
+    // Each affected vertex gathers from its own triangles, so vertices can be split across threads without sharing sums
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    const size_t threads = std::clamp<size_t>(affected.size() / minTrianglesPerThread, 1, cores);
+    parallelFor(affected.size(), static_cast<unsigned>(threads), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const uint32_t vertex = affected[i];
+            Vec3 sum(0.0f, 0.0f, 0.0f);
+            for (uint32_t j = _triangleOffsets[vertex]; j < _triangleOffsets[vertex + 1]; j++) {
+                const size_t triangle = _vertexTriangles[j];
+                const WeightedTriangle weighted = weighTriangle(vertices[indices[3 * triangle + 0]], vertices[indices[3 * triangle + 1]], vertices[indices[3 * triangle + 2]]);
+                for (size_t corner = 0; corner < 3; corner++) {
+                    if (indices[3 * triangle + corner] == vertex) {
+                        sum += weighted.normal * weighted.angles[corner];
+                    }
+                }
+            }
+            normals[vertex] = normalizeSum(sum);
+        }
+    });
+}
+
+void Mesh::rebuildAdjacency()
+{
+    const size_t triangleCount = indices.size() / 3;
+    // A degenerate triangle can use a vertex twice, it is still listed once and the gather adds both corners
+    const auto isFirstUse = [&](size_t i) {
+        const size_t first = i - i % 3;
+        return std::find(indices.begin() + first, indices.begin() + i, indices[i]) == indices.begin() + i;
+    };
+
+    _triangleOffsets.assign(vertices.size() + 1, 0);
+    for (size_t i = 0; i < 3 * triangleCount; i++) {
+        _triangleOffsets[indices[i] + 1] += isFirstUse(i);
+    }
+    for (size_t vertex = 0; vertex < vertices.size(); vertex++) {
+        _triangleOffsets[vertex + 1] += _triangleOffsets[vertex];
+    }
+
+    _vertexTriangles.resize(_triangleOffsets.back());
+    std::vector<uint32_t> next(_triangleOffsets.begin(), _triangleOffsets.end() - 1);
+    for (size_t i = 0; i < 3 * triangleCount; i++) {
+        if (isFirstUse(i)) {
+            _vertexTriangles[next[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    _visited.assign(vertices.size(), 0);
+    _visitStamp = 0;
+}
 
-    for (size_t i = 0; i < indices.size(); i += 3)
-    {
-        Vec3 v1 = vertices[indices[i + 0]];
-        Vec3 v2 = vertices[indices[i + 1]];
-        Vec3 v3 = vertices[indices[i + 2]];
+void Mesh::recalculateTangents()
+{
+    TangentSpace tangentSpace = generateTangents(vertices, normals, texCoords, indices);
+    const auto appendCopies = [&](auto& attribute) {
+        if (attribute.size() != vertices.size()) {
+            return;
+        }
+        attribute.reserve(attribute.size() + tangentSpace.splitVertices.size());
+        for (const uint32_t vertex : tangentSpace.splitVertices) {
+            attribute.push_back(attribute[vertex]);
+        }
+    };
+    appendCopies(normals);
+    appendCopies(texCoords);
+    appendCopies(vertColors);
+    appendCopies(vertices);
+    tangents = std::move(tangentSpace.tangents);
 
-        Vec3 v12 = v2 - v1;
-        Vec3 v13 = v3 - v1;
+    if (!tangentSpace.splitVertices.empty()) {
+        _triangleOffsets.clear();
     }
 }
+
+MeshOptimizationReport Mesh::optimize()
+{
+    MeshOptimizationReport report;
+    report.before = analyzeVertexCache(indices, vertices.size());
+    const std::vector<uint32_t> clusters = optimizeVertexCache(indices, vertices.size());
+    optimizeOverdraw(indices, vertices, clusters);
+
+    const VertexRemap remap = optimizeVertexFetch(indices, vertices.size());
+    const auto applyTo = [&](auto& attribute) {
+        if (attribute.size() == vertices.size()) {
+            remap.apply(attribute);
+        }
+    };
+    applyTo(normals);
+    applyTo(texCoords);
+    applyTo(vertColors);
+    applyTo(tangents);
+    applyTo(vertices);
+    _triangleOffsets.clear();
+    report.after = analyzeVertexCache(indices, vertices.size());
+    return report;
+}
+
+std::vector<LodLevel> Mesh::buildLods(std::span<const float> ratios, const SimplifyOptions& options) const
+{
+    return buildLodChain(indices, vertices, texCoords, normals, ratios, options);
+}
+
+Meshlets Mesh::buildMeshlets()
+{
+    Meshlets meshlets = nwt::buildMeshlets(indices, vertices);
+    _triangleOffsets.clear();
+    return meshlets;
+}
 }
\ No newline at end of file
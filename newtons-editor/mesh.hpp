@@ -2,26 +2,64 @@
 
 #include "vec3.hpp"
 #include "vec2.hpp"
+#include "mesh_optimize.hpp"
+#include "meshlets.hpp"
+#include "simplify.hpp"
 #include <vector>
 #include <cstdint>
+#include <span>
 
 namespace nwt{
 struct Mesh{
-    std::vector<Vec3> vertices;
+    std::vector<Vec3Packed> vertices;
     std::vector<uint32_t> indices;
-    std::vector<Vec3> normals;
+    std::vector<Vec3Packed> normals;
     std::vector<Vec2> texCoords;
-    std::vector<Vec3> vertColors;
+    std::vector<Vec3Packed> vertColors;
+    // Packed with packSnorm1010102, w is the bitangent sign
+    std::vector<uint32_t> tangents;
 
-    Mesh(const std::vector<Vec3>& vertices, const std::vector<uint32_t>& indices, const std::vector<Vec2>& texCoords, const std::vector<Vec3>& vertColors)
+    Mesh(const std::vector<Vec3Packed>& vertices, const std::vector<uint32_t>& indices, const std::vector<Vec2>& texCoords, const std::vector<Vec3Packed>& vertColors)
         : vertices(vertices), indices(indices), texCoords(texCoords), vertColors(vertColors){}
 
-    Mesh(const std::vector<Vec3>& vertices, const std::vector<uint32_t>& indices, const std::vector<Vec2>& texCoords)
+    Mesh(const std::vector<Vec3Packed>& vertices, const std::vector<uint32_t>& indices, const std::vector<Vec2>& texCoords)
         : vertices(vertices), indices(indices), texCoords(texCoords){}
     
-    Mesh(const std::vector<Vec3>& vertices, const std::vector<uint32_t>& indices)
+    Mesh(const std::vector<Vec3Packed>& vertices, const std::vector<uint32_t>& indices)
         : vertices(vertices), indices(indices){}
 
+    // Area and angle weighted vertex normals: every corner adds its triangle's normal scaled by the triangle area and the
+    // corner angle. The triangles are split across all cores, each thread sums into its own array and the arrays are added
+    // per vertex range after.
     void recalculateNormals();
+    // Recomputes only the normals that moving dirtyVertices changes, those of every vertex sharing a triangle with one
+    // of them. The other normals must already be up to date.
+    void recalculateNormals(std::span<const uint32_t> dirtyVertices);
+    // The incremental recalculateNormals builds the vertex to triangle adjacency once, call this after changing indices
+    void rebuildAdjacency();
+    // MikkTSpace tangents from normals and texCoords, see generateTangents. Vertices where mirrored texture coordinates
+    // meet are split, which appends copies to every per vertex array and rewrites indices.
+    void recalculateTangents();
+    // Reorders indices for the vertex cache and overdraw and the vertices by first use, see mesh_optimize.hpp.
+    // Every per vertex array follows the new vertex order, unreferenced vertices are dropped.
+    MeshOptimizationReport optimize();
+    // Simplified index lists for every ratio of the triangle count, see buildLodChain. texCoords and normals weigh in
+    // when they have an entry per vertex, the levels index the same vertices.
+    std::vector<LodLevel> buildLods(std::span<const float> ratios, const SimplifyOptions& options = {}) const;
+    // Splits the triangles into meshlets for culling, see buildMeshlets. The triangles are reordered so every meshlet is
+    // an index range, the vertices stay where they are.
+    Meshlets buildMeshlets();
+
+private:
+    // Triangles around vertex v are _vertexTriangles[_triangleOffsets[v]] up to _vertexTriangles[_triangleOffsets[v + 1]]
+    std::vector<uint32_t> _triangleOffsets;
+    std::vector<uint32_t> _vertexTriangles;
+    // Marks vertices already queued by the incremental update, a vertex is marked when its entry equals _visitStamp
+    std::vector<uint32_t> _visited;
+    uint32_t _visitStamp = 0;
+    // Scratch kept between calls so repeated updates do not allocate: the per thread sums of the full recalculation,
+    // 3 floats per vertex for each thread, and the vertices the incremental one gathers
+    std::vector<float> _normalSums;
+    std::vector<uint32_t> _affected;
 };
 }
\ No newline at end of file
@@ -0,0 +1,572 @@
+#include "mesh_cache.hpp"
+#include "hash.hpp"
+#include "mesh.hpp"
+#include "obj_reader.hpp"
+#include "parallel.hpp"
+#include "tangents.hpp"
+#include "weld.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+
+namespace nwt{
+namespace {
+    constexpr uint64_t arrayAlignment = 16;
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    MeshCacheHeader makeHeader(const MeshData& mesh, const AssetSource& source, const MeshImportOptions& options) {
+        const std::span<const Vertex> vertices = mesh.vertices;
+        const std::span<const uint32_t> indices = mesh.indices;
+        const std::span<const TangentFrame> tangentFrames = mesh.tangentFrames;
+        const std::span<const MeshLod> lods = mesh.lods;
+        const std::span<const Meshlet> meshlets = mesh.meshlets;
+        const std::span<const uint32_t> meshletVertices = mesh.meshletVertices;
+        const std::span<const uint8_t> meshletTriangles = mesh.meshletTriangles;
+        MeshCacheHeader header{};
+        std::memcpy(header.magic, MeshCacheHeader::expectedMagic, sizeof(header.magic));
+        header.version = MeshCacheHeader::currentVersion;
+        header.vertexStride = sizeof(Vertex);
+        header.vertexCount = static_cast<uint32_t>(vertices.size());
+        header.indexCount = static_cast<uint32_t>(indices.size());
+        header.subMeshCount = static_cast<uint32_t>(mesh.subMeshes.size());
+        header.tangentFrameCount = static_cast<uint32_t>(tangentFrames.size());
+        header.lodCount = static_cast<uint32_t>(lods.size());
+        header.meshletCount = static_cast<uint32_t>(meshlets.size());
+        header.meshletVertexCount = static_cast<uint32_t>(meshletVertices.size());
+        header.meshletTriangleCount = static_cast<uint32_t>(meshletTriangles.size() / 3);
+        header.tangents = options.tangents ? 1 : 0;
+        header.vertexOffset = alignUp(sizeof(MeshCacheHeader), arrayAlignment);
+        header.indexOffset = alignUp(header.vertexOffset + vertices.size_bytes(), arrayAlignment);
+        header.tangentFrameOffset = alignUp(header.indexOffset + indices.size_bytes(), arrayAlignment);
+        header.lodOffset = alignUp(header.tangentFrameOffset + tangentFrames.size_bytes(), arrayAlignment);
+        header.meshletOffset = alignUp(header.lodOffset + lods.size_bytes(), arrayAlignment);
+        header.meshletVertexOffset = alignUp(header.meshletOffset + meshlets.size_bytes(), arrayAlignment);
+        header.meshletTriangleOffset = alignUp(header.meshletVertexOffset + meshletVertices.size_bytes(), arrayAlignment);
+        header.subMeshOffset = alignUp(header.meshletTriangleOffset + meshletTriangles.size_bytes(), arrayAlignment);
+        header.lodRatiosHash = hashLodRatios(options.lodRatios);
+        header.source = source;
+
+        header.boundsMin = vertices.empty() ? Vec3Packed(0, 0, 0) : vertices[0].pos;
+        header.boundsMax = header.boundsMin;
+        for (const Vertex& vertex : vertices) {
+            header.boundsMin = Vec3Packed(std::min(header.boundsMin.x, vertex.pos.x), std::min(header.boundsMin.y, vertex.pos.y), std::min(header.boundsMin.z, vertex.pos.z));
+            header.boundsMax = Vec3Packed(std::max(header.boundsMax.x, vertex.pos.x), std::max(header.boundsMax.y, vertex.pos.y), std::max(header.boundsMax.z, vertex.pos.z));
+        }
+        return header;
+    }
+
+    bool isImportedWith(const MeshCacheHeader& header, const MeshImportOptions& options) {
+        return header.tangents == (options.tangents ? 1u : 0u) && header.lodRatiosHash == hashLodRatios(options.lodRatios);
+    }
+
+    bool isValid(const MeshCacheHeader& header, size_t fileSize) {
+        return std::memcmp(header.magic, MeshCacheHeader::expectedMagic, sizeof(header.magic)) == 0
+            && header.version == MeshCacheHeader::currentVersion
+            && header.vertexStride == sizeof(Vertex)
+            && header.vertexOffset % alignof(Vertex) == 0
+            && header.indexOffset % alignof(uint32_t) == 0
+            && header.vertexOffset <= fileSize && (fileSize - header.vertexOffset) / sizeof(Vertex) >= header.vertexCount
+            && header.indexOffset <= fileSize && (fileSize - header.indexOffset) / sizeof(uint32_t) >= header.indexCount
+            && (header.tangentFrameCount == 0 || header.tangentFrameCount == header.vertexCount)
+            && header.tangentFrameOffset % alignof(TangentFrame) == 0
+            && header.tangentFrameOffset <= fileSize && (fileSize - header.tangentFrameOffset) / sizeof(TangentFrame) >= header.tangentFrameCount
+            && header.lodOffset % alignof(MeshLod) == 0
+            && header.lodOffset <= fileSize && (fileSize - header.lodOffset) / sizeof(MeshLod) >= header.lodCount
+            && header.meshletOffset % alignof(Meshlet) == 0
+            && header.meshletOffset <= fileSize && (fileSize - header.meshletOffset) / sizeof(Meshlet) >= header.meshletCount
+            && header.meshletVertexOffset % alignof(uint32_t) == 0
+            && header.meshletVertexOffset <= fileSize && (fileSize - header.meshletVertexOffset) / sizeof(uint32_t) >= header.meshletVertexCount
+            && header.meshletTriangleOffset <= fileSize && (fileSize - header.meshletTriangleOffset) / 3 >= header.meshletTriangleCount
+            && header.subMeshOffset % alignof(MeshCacheSubMesh) == 0
+            && header.subMeshOffset <= fileSize && (fileSize - header.subMeshOffset) / sizeof(MeshCacheSubMesh) >= header.subMeshCount;
+    }
+
+    // Reads the submesh table behind the arrays, returns false if an entry or a name is out of bounds
+    bool readSubMeshes(const MappedFile& file, const MeshCacheHeader& header, std::vector<SubMesh>& subMeshes) {
+        const char* entry = file.data() + header.subMeshOffset;
+        const char* name = entry + header.subMeshCount * sizeof(MeshCacheSubMesh);
+        const char* end = file.data() + file.size();
+        subMeshes.reserve(header.subMeshCount);
+        for (uint32_t i = 0; i < header.subMeshCount; i++, entry += sizeof(MeshCacheSubMesh)) {
+            MeshCacheSubMesh subMesh;
+            std::memcpy(&subMesh, entry, sizeof(subMesh));
+            if (subMesh.materialLength > static_cast<size_t>(end - name) || subMesh.firstIndex > header.indexCount || subMesh.indexCount > header.indexCount - subMesh.firstIndex
+                || subMesh.firstMeshlet > header.meshletCount || subMesh.meshletCount > header.meshletCount - subMesh.firstMeshlet) {
+                return false;
+            }
+            subMeshes.push_back({ std::string(name, subMesh.materialLength), subMesh.firstIndex, subMesh.indexCount, subMesh.firstMeshlet, subMesh.meshletCount });
+            name += subMesh.materialLength;
+        }
+        return true;
+    }
+
+    // Reads the LOD table, returns false if a level's submeshes are out of bounds
+    bool readLods(const MappedFile& file, const MeshCacheHeader& header, std::vector<MeshLod>& lods) {
+        lods.resize(header.lodCount);
+        std::memcpy(lods.data(), file.data() + header.lodOffset, lods.size() * sizeof(MeshLod));
+        return std::all_of(lods.begin(), lods.end(), [&](const MeshLod& lod) {
+            return lod.firstSubMesh <= header.subMeshCount && lod.subMeshCount <= header.subMeshCount - lod.firstSubMesh;
+        });
+    }
+
+    // Meshlets are drawn straight from the index buffer, so unlike the indices themselves their ranges are checked
+    bool meshletsInBounds(const MappedFile& file, const MeshCacheHeader& header) {
+        const char* entry = file.data() + header.meshletOffset;
+        for (uint32_t i = 0; i < header.meshletCount; i++, entry += sizeof(Meshlet)) {
+            Meshlet meshlet;
+            std::memcpy(&meshlet, entry, sizeof(meshlet));
+            if (meshlet.firstIndex > header.indexCount || meshlet.triangleCount > (header.indexCount - meshlet.firstIndex) / 3
+                || meshlet.vertexOffset > header.meshletVertexCount || meshlet.vertexCount > header.meshletVertexCount - meshlet.vertexOffset
+                || meshlet.triangleOffset > header.meshletTriangleCount || meshlet.triangleCount > header.meshletTriangleCount - meshlet.triangleOffset) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // A mesh without levels of detail draws all its submeshes as its only level
+    std::vector<MeshLod> lodsOrFullMesh(std::vector<MeshLod> lods, size_t subMeshCount) {
+        if (lods.empty()) {
+            lods.push_back({ 0, static_cast<uint32_t>(subMeshCount), 0.0f });
+        }
+        return lods;
+    }
+}
+
+MeshData importObj(const std::filesystem::path& path, unsigned threadCount) {
+    obj::Object objModel;
+    obj::ReadObjFile(path, objModel, threadCount);
+
+    MeshData mesh;
+    // Groups of one material are adjacent, so each material becomes a single range
+    for (const obj::Group& group : objModel.groups) {
+        if (!mesh.subMeshes.empty() && mesh.subMeshes.back().material == group.material) {
+            mesh.subMeshes.back().indexCount += static_cast<uint32_t>(group.index_count);
+        }
+        else {
+            mesh.subMeshes.push_back({ group.material, static_cast<uint32_t>(group.first_index), static_cast<uint32_t>(group.index_count) });
+        }
+    }
+
+    std::vector<Vertex> corners(objModel.indices.size());
+    // Corners without a normal get a zero one, which generateTangentFrames replaces
+    std::vector<Vec3Packed> cornerNormals(objModel.normals.empty() ? 0 : corners.size());
+    parallelFor(corners.size(), threadCount, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const obj::Index& index = objModel.indices[i];
+            Vertex& vertex = corners[i];
+
+            vertex.pos = {
+                objModel.vertices[3 * index.vertex_index + 0],
+                objModel.vertices[3 * index.vertex_index + 1],
+                objModel.vertices[3 * index.vertex_index + 2],
+            };
+
+            vertex.texCoord = { 0.0f, 0.0f };
+            if (index.tex_coord_index != obj::Index::none) {
+                vertex.texCoord = {
+                    objModel.tex_coords[2 * index.tex_coord_index + 0],
+                    1.0f - objModel.tex_coords[2 * index.tex_coord_index + 1]
+                };
+            }
+
+            vertex.color = { 1.0f, 1.0f, 1.0f };
+
+            if (!cornerNormals.empty() && index.normal_index != obj::Index::none) {
+                cornerNormals[i] = {
+                    objModel.normals[3 * index.normal_index + 0],
+                    objModel.normals[3 * index.normal_index + 1],
+                    objModel.normals[3 * index.normal_index + 2],
+                };
+            }
+        }
+    });
+
+    WeldOptions weldOptions;
+    weldOptions.threadCount = threadCount;
+    if (cornerNormals.empty()) {
+        weldVertices(corners, weldOptions, mesh.vertices, mesh.indices);
+    }
+    else {
+        weldVertices(corners, cornerNormals, weldOptions, mesh.vertices, mesh.normals, mesh.indices);
+    }
+    return mesh;
+}
+
+MeshOptimizationReport optimizeMesh(MeshData& mesh, unsigned threadCount) {
+    const size_t vertexCount = mesh.vertices.size();
+    MeshOptimizationReport report;
+    report.before = analyzeVertexCache(mesh.indices, vertexCount);
+
+    std::vector<Vec3Packed> positions(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++) {
+        positions[i] = mesh.vertices[i].pos;
+    }
+    // Triangles only move within their submesh, so each one is reordered on its own. Levels of detail can share the
+    // range of a submesh, which is reordered once.
+    std::vector<SubMesh> ranges = mesh.subMeshes;
+    std::sort(ranges.begin(), ranges.end(), [](const SubMesh& a, const SubMesh& b) { return a.firstIndex < b.firstIndex; });
+    ranges.erase(std::unique(ranges.begin(), ranges.end(), [](const SubMesh& a, const SubMesh& b) { return a.firstIndex == b.firstIndex; }), ranges.end());
+    const std::span<uint32_t> indices = mesh.indices;
+    parallelFor(ranges.size(), threadCount, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            // Both passes keep state per vertex. A range with fewer indices than the buffer has vertices runs on the
+            // vertices it uses, so a small submesh or level of a large mesh doesn't pay for the whole buffer. For
+            // larger ranges the buffer costs no more than the range itself and compacting would only add a sort.
+            const std::span<uint32_t> range = indices.subspan(ranges[i].firstIndex, ranges[i].indexCount);
+            if (range.size() >= vertexCount) {
+                const std::vector<uint32_t> clusters = optimizeVertexCache(range, vertexCount);
+                optimizeOverdraw(range, positions, clusters);
+                continue;
+            }
+            LocalVertices local = compactVertices(range);
+            const std::vector<Vec3Packed> localPositions = local.gather<Vec3Packed>(positions);
+            const std::vector<uint32_t> clusters = optimizeVertexCache(local.indices, local.vertices.size());
+            optimizeOverdraw(local.indices, localPositions, clusters);
+            for (size_t j = 0; j < range.size(); j++) {
+                range[j] = local.vertices[local.indices[j]];
+            }
+        }
+    });
+
+    const VertexRemap remap = optimizeVertexFetch(mesh.indices, vertexCount);
+    remap.apply(mesh.vertices);
+    if (!mesh.tangentFrames.empty()) {
+        remap.apply(mesh.tangentFrames);
+    }
+    if (!mesh.normals.empty()) {
+        remap.apply(mesh.normals);
+    }
+    report.after = analyzeVertexCache(mesh.indices, mesh.vertices.size());
+    return report;
+}
+
+void generateMeshlets(MeshData& mesh, unsigned threadCount) {
+    std::vector<Vec3Packed> positions(mesh.vertices.size());
+    for (size_t i = 0; i < mesh.vertices.size(); i++) {
+        positions[i] = mesh.vertices[i].pos;
+    }
+    // Every distinct range is split once, like in optimizeMesh
+    std::vector<SubMesh> ranges = mesh.subMeshes;
+    std::sort(ranges.begin(), ranges.end(), [](const SubMesh& a, const SubMesh& b) { return a.firstIndex < b.firstIndex; });
+    ranges.erase(std::unique(ranges.begin(), ranges.end(), [](const SubMesh& a, const SubMesh& b) { return a.firstIndex == b.firstIndex; }), ranges.end());
+    const std::span<uint32_t> indices = mesh.indices;
+    std::vector<Meshlets> rangeMeshlets(ranges.size());
+    parallelFor(ranges.size(), threadCount, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            rangeMeshlets[i] = buildMeshlets(indices.subspan(ranges[i].firstIndex, ranges[i].indexCount), positions);
+        }
+    });
+
+    mesh.meshlets.clear();
+    mesh.meshletVertices.clear();
+    mesh.meshletTriangles.clear();
+    for (size_t i = 0; i < ranges.size(); i++) {
+        ranges[i].firstMeshlet = static_cast<uint32_t>(mesh.meshlets.size());
+        ranges[i].meshletCount = static_cast<uint32_t>(rangeMeshlets[i].meshlets.size());
+        for (Meshlet meshlet : rangeMeshlets[i].meshlets) {
+            meshlet.firstIndex += ranges[i].firstIndex;
+            meshlet.vertexOffset += static_cast<uint32_t>(mesh.meshletVertices.size());
+            meshlet.triangleOffset += static_cast<uint32_t>(mesh.meshletTriangles.size() / 3);
+            mesh.meshlets.push_back(meshlet);
+        }
+        mesh.meshletVertices.insert(mesh.meshletVertices.end(), rangeMeshlets[i].vertices.begin(), rangeMeshlets[i].vertices.end());
+        mesh.meshletTriangles.insert(mesh.meshletTriangles.end(), rangeMeshlets[i].triangles.begin(), rangeMeshlets[i].triangles.end());
+    }
+    for (SubMesh& subMesh : mesh.subMeshes) {
+        const auto range = std::lower_bound(ranges.begin(), ranges.end(), subMesh.firstIndex, [](const SubMesh& range, uint32_t firstIndex) { return range.firstIndex < firstIndex; });
+        subMesh.firstMeshlet = range->firstMeshlet;
+        subMesh.meshletCount = range->meshletCount;
+    }
+
+    const VertexRemap remap = optimizeVertexFetch(mesh.indices, mesh.vertices.size());
+    remap.apply(mesh.vertices);
+    if (!mesh.tangentFrames.empty()) {
+        remap.apply(mesh.tangentFrames);
+    }
+    if (!mesh.normals.empty()) {
+        remap.apply(mesh.normals);
+    }
+    for (uint32_t& vertex : mesh.meshletVertices) {
+        vertex = remap.newIndices[vertex];
+    }
+}
+
+void generateLods(MeshData& mesh, std::span<const float> ratios, const SimplifyOptions& options, unsigned threadCount) {
+    const size_t vertexCount = mesh.vertices.size();
+    std::vector<Vec3Packed> positions(vertexCount);
+    std::vector<Vec2> texCoords(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++) {
+        positions[i] = mesh.vertices[i].pos;
+        texCoords[i] = mesh.vertices[i].texCoord;
+    }
+    // The obj's normals keep creases in place, without them simplify only looks at positions and texture coordinates
+    const std::span<const Vec3Packed> normals = mesh.normals.size() == vertexCount ? std::span<const Vec3Packed>(mesh.normals) : std::span<const Vec3Packed>();
+
+    // Levels are built from the full mesh, regenerating drops the old ones with their indices
+    const MeshLod full = lodsOrFullMesh(mesh.lods, mesh.subMeshes.size()).front();
+    std::vector<SubMesh> fullSubMeshes(mesh.subMeshes.begin() + full.firstSubMesh, mesh.subMeshes.begin() + full.firstSubMesh + full.subMeshCount);
+    if (!mesh.lods.empty()) {
+        size_t fullIndexCount = 0;
+        for (const SubMesh& subMesh : fullSubMeshes) {
+            fullIndexCount = std::max<size_t>(fullIndexCount, subMesh.firstIndex + subMesh.indexCount);
+        }
+        mesh.indices.resize(fullIndexCount);
+        mesh.subMeshes = fullSubMeshes;
+    }
+
+    // Marks the vertices of material boundaries, and keeps those the caller locked. The materials meet where their
+    // positions do, their vertices there usually differ in texture coordinate.
+    std::vector<uint32_t> byPosition(vertexCount);
+    std::iota(byPosition.begin(), byPosition.end(), 0u);
+    const auto positionKey = [&](uint32_t vertex) { return std::tie(positions[vertex].x, positions[vertex].y, positions[vertex].z); };
+    std::sort(byPosition.begin(), byPosition.end(), [&](uint32_t a, uint32_t b) { return positionKey(a) < positionKey(b); });
+    std::vector<uint32_t> pointOf(vertexCount);
+    for (size_t i = 0, point = 0; i < vertexCount; i++) {
+        point += i > 0 && positionKey(byPosition[i]) != positionKey(byPosition[i - 1]);
+        pointOf[byPosition[i]] = static_cast<uint32_t>(point);
+    }
+    std::vector<uint32_t> firstUser(vertexCount, ~0u);
+    std::vector<uint8_t> shared(vertexCount, 0);
+    for (uint32_t subMesh = 0; subMesh < fullSubMeshes.size(); subMesh++) {
+        for (uint32_t i = 0; i < fullSubMeshes[subMesh].indexCount; i++) {
+            const uint32_t point = pointOf[mesh.indices[fullSubMeshes[subMesh].firstIndex + i]];
+            if (firstUser[point] == ~0u) {
+                firstUser[point] = subMesh;
+            }
+            else if (firstUser[point] != subMesh) {
+                shared[point] = 1;
+            }
+        }
+    }
+    std::vector<uint8_t> locked(vertexCount, 0);
+    for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+        locked[vertex] = shared[pointOf[vertex]] || (vertex < options.lockedVertices.size() && options.lockedVertices[vertex]);
+    }
+    SimplifyOptions subMeshOptions = options;
+    subMeshOptions.lockedVertices = locked;
+
+    std::vector<std::vector<LodLevel>> chains(fullSubMeshes.size());
+    parallelFor(fullSubMeshes.size(), threadCount, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const std::span<const uint32_t> range = std::span<const uint32_t>(mesh.indices).subspan(fullSubMeshes[i].firstIndex, fullSubMeshes[i].indexCount);
+            chains[i] = buildLodChain(range, positions, texCoords, normals, ratios, subMeshOptions);
+        }
+    });
+
+    // A material whose chain stopped early keeps drawing the index range of its coarsest level in the levels after
+    mesh.lods = { { 0, static_cast<uint32_t>(fullSubMeshes.size()), 0.0f } };
+    std::vector<SubMesh> previous = fullSubMeshes;
+    std::vector<float> previousErrors(fullSubMeshes.size(), 0.0f);
+    for (size_t level = 0; level < ratios.size(); level++) {
+        MeshLod lod{ static_cast<uint32_t>(mesh.subMeshes.size()), 0, 0.0f };
+        bool simplified = false;
+        for (size_t i = 0; i < fullSubMeshes.size(); i++) {
+            if (level < chains[i].size()) {
+                simplified = true;
+                const LodLevel& chainLevel = chains[i][level];
+                previous[i].firstIndex = static_cast<uint32_t>(mesh.indices.size());
+                previous[i].indexCount = static_cast<uint32_t>(chainLevel.indices.size());
+                previousErrors[i] = chainLevel.error;
+                mesh.indices.insert(mesh.indices.end(), chainLevel.indices.begin(), chainLevel.indices.end());
+            }
+            lod.error = std::max(lod.error, previousErrors[i]);
+            if (previous[i].indexCount > 0) {
+                mesh.subMeshes.push_back(previous[i]);
+                lod.subMeshCount++;
+            }
+        }
+        if (!simplified) {
+            mesh.subMeshes.resize(lod.firstSubMesh);
+            break;
+        }
+        mesh.lods.push_back(lod);
+    }
+}
+
+void generateTangentFrames(MeshData& meshData, unsigned threadCount) {
+    const size_t vertexCount = meshData.vertices.size();
+    std::vector<Vec3Packed> positions(vertexCount);
+    std::vector<Vec2> texCoords(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++) {
+        positions[i] = meshData.vertices[i].pos;
+        texCoords[i] = meshData.vertices[i].texCoord;
+    }
+
+    std::vector<Vec3Packed> normals(vertexCount);
+    bool complete = meshData.normals.size() == vertexCount;
+    for (size_t i = 0; i < meshData.normals.size() && i < vertexCount; i++) {
+        const Vec3 normal = meshData.normals[i];
+        const float length = normal.magnitude();
+        if (length > 0.0f) {
+            normals[i] = normal / length;
+        }
+        else {
+            complete = false;
+        }
+    }
+    if (!complete) {
+        // Vertices differing only in texture coordinate or normal are one point of the surface, so the normals are
+        // computed on the mesh with those merged and every vertex gets the normal of its position
+        std::vector<uint32_t> order(vertexCount);
+        std::iota(order.begin(), order.end(), 0u);
+        const auto positionLess = [&](uint32_t a, uint32_t b) {
+            return std::tie(positions[a].x, positions[a].y, positions[a].z) < std::tie(positions[b].x, positions[b].y, positions[b].z);
+        };
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return positionLess(a, b) || (!positionLess(b, a) && a < b); });
+        std::vector<uint32_t> weldedVertex(vertexCount);
+        std::vector<Vec3Packed> weldedPositions;
+        for (size_t i = 0; i < vertexCount; i++) {
+            if (i == 0 || positions[order[i]] != positions[order[i - 1]]) {
+                weldedPositions.push_back(positions[order[i]]);
+            }
+            weldedVertex[order[i]] = static_cast<uint32_t>(weldedPositions.size() - 1);
+        }
+        std::vector<uint32_t> weldedIndices(meshData.indices.size());
+        for (size_t i = 0; i < meshData.indices.size(); i++) {
+            weldedIndices[i] = weldedVertex[meshData.indices[i]];
+        }
+        Mesh welded(weldedPositions, weldedIndices);
+        welded.recalculateNormals();
+        // The obj's normals win where they exist
+        for (size_t i = 0; i < vertexCount; i++) {
+            if (normals[i] == Vec3Packed()) {
+                normals[i] = welded.normals[weldedVertex[i]];
+            }
+        }
+    }
+    const TangentSpace tangentSpace = generateTangents(positions, normals, texCoords, meshData.indices, threadCount);
+
+    // The split copies keep the vertex they copy, only their tangent differs
+    for (const uint32_t vertex : tangentSpace.splitVertices) {
+        meshData.vertices.push_back(meshData.vertices[vertex]);
+        normals.push_back(normals[vertex]);
+    }
+    meshData.tangentFrames.resize(meshData.vertices.size());
+    for (size_t i = 0; i < meshData.vertices.size(); i++) {
+        meshData.tangentFrames[i] = { packSnorm1010102(normals[i], 0.0f), tangentSpace.tangents[i] };
+    }
+    meshData.normals = std::move(normals);
+}
+
+MeshCache::MeshCache(MappedFile file, const MeshCacheHeader& header, std::vector<SubMesh> subMeshes, std::vector<MeshLod> lods)
+    : _file(std::move(file)), _header(header), _subMeshes(std::move(subMeshes)), _lods(lodsOrFullMesh(std::move(lods), _subMeshes.size())) {
+    _vertices = { reinterpret_cast<const Vertex*>(_file.data() + _header.vertexOffset), _header.vertexCount };
+    _indices = { reinterpret_cast<const uint32_t*>(_file.data() + _header.indexOffset), _header.indexCount };
+    _tangentFrames = { reinterpret_cast<const TangentFrame*>(_file.data() + _header.tangentFrameOffset), _header.tangentFrameCount };
+    _meshlets = { reinterpret_cast<const Meshlet*>(_file.data() + _header.meshletOffset), _header.meshletCount };
+    _meshletVertices = { reinterpret_cast<const uint32_t*>(_file.data() + _header.meshletVertexOffset), _header.meshletVertexCount };
+    _meshletTriangles = { reinterpret_cast<const uint8_t*>(_file.data() + _header.meshletTriangleOffset), 3 * size_t(_header.meshletTriangleCount) };
+}
+
+MeshCache::MeshCache(MeshData data, const AssetSource& source, const MeshImportOptions& options)
+    : _data(std::move(data)), _header(makeHeader(_data, source, options)), _vertices(_data.vertices), _indices(_data.indices), _tangentFrames(_data.tangentFrames),
+      _meshlets(_data.meshlets), _meshletVertices(_data.meshletVertices), _meshletTriangles(_data.meshletTriangles), _subMeshes(_data.subMeshes),
+      _lods(lodsOrFullMesh(_data.lods, _data.subMeshes.size())) {}
+
+uint64_t hashLodRatios(std::span<const float> ratios) {
+    return Hash::HashBytes(ratios.data(), ratios.size_bytes(), ratios.size());
+}
+
+std::unique_ptr<MeshCache> MeshCache::open(const std::filesystem::path& path, const std::filesystem::path& sourcePath, const MeshImportOptions& options) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        return nullptr;
+    }
+
+    MappedFile file(path);
+    if (file.size() < sizeof(MeshCacheHeader)) {
+        return nullptr;
+    }
+    MeshCacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    std::vector<SubMesh> subMeshes;
+    std::vector<MeshLod> lods;
+    if (!isValid(header, file.size()) || !readSubMeshes(file, header, subMeshes) || !readLods(file, header, lods) || !meshletsInBounds(file, header) || !isImportedWith(header, options)
+        || header.source.isStale(sourcePath)) {
+        return nullptr;
+    }
+    return std::unique_ptr<MeshCache>(new MeshCache(std::move(file), header, std::move(subMeshes), std::move(lods)));
+}
+
+void MeshCache::write(const std::filesystem::path& path, const MeshData& mesh, const AssetSource& source, const MeshImportOptions& options) {
+    const MeshCacheHeader header = makeHeader(mesh, source, options);
+    const std::span<const Vertex> vertices = mesh.vertices;
+    const std::span<const uint32_t> indices = mesh.indices;
+    const std::span<const TangentFrame> tangentFrames = mesh.tangentFrames;
+    const std::span<const MeshLod> lods = mesh.lods;
+    const std::span<const Meshlet> meshlets = mesh.meshlets;
+    const std::span<const uint32_t> meshletVertices = mesh.meshletVertices;
+    const std::span<const uint8_t> meshletTriangles = mesh.meshletTriangles;
+    const char padding[arrayAlignment] = {};
+
+    // Written next to the target and renamed over it, so a reader never maps a half written cache
+    std::filesystem::path temporaryPath = path;
+    temporaryPath += ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to create mesh cache " + temporaryPath.string());
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(padding, header.vertexOffset - sizeof(header));
+        file.write(reinterpret_cast<const char*>(vertices.data()), vertices.size_bytes());
+        file.write(padding, header.indexOffset - header.vertexOffset - vertices.size_bytes());
+        file.write(reinterpret_cast<const char*>(indices.data()), indices.size_bytes());
+        file.write(padding, header.tangentFrameOffset - header.indexOffset - indices.size_bytes());
+        file.write(reinterpret_cast<const char*>(tangentFrames.data()), tangentFrames.size_bytes());
+        file.write(padding, header.lodOffset - header.tangentFrameOffset - tangentFrames.size_bytes());
+        file.write(reinterpret_cast<const char*>(lods.data()), lods.size_bytes());
+        file.write(padding, header.meshletOffset - header.lodOffset - lods.size_bytes());
+        file.write(reinterpret_cast<const char*>(meshlets.data()), meshlets.size_bytes());
+        file.write(padding, header.meshletVertexOffset - header.meshletOffset - meshlets.size_bytes());
+        file.write(reinterpret_cast<const char*>(meshletVertices.data()), meshletVertices.size_bytes());
+        file.write(padding, header.meshletTriangleOffset - header.meshletVertexOffset - meshletVertices.size_bytes());
+        file.write(reinterpret_cast<const char*>(meshletTriangles.data()), meshletTriangles.size_bytes());
+        file.write(padding, header.subMeshOffset - header.meshletTriangleOffset - meshletTriangles.size_bytes());
+        for (const SubMesh& subMesh : mesh.subMeshes) {
+            const MeshCacheSubMesh entry{ subMesh.firstIndex, subMesh.indexCount, subMesh.firstMeshlet, subMesh.meshletCount, static_cast<uint32_t>(subMesh.material.size()) };
+            file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        }
+        for (const SubMesh& subMesh : mesh.subMeshes) {
+            file.write(subMesh.material.data(), subMesh.material.size());
+        }
+        if (!file) {
+            throw std::runtime_error("Failed to write mesh cache " + temporaryPath.string());
+        }
+    }
+    std::filesystem::rename(temporaryPath, path);
+}
+
+std::unique_ptr<MeshCache> MeshCache::load(const std::filesystem::path& objPath, const std::filesystem::path& cachePath, const MeshImportOptions& options) {
+    if (std::unique_ptr<MeshCache> cache = open(cachePath, objPath, options)) {
+        return cache;
+    }
+
+    MeshData mesh = importObj(objPath);
+    if (options.tangents) {
+        generateTangentFrames(mesh);
+    }
+    generateLods(mesh, options.lodRatios);
+    optimizeMesh(mesh);
+    generateMeshlets(mesh);
+    const AssetSource source = AssetSource::fromFile(objPath);
+    try {
+        write(cachePath, mesh, source, options);
+        if (std::unique_ptr<MeshCache> cache = open(cachePath, objPath, options)) {
+            return cache;
+        }
+    }
+    catch (const std::exception&) {
+        // A read only model directory only costs the import on the next launch
+    }
+    return std::unique_ptr<MeshCache>(new MeshCache(std::move(mesh), source, options));
+}
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "asset_source.hpp"
+#include "mapped_file.hpp"
+#include "mesh_optimize.hpp"
+#include "meshlets.hpp"
+#include "simplify.hpp"
+#include "vertex.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace nwt{
+    // Index range drawn with one material
+    struct SubMesh{
+        std::string material;
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        // The meshlets that split the index range, none before generateMeshlets
+        uint32_t firstMeshlet = 0;
+        uint32_t meshletCount = 0;
+    };
+
+    // Level of detail, the submeshes firstSubMesh up to firstSubMesh + subMeshCount drawn in place of the full mesh.
+    // Stored as is in the .nmesh LOD table.
+    struct MeshLod{
+        uint32_t firstSubMesh;
+        uint32_t subMeshCount;
+        // Furthest the level deviates from the full mesh in mesh units, 0 for the full mesh
+        float error;
+    };
+
+    // Share of the full triangle count generateLods keeps in each level by default
+    constexpr float defaultLodRatios[] = { 0.5f, 0.25f, 0.1f };
+
+    // What a cache is imported with. The header records them, and a cache imported with other options is stale.
+    struct MeshImportOptions{
+        std::span<const float> lodRatios = defaultLodRatios;
+        // Run generateTangentFrames
+        bool tangents = false;
+    };
+
+    // Submesh table entry of a .nmesh file, the material names follow the table in entry order
+    struct MeshCacheSubMesh{
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        uint32_t firstMeshlet;
+        uint32_t meshletCount;
+        uint32_t materialLength;
+    };
+
+    // Normal and tangent of a vertex for normal mapping, both packed with packSnorm1010102.
+    // The tangent's w is the bitangent sign, the normal's w is unused.
+    struct TangentFrame{
+        uint32_t normal;
+        uint32_t tangent;
+    };
+
+    // Layout of a .nmesh file: this header followed by the vertex, index and tangent frame arrays, the LOD table, the
+    // meshlet table with its vertex and triangle arrays and the submesh table at the given offsets. The arrays are
+    // stored exactly as they are uploaded, so a mapped file can be copied straight into a staging buffer.
+    struct MeshCacheHeader{
+        static constexpr char expectedMagic[4] = { 'N', 'M', 'S', 'H' };
+        // Bump whenever the layout of the header or of Vertex changes, or the import orders the data differently
+        static constexpr uint32_t currentVersion = 8;
+
+        char magic[4];
+        uint32_t version;
+        uint32_t vertexStride;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t subMeshCount;
+        // vertexCount, or 0 for a mesh without tangent frames
+        uint32_t tangentFrameCount;
+        // 0 for a mesh with only the full level
+        uint32_t lodCount;
+        // All 0 for a mesh without meshlets
+        uint32_t meshletCount;
+        uint32_t meshletVertexCount;
+        uint32_t meshletTriangleCount;
+        // MeshImportOptions::tangents, 1 or 0
+        uint32_t tangents;
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+        uint64_t tangentFrameOffset;
+        uint64_t lodOffset;
+        uint64_t meshletOffset;
+        uint64_t meshletVertexOffset;
+        uint64_t meshletTriangleOffset;
+        uint64_t subMeshOffset;
+        // Hash of MeshImportOptions::lodRatios, see hashLodRatios
+        uint64_t lodRatiosHash;
+        AssetSource source;
+        Vec3Packed boundsMin;
+        Vec3Packed boundsMax;
+    };
+    static_assert(std::is_trivially_copyable_v<MeshCacheHeader> && std::is_trivially_copyable_v<MeshCacheSubMesh> && std::is_trivially_copyable_v<Vertex>
+        && std::is_trivially_copyable_v<TangentFrame> && std::is_trivially_copyable_v<MeshLod> && std::is_trivially_copyable_v<Meshlet>);
+
+    struct MeshData{
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        // Covers all indices, one entry per material and level of detail
+        std::vector<SubMesh> subMeshes;
+        // Empty, or the full mesh followed by the levels of generateLods
+        std::vector<MeshLod> lods;
+        // Empty, or one per vertex after generateTangentFrames
+        std::vector<TangentFrame> tangentFrames;
+        // The obj's normals, empty or one per vertex. Only used by generateTangentFrames, the cache stores them in the
+        // tangent frames.
+        std::vector<Vec3Packed> normals;
+        // Empty before generateMeshlets, see Meshlets
+        std::vector<Meshlet> meshlets;
+        std::vector<uint32_t> meshletVertices;
+        std::vector<uint8_t> meshletTriangles;
+    };
+
+    // Reads an obj file into deduplicated vertices and triangle indices, polygons are triangulated and the
+    // triangles are ordered by material. A file with normals fills normals, and corners only share a vertex if their
+    // normals are equal too. The file is parsed on threadCount threads (0 is one per core).
+    MeshData importObj(const std::filesystem::path& path, unsigned threadCount = 0);
+
+    // Fills tangentFrames with the mesh's normals and MikkTSpace tangents (see generateTangents), so normal mapped
+    // meshes get them from the cache instead of at load time. Vertices without a normal get the area and angle weighted
+    // normal of all triangles at their position, so texture seams stay smooth. Vertices where mirrored texture
+    // coordinates meet are split, which appends vertices and rewrites indices.
+    void generateTangentFrames(MeshData& mesh, unsigned threadCount = 0);
+
+    // Appends a simplified copy of the index ranges for every ratio, one submesh per material, see buildLodChain. The
+    // levels share the vertices of the full mesh. Positions used by more than one material stay where they are, so the
+    // submeshes still meet. The materials are simplified on threadCount threads (0 is one per core).
+    void generateLods(MeshData& mesh, std::span<const float> ratios = defaultLodRatios, const SimplifyOptions& options = {}, unsigned threadCount = 0);
+
+    // Reorders the triangles of every submesh for the vertex cache and overdraw, on threadCount threads (0 is one per
+    // core), then numbers the vertices by first use. Run it after anything that adds vertices, only generateMeshlets
+    // comes later.
+    MeshOptimizationReport optimizeMesh(MeshData& mesh, unsigned threadCount = 0);
+
+    // Splits every submesh into meshlets with buildMeshlets, the submeshes on threadCount threads (0 is one per core), and
+    // numbers the vertices by first use again so every meshlet's vertices are close together. Levels of detail sharing
+    // a range share its meshlets. Run it after optimizeMesh, whose triangle order the meshlets mostly keep.
+    void generateMeshlets(MeshData& mesh, unsigned threadCount = 0);
+
+    uint64_t hashLodRatios(std::span<const float> ratios);
+
+    class MeshCache{
+    public:
+        // Maps a cache file, returns nullptr if it is missing, invalid, stale compared to sourcePath or imported with
+        // other options
+        static std::unique_ptr<MeshCache> open(const std::filesystem::path& path, const std::filesystem::path& sourcePath, const MeshImportOptions& options = {});
+
+        // options are the ones mesh was imported with
+        static void write(const std::filesystem::path& path, const MeshData& mesh, const AssetSource& source, const MeshImportOptions& options);
+
+        // Opens the cache of an obj file, (re)importing the obj with options and writing the cache first when needed.
+        // If the cache can't be written the imported mesh is kept in memory instead.
+        static std::unique_ptr<MeshCache> load(const std::filesystem::path& objPath, const std::filesystem::path& cachePath, const MeshImportOptions& options = {});
+
+        std::span<const Vertex> vertices() const { return _vertices; }
+        std::span<const uint32_t> indices() const { return _indices; }
+        // Empty if the cache was written without tangent frames
+        std::span<const TangentFrame> tangentFrames() const { return _tangentFrames; }
+        const std::vector<SubMesh>& subMeshes() const { return _subMeshes; }
+        // At least one, the full mesh first and each level coarser than the one before
+        std::span<const MeshLod> lods() const { return _lods; }
+        std::span<const SubMesh> subMeshes(const MeshLod& lod) const { return std::span<const SubMesh>(_subMeshes).subspan(lod.firstSubMesh, lod.subMeshCount); }
+        // Empty if the cache was written without meshlets
+        std::span<const Meshlet> meshlets() const { return _meshlets; }
+        std::span<const Meshlet> meshlets(const SubMesh& subMesh) const { return _meshlets.subspan(subMesh.firstMeshlet, subMesh.meshletCount); }
+        std::span<const uint32_t> meshletVertices() const { return _meshletVertices; }
+        std::span<const uint8_t> meshletTriangles() const { return _meshletTriangles; }
+        const MeshCacheHeader& header() const { return _header; }
+
+    private:
+        MeshCache(MappedFile file, const MeshCacheHeader& header, std::vector<SubMesh> subMeshes, std::vector<MeshLod> lods);
+        MeshCache(MeshData data, const AssetSource& source, const MeshImportOptions& options);
+
+        MappedFile _file;
+        MeshData _data;
+        MeshCacheHeader _header;
+        std::span<const Vertex> _vertices;
+        std::span<const uint32_t> _indices;
+        std::span<const TangentFrame> _tangentFrames;
+        std::span<const Meshlet> _meshlets;
+        std::span<const uint32_t> _meshletVertices;
+        std::span<const uint8_t> _meshletTriangles;
+        std::vector<SubMesh> _subMeshes;
+        std::vector<MeshLod> _lods;
+    };
+}
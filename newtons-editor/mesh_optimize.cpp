@@ -0,0 +1,269 @@
+#include "mesh_optimize.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace nwt{
+namespace {
+    constexpr uint32_t noVertex = ~0u;
+
+    // A vertex is in a FIFO cache of cacheSize entries while fewer than cacheSize misses happened since it was inserted,
+    // so stamping every insertion with a miss counter simulates the cache exactly without storing its entries
+    struct FifoCache{
+        std::vector<uint32_t> insertTimes;
+        uint32_t time;
+        uint32_t size;
+
+        FifoCache(size_t vertexCount, uint32_t cacheSize)
+            : insertTimes(vertexCount, 0), time(cacheSize + 1), size(cacheSize) {}
+
+        bool contains(uint32_t vertex) const {
+            return time - insertTimes[vertex] <= size;
+        }
+
+        // Returns the number of misses, 0 or 1
+        uint32_t use(uint32_t vertex) {
+            if (contains(vertex)) {
+                return 0;
+            }
+            insertTimes[vertex] = time++;
+            return 1;
+        }
+
+        uint32_t useTriangle(const uint32_t* corners) {
+            return use(corners[0]) + use(corners[1]) + use(corners[2]);
+        }
+
+        void flush() {
+            time += size + 1;
+        }
+    };
+
+    // Starts of the clusters and of the soft clusters inside them, see optimizeOverdraw
+    std::vector<uint32_t> splitClusters(std::span<const uint32_t> indices, std::span<const uint32_t> clusters, size_t vertexCount, float threshold, uint32_t cacheSize) {
+        const size_t triangleCount = indices.size() / 3;
+        FifoCache cache(vertexCount, cacheSize);
+        std::vector<uint32_t> result;
+        for (size_t cluster = 0; cluster < clusters.size(); cluster++) {
+            const uint32_t begin = clusters[cluster];
+            const uint32_t end = cluster + 1 < clusters.size() ? clusters[cluster + 1] : static_cast<uint32_t>(triangleCount);
+
+            cache.flush();
+            uint32_t clusterMisses = 0;
+            for (uint32_t triangle = begin; triangle < end; triangle++) {
+                clusterMisses += cache.useTriangle(&indices[3 * triangle]);
+            }
+            const float targetRatio = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+            // Every cut flushes the cache, the cluster after a cut starts cold again
+            result.push_back(begin);
+            cache.flush();
+            uint32_t misses = 0;
+            uint32_t start = begin;
+            for (uint32_t triangle = begin; triangle + 1 < end; triangle++) {
+                misses += cache.useTriangle(&indices[3 * triangle]);
+                if (static_cast<float>(misses) <= targetRatio * static_cast<float>(triangle + 1 - start)) {
+                    start = triangle + 1;
+                    result.push_back(start);
+                    cache.flush();
+                    misses = 0;
+                }
+            }
+        }
+        return result;
+    }
+}
+
+VertexCacheStats analyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize) {
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount);
+    size_t misses = 0;
+    size_t used = 0;
+    for (const uint32_t vertex : indices) {
+        misses += cache.use(vertex);
+        if (!referenced[vertex]) {
+            referenced[vertex] = true;
+            used++;
+        }
+    }
+
+    VertexCacheStats stats;
+    if (indices.size() >= 3) {
+        stats.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+        stats.atvr = static_cast<float>(misses) / static_cast<float>(used);
+    }
+    return stats;
+}
+
+std::vector<uint32_t> optimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount, uint32_t cacheSize) {
+    const size_t triangleCount = indices.size() / 3;
+    std::vector<uint32_t> clusters{ 0 };
+    if (triangleCount == 0) {
+        return clusters;
+    }
+
+    // Triangles around vertex v are vertexTriangles[triangleOffsets[v]] up to vertexTriangles[triangleOffsets[v + 1]],
+    // liveTriangles counts the ones not emitted yet
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (size_t i = 0; i < 3 * triangleCount; i++) {
+        liveTriangles[indices[i]]++;
+    }
+    std::vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+    std::partial_sum(liveTriangles.begin(), liveTriangles.end(), triangleOffsets.begin() + 1);
+    std::vector<uint32_t> vertexTriangles(3 * triangleCount);
+    {
+        std::vector<uint32_t> next(triangleOffsets.begin(), triangleOffsets.end() - 1);
+        for (size_t i = 0; i < 3 * triangleCount; i++) {
+            vertexTriangles[next[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> emitted(triangleCount);
+    // Vertices of the emitted triangles, most recent last, where a dead end looks for a vertex that may still be cached
+    std::vector<uint32_t> deadEndStack;
+    size_t scanCursor = 0;
+    const auto skipDeadEnd = [&]() {
+        while (!deadEndStack.empty()) {
+            const uint32_t vertex = deadEndStack.back();
+            deadEndStack.pop_back();
+            if (liveTriangles[vertex] > 0) {
+                return vertex;
+            }
+        }
+        for (; scanCursor < vertexCount; scanCursor++) {
+            if (liveTriangles[scanCursor] > 0) {
+                return static_cast<uint32_t>(scanCursor);
+            }
+        }
+        return noVertex;
+    };
+
+    std::vector<uint32_t> output;
+    output.reserve(3 * triangleCount);
+    std::vector<uint32_t> candidates;
+    uint32_t fan = indices[0];
+    while (fan != noVertex) {
+        candidates.clear();
+        for (uint32_t i = triangleOffsets[fan]; i < triangleOffsets[fan + 1]; i++) {
+            const uint32_t triangle = vertexTriangles[i];
+            if (emitted[triangle]) {
+                continue;
+            }
+            emitted[triangle] = true;
+            for (size_t corner = 0; corner < 3; corner++) {
+                const uint32_t vertex = indices[3 * triangle + corner];
+                output.push_back(vertex);
+                deadEndStack.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+                cache.use(vertex);
+            }
+        }
+
+        // Fan next around the vertex that entered the cache longest ago but will still be in it after its remaining
+        // triangles add at most two vertices each, a vertex that would fall out only qualifies without priority
+        fan = noVertex;
+        int64_t bestPriority = -1;
+        for (const uint32_t vertex : candidates) {
+            if (liveTriangles[vertex] == 0) {
+                continue;
+            }
+            int64_t priority = 0;
+            const uint32_t age = cache.time - cache.insertTimes[vertex];
+            if (age + 2 * static_cast<int64_t>(liveTriangles[vertex]) <= cacheSize) {
+                priority = age;
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                fan = vertex;
+            }
+        }
+        if (fan == noVertex) {
+            fan = skipDeadEnd();
+            // A restart from a vertex still in cache continues the locality of the run before, only a cold one starts
+            // a cluster that can be moved without losing cache hits
+            if (fan != noVertex && !cache.contains(fan)) {
+                clusters.push_back(static_cast<uint32_t>(output.size() / 3));
+            }
+        }
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+    return clusters;
+}
+
+void optimizeOverdraw(std::span<uint32_t> indices, std::span<const Vec3Packed> positions, std::span<const uint32_t> clusters, float threshold, uint32_t cacheSize) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+    const std::vector<uint32_t> softClusters = splitClusters(indices, clusters, positions.size(), threshold, cacheSize);
+
+    Vec3 meshCenter(0.0f, 0.0f, 0.0f);
+    for (size_t i = 0; i < 3 * triangleCount; i++) {
+        meshCenter += positions[indices[i]];
+    }
+    meshCenter /= static_cast<float>(3 * triangleCount);
+
+    // Clusters whose area weighted center lies far out along their average normal face away from the rest of the mesh
+    // and can't be covered by it, drawing them first lets the depth test reject what they hide
+    std::vector<float> sortKeys(softClusters.size());
+    for (size_t cluster = 0; cluster < softClusters.size(); cluster++) {
+        const uint32_t begin = softClusters[cluster];
+        const uint32_t end = cluster + 1 < softClusters.size() ? softClusters[cluster + 1] : static_cast<uint32_t>(triangleCount);
+        Vec3 center(0.0f, 0.0f, 0.0f);
+        Vec3 normal(0.0f, 0.0f, 0.0f);
+        float area = 0.0f;
+        for (uint32_t triangle = begin; triangle < end; triangle++) {
+            const Vec3 p0 = positions[indices[3 * triangle + 0]];
+            const Vec3 p1 = positions[indices[3 * triangle + 1]];
+            const Vec3 p2 = positions[indices[3 * triangle + 2]];
+            const Vec3 areaNormal = Vec3::cross(p1 - p0, p2 - p0);
+            const float twiceArea = areaNormal.magnitude();
+            center += (p0 + p1 + p2) * (twiceArea / 3.0f);
+            normal += areaNormal;
+            area += twiceArea;
+        }
+        const float normalLength = normal.magnitude();
+        sortKeys[cluster] = area > 0.0f && normalLength > 0.0f ? Vec3::dot(center / area - meshCenter, normal / normalLength) : 0.0f;
+    }
+
+    std::vector<uint32_t> order(softClusters.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(3 * triangleCount);
+    for (const uint32_t cluster : order) {
+        const uint32_t begin = softClusters[cluster];
+        const uint32_t end = cluster + 1 < softClusters.size() ? softClusters[cluster + 1] : static_cast<uint32_t>(triangleCount);
+        output.insert(output.end(), indices.begin() + 3 * begin, indices.begin() + 3 * end);
+    }
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+LocalVertices compactVertices(std::span<const uint32_t> indices) {
+    LocalVertices local;
+    local.vertices.assign(indices.begin(), indices.end());
+    std::sort(local.vertices.begin(), local.vertices.end());
+    local.vertices.erase(std::unique(local.vertices.begin(), local.vertices.end()), local.vertices.end());
+    local.indices.resize(indices.size());
+    for (size_t i = 0; i < indices.size(); i++) {
+        local.indices[i] = static_cast<uint32_t>(std::lower_bound(local.vertices.begin(), local.vertices.end(), indices[i]) - local.vertices.begin());
+    }
+    return local;
+}
+
+VertexRemap optimizeVertexFetch(std::span<uint32_t> indices, size_t vertexCount) {
+    VertexRemap remap;
+    remap.newIndices.assign(vertexCount, VertexRemap::unused);
+    for (uint32_t& index : indices) {
+        if (remap.newIndices[index] == VertexRemap::unused) {
+            remap.newIndices[index] = static_cast<uint32_t>(remap.vertexCount++);
+        }
+        index = remap.newIndices[index];
+    }
+    return remap;
+}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "vec3.hpp"
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace nwt{
+    // Post-transform cache entries the optimizations and the statistics assume. Real GPUs differ, but orders tuned
+    // for a small FIFO hold up on larger and LRU-like caches too.
+    constexpr uint32_t defaultVertexCacheSize = 16;
+
+    struct VertexCacheStats{
+        // Average cache miss ratio, vertices shaded per triangle. 3 means no reuse at all, a large regular grid
+        // can get close to 0.5.
+        float acmr = 0.0f;
+        // Average transformed vertex ratio, vertices shaded per vertex referenced. 1 means every vertex is shaded once.
+        float atvr = 0.0f;
+    };
+
+    struct MeshOptimizationReport{
+        VertexCacheStats before;
+        VertexCacheStats after;
+    };
+
+    // Simulates a FIFO post-transform cache of cacheSize entries over a triangle list
+    VertexCacheStats analyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize = defaultVertexCacheSize);
+
+    // Reorders the triangles for the post-transform cache with Tipsify (Sander, Nehab and Barczak, "Fast Triangle
+    // Reordering for Vertex Locality and Reduced Overdraw"): it fans around the vertex whose triangles are most likely
+    // still in cache and falls back to a recently used vertex at dead ends. Returns the first triangle of every run
+    // that restarts with a cold cache, the clusters optimizeOverdraw may move around. The first entry is always 0.
+    std::vector<uint32_t> optimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount, uint32_t cacheSize = defaultVertexCacheSize);
+
+    // Splits the clusters of optimizeVertexCache further wherever the miss ratio so far, counted from a cold cache, is
+    // within threshold of the whole cluster's, then sorts them so clusters facing away from the mesh center come first
+    // and occlude the others. Higher thresholds give smaller clusters, so a better overdraw order for more misses.
+    void optimizeOverdraw(std::span<uint32_t> indices, std::span<const Vec3Packed> positions, std::span<const uint32_t> clusters,
+        float threshold = 1.05f, uint32_t cacheSize = defaultVertexCacheSize);
+
+    // New position of every vertex after optimizeVertexFetch
+    struct VertexRemap{
+        static constexpr uint32_t unused = ~0u;
+
+        // Indexed by old vertex, unused for vertices no triangle references, which are dropped
+        std::vector<uint32_t> newIndices;
+        size_t vertexCount = 0;
+
+        // Moves every used element of a per vertex array to its new index
+        template<typename T>
+        void apply(std::vector<T>& attribute) const {
+            std::vector<T> remapped(vertexCount);
+            for (size_t vertex = 0; vertex < newIndices.size(); vertex++) {
+                if (newIndices[vertex] != unused) {
+                    remapped[newIndices[vertex]] = std::move(attribute[vertex]);
+                }
+            }
+            attribute = std::move(remapped);
+        }
+    };
+
+    // The vertices an index range uses, numbered from 0 in order of their index in the full buffer. Per vertex scratch
+    // of the local vertices grows with the range, not with the buffer, which matters for a small submesh or level of
+    // detail of a large mesh.
+    struct LocalVertices{
+        // Vertex in the full buffer of every local vertex, ascending
+        std::vector<uint32_t> vertices;
+        // The range with every index rewritten to its local vertex
+        std::vector<uint32_t> indices;
+
+        // Copies the element of every local vertex out of a per vertex array of the full buffer
+        template<typename T>
+        std::vector<T> gather(std::span<const T> attribute) const {
+            std::vector<T> local(vertices.size());
+            for (size_t vertex = 0; vertex < vertices.size(); vertex++) {
+                local[vertex] = attribute[vertices[vertex]];
+            }
+            return local;
+        }
+    };
+
+    // Takes O(n log n) in the length of indices and nothing in the size of the buffer they index
+    LocalVertices compactVertices(std::span<const uint32_t> indices);
+
+    // Numbers the vertices in order of first use and rewrites indices, so the vertex fetches of consecutive
+    // triangles hit nearby memory. Apply the result to every per vertex array.
+    VertexRemap optimizeVertexFetch(std::span<uint32_t> indices, size_t vertexCount);
+}
@@ -0,0 +1,323 @@
+#include "meshlets.hpp"
+#include "mesh_optimize.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace nwt{
+namespace {
+    constexpr uint32_t noIndex = ~0u;
+    // How much turning away from the meshlet's average normal counts against a candidate triangle, in parts of its
+    // distance to the meshlet center
+    constexpr float coneWeight = 0.5f;
+    // Below this the normals spread beyond about 84 degrees around the axis and the cone never culls anything
+    constexpr float minConeCosine = 0.1f;
+
+    Vec3 normalizedOrZero(const Vec3& v) {
+        const float length = v.magnitude();
+        return length > 0.0f ? v / length : Vec3(0.0f, 0.0f, 0.0f);
+    }
+
+    // Vertices with the same position share one id, so meshlets grow across texture seams as if the mesh were welded
+    std::vector<uint32_t> positionIds(std::span<const Vec3Packed> positions) {
+        std::vector<uint32_t> order(positions.size());
+        std::iota(order.begin(), order.end(), 0);
+        const auto less = [&](uint32_t a, uint32_t b) {
+            const Vec3Packed& p = positions[a];
+            const Vec3Packed& q = positions[b];
+            return p.x != q.x ? p.x < q.x : p.y != q.y ? p.y < q.y : p.z < q.z;
+        };
+        std::sort(order.begin(), order.end(), less);
+
+        std::vector<uint32_t> ids(positions.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            ids[order[i]] = i > 0 && positions[order[i]] == positions[order[i - 1]] ? ids[order[i - 1]] : order[i];
+        }
+        return ids;
+    }
+
+    // Ritter's sphere: the two furthest apart of the extreme points along each axis span the first guess, which then
+    // grows to take in every point outside it
+    void computeSphere(Meshlet& meshlet, std::span<const uint32_t> vertices, std::span<const Vec3Packed> positions) {
+        uint32_t minVertex[3] = { vertices[0], vertices[0], vertices[0] };
+        uint32_t maxVertex[3] = { vertices[0], vertices[0], vertices[0] };
+        for (const uint32_t vertex : vertices) {
+            const Vec3Packed& p = positions[vertex];
+            const float coordinates[3] = { p.x, p.y, p.z };
+            for (size_t axis = 0; axis < 3; axis++) {
+                const Vec3Packed& min = positions[minVertex[axis]];
+                const Vec3Packed& max = positions[maxVertex[axis]];
+                const float minCoordinates[3] = { min.x, min.y, min.z };
+                const float maxCoordinates[3] = { max.x, max.y, max.z };
+                if (coordinates[axis] < minCoordinates[axis]) minVertex[axis] = vertex;
+                if (coordinates[axis] > maxCoordinates[axis]) maxVertex[axis] = vertex;
+            }
+        }
+
+        size_t widestAxis = 0;
+        float widest = -1.0f;
+        for (size_t axis = 0; axis < 3; axis++) {
+            const float span = (Vec3(positions[maxVertex[axis]]) - Vec3(positions[minVertex[axis]])).sqrMagnitude();
+            if (span > widest) {
+                widest = span;
+                widestAxis = axis;
+            }
+        }
+        Vec3 center = (Vec3(positions[minVertex[widestAxis]]) + Vec3(positions[maxVertex[widestAxis]])) * 0.5f;
+        float radius = std::sqrt(widest) * 0.5f;
+
+        for (const uint32_t vertex : vertices) {
+            const Vec3 p = positions[vertex];
+            const float distance = (p - center).magnitude();
+            if (distance > radius) {
+                // Moves the center towards p just far enough that the old sphere and p both fit
+                const float grownRadius = (radius + distance) * 0.5f;
+                center += (p - center) * ((grownRadius - radius) / distance);
+                radius = grownRadius;
+            }
+        }
+        meshlet.center = center;
+        meshlet.radius = radius;
+    }
+
+    void computeCone(Meshlet& meshlet, std::span<const Vec3Packed> triangleNormals) {
+        Vec3 axis(0.0f, 0.0f, 0.0f);
+        for (const Vec3 normal : triangleNormals) {
+            axis += normal;
+        }
+        axis = normalizedOrZero(axis);
+
+        float minCosine = 1.0f;
+        for (const Vec3 normal : triangleNormals) {
+            if (normal.sqrMagnitude() > 0.0f) {
+                minCosine = std::min(minCosine, Vec3::dot(axis, normal));
+            }
+        }
+        meshlet.coneAxis = axis;
+        // A camera sees only backs when it looks along the axis within 90 degrees minus the cone's half angle, whose
+        // cosine is the sine of the half angle
+        meshlet.coneCutoff = axis.sqrMagnitude() > 0.0f && minCosine > minConeCosine ? std::sqrt(1.0f - minCosine * minCosine) : 1.0f;
+    }
+
+    // The work of buildMeshlets, on only the vertices the indices use
+    Meshlets buildMeshletsLocal(std::span<uint32_t> indices, std::span<const Vec3Packed> positions, uint32_t maxVertices, uint32_t maxTriangles) {
+        const size_t triangleCount = indices.size() / 3;
+        const size_t vertexCount = positions.size();
+        Meshlets result;
+        if (triangleCount == 0) {
+            return result;
+        }
+
+        std::vector<Vec3Packed> triangleNormals(triangleCount);
+        std::vector<Vec3Packed> triangleCenters(triangleCount);
+        for (size_t triangle = 0; triangle < triangleCount; triangle++) {
+            const Vec3 p0 = positions[indices[3 * triangle + 0]];
+            const Vec3 p1 = positions[indices[3 * triangle + 1]];
+            const Vec3 p2 = positions[indices[3 * triangle + 2]];
+            triangleNormals[triangle] = normalizedOrZero(Vec3::cross(p1 - p0, p2 - p0));
+            triangleCenters[triangle] = (p0 + p1 + p2) / 3.0f;
+        }
+
+        // Triangles not in a meshlet yet around position p are vertexTriangles[triangleOffsets[p]] up to
+        // vertexTriangles[triangleOffsets[p] + liveTriangles[p]], emitted triangles are swapped behind that range
+        const std::vector<uint32_t> ids = positionIds(positions);
+        std::vector<uint32_t> liveTriangles(vertexCount, 0);
+        for (size_t i = 0; i < 3 * triangleCount; i++) {
+            liveTriangles[ids[indices[i]]]++;
+        }
+        std::vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+        std::partial_sum(liveTriangles.begin(), liveTriangles.end(), triangleOffsets.begin() + 1);
+        std::vector<uint32_t> vertexTriangles(3 * triangleCount);
+        {
+            std::vector<uint32_t> next(triangleOffsets.begin(), triangleOffsets.end() - 1);
+            for (size_t i = 0; i < 3 * triangleCount; i++) {
+                vertexTriangles[next[ids[indices[i]]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        // Index of a vertex in the meshlet being built, noIndex for vertices outside it
+        std::vector<uint32_t> localIndices(vertexCount, noIndex);
+        std::vector<bool> emitted(triangleCount);
+        std::vector<uint32_t> output;
+        output.reserve(3 * triangleCount);
+
+        Meshlet meshlet{};
+        Vec3 centerSum(0.0f, 0.0f, 0.0f);
+        Vec3 normalSum(0.0f, 0.0f, 0.0f);
+        std::vector<Vec3Packed> meshletNormals;
+
+        // Vertices the triangle adds to the meshlet, except that a triangle which is the last one left at one of its
+        // corners counts as adding none besides those it shares: left behind it would end up in a meshlet of its own
+        const auto growthCost = [&](uint32_t triangle) {
+            uint32_t added = 0;
+            bool dangling = false;
+            for (size_t corner = 0; corner < 3; corner++) {
+                const uint32_t vertex = indices[3 * triangle + corner];
+                added += localIndices[vertex] == noIndex;
+                dangling |= liveTriangles[ids[vertex]] == 1;
+            }
+            return added == 0 ? 0 : dangling ? 1 : added + 1;
+        };
+        const auto newVertices = [&](uint32_t triangle) {
+            uint32_t count = 0;
+            for (size_t corner = 0; corner < 3; corner++) {
+                count += localIndices[indices[3 * triangle + corner]] == noIndex;
+            }
+            return count;
+        };
+
+        const auto emit = [&](uint32_t triangle) {
+            for (size_t corner = 0; corner < 3; corner++) {
+                const uint32_t vertex = indices[3 * triangle + corner];
+                if (localIndices[vertex] == noIndex) {
+                    localIndices[vertex] = meshlet.vertexCount++;
+                    result.vertices.push_back(vertex);
+                }
+                result.triangles.push_back(static_cast<uint8_t>(localIndices[vertex]));
+                output.push_back(vertex);
+
+                // Corners at one position share its list, the triangle may already be gone from it
+                const uint32_t id = ids[vertex];
+                const auto live = vertexTriangles.begin() + triangleOffsets[id];
+                const auto found = std::find(live, live + liveTriangles[id], triangle);
+                if (found != live + liveTriangles[id]) {
+                    std::iter_swap(found, live + --liveTriangles[id]);
+                }
+            }
+            emitted[triangle] = true;
+            meshlet.triangleCount++;
+            centerSum += triangleCenters[triangle];
+            normalSum += triangleNormals[triangle];
+            meshletNormals.push_back(triangleNormals[triangle]);
+        };
+
+        const auto flush = [&]() {
+            if (meshlet.triangleCount == 0) {
+                return;
+            }
+            const std::span<const uint32_t> vertices = std::span<const uint32_t>(result.vertices).subspan(meshlet.vertexOffset, meshlet.vertexCount);
+            computeSphere(meshlet, vertices, positions);
+            computeCone(meshlet, meshletNormals);
+            for (const uint32_t vertex : vertices) {
+                localIndices[vertex] = noIndex;
+            }
+            result.meshlets.push_back(meshlet);
+
+            meshlet = {};
+            meshlet.firstIndex = static_cast<uint32_t>(output.size());
+            meshlet.vertexOffset = static_cast<uint32_t>(result.vertices.size());
+            meshlet.triangleOffset = static_cast<uint32_t>(result.triangles.size() / 3);
+            centerSum = normalSum = Vec3(0.0f, 0.0f, 0.0f);
+            meshletNormals.clear();
+        };
+
+        const auto reaches = [&](const Vec3& center, const Vec3& point) {
+            float reach = 0.0f;
+            for (uint32_t i = meshlet.vertexOffset; i < meshlet.vertexOffset + meshlet.vertexCount; i++) {
+                reach = std::max(reach, (Vec3(positions[result.vertices[i]]) - center).sqrMagnitude());
+            }
+            return (point - center).sqrMagnitude() <= reach;
+        };
+
+        size_t scanCursor = 0;
+        uint32_t seed = 0;
+        while (seed != noIndex) {
+            emit(seed);
+
+            while (true) {
+                const Vec3 center = centerSum / static_cast<float>(meshlet.triangleCount);
+                const Vec3 axis = normalizedOrZero(normalSum);
+                uint32_t best = noIndex;
+                uint32_t bestCost = std::numeric_limits<uint32_t>::max();
+                float bestScore = std::numeric_limits<float>::max();
+                for (uint32_t i = meshlet.vertexOffset; i < meshlet.vertexOffset + meshlet.vertexCount; i++) {
+                    const uint32_t id = ids[result.vertices[i]];
+                    for (uint32_t j = triangleOffsets[id]; j < triangleOffsets[id] + liveTriangles[id]; j++) {
+                        const uint32_t triangle = vertexTriangles[j];
+                        const uint32_t cost = growthCost(triangle);
+                        if (cost > bestCost) {
+                            continue;
+                        }
+                        // Squared distance times the squared cone penalty orders the same as the product, without a root
+                        const float penalty = 1.0f + coneWeight * (1.0f - Vec3::dot(axis, triangleNormals[triangle]));
+                        const float score = (Vec3(triangleCenters[triangle]) - center).sqrMagnitude() * penalty * penalty;
+                        if (cost < bestCost || score < bestScore) {
+                            best = triangle;
+                            bestCost = cost;
+                            bestScore = score;
+                        }
+                    }
+                }
+
+                // An isolated meshlet resumes the input order, and takes the next triangle in if it lies within the meshlet's
+                // reach, so small separate parts share meshlets with what they sit on
+                const bool isolated = best == noIndex;
+                if (isolated) {
+                    while (scanCursor < triangleCount && emitted[scanCursor]) {
+                        scanCursor++;
+                    }
+                    best = scanCursor < triangleCount ? static_cast<uint32_t>(scanCursor) : noIndex;
+                }
+                if (best != noIndex && meshlet.vertexCount + newVertices(best) <= maxVertices && meshlet.triangleCount < maxTriangles
+                    && (!isolated || reaches(center, triangleCenters[best]))) {
+                    emit(best);
+                    continue;
+                }
+                // A full meshlet hands the triangle it couldn't take to the next one
+                flush();
+                seed = best;
+                break;
+            }
+        }
+
+        std::copy(output.begin(), output.end(), indices.begin());
+        return result;
+    }
+}
+
+Meshlets buildMeshlets(std::span<uint32_t> indices, std::span<const Vec3Packed> positions, uint32_t maxVertices, uint32_t maxTriangles) {
+    // The adjacency and the per vertex state are sized by the vertices the range uses, not by the whole buffer
+    LocalVertices local = compactVertices(indices.first(indices.size() - indices.size() % 3));
+    const std::vector<Vec3Packed> localPositions = local.gather(positions);
+    Meshlets result = buildMeshletsLocal(local.indices, localPositions, maxVertices, maxTriangles);
+    for (uint32_t& vertex : result.vertices) {
+        vertex = local.vertices[vertex];
+    }
+    for (size_t i = 0; i < local.indices.size(); i++) {
+        indices[i] = local.vertices[local.indices[i]];
+    }
+    return result;
+}
+
+bool isBackfacing(const Meshlet& meshlet, const Vec3& cameraPosition) {
+    const Vec3 toCenter = Vec3(meshlet.center) - cameraPosition;
+    return Vec3::dot(toCenter, meshlet.coneAxis) >= meshlet.coneCutoff * toCenter.magnitude() + meshlet.radius;
+}
+
+std::array<Vec4, 6> frustumPlanes(const Mat4x4& clipFromLocal) {
+    // Gribb and Hartmann: a point is inside when -w <= x, y, z <= w in clip space, each bound is a plane of the rows
+    const Vec4 x = clipFromLocal.getRow(0);
+    const Vec4 y = clipFromLocal.getRow(1);
+    const Vec4 z = clipFromLocal.getRow(2);
+    const Vec4 w = clipFromLocal.getRow(3);
+    std::array<Vec4, 6> planes = { w + x, w - x, w + y, w - y, w + z, w - z };
+    for (Vec4& plane : planes) {
+        const float length = Vec3(plane.x, plane.y, plane.z).magnitude();
+        if (length > 0.0f) {
+            plane = plane / length;
+        }
+    }
+    return planes;
+}
+
+bool isOutsideFrustum(const Meshlet& meshlet, std::span<const Vec4, 6> planes) {
+    for (const Vec4& plane : planes) {
+        if (plane.x * meshlet.center.x + plane.y * meshlet.center.y + plane.z * meshlet.center.z + plane.w < -meshlet.radius) {
+            return true;
+        }
+    }
+    return false;
+}
+}
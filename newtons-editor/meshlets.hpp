@@ -0,0 +1,65 @@
+#pragma once
+
+#include "mat4x4.hpp"
+#include "vec3.hpp"
+#include "vec4.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace nwt{
+    // Limits that fit the mesh shader output of every vendor: 64 vertices and 124 triangles, so the 8 bit local
+    // triangle indices of a meshlet fill whole 4 byte words with one to spare
+    constexpr uint32_t maxMeshletVertices = 64;
+    constexpr uint32_t maxMeshletTriangles = 124;
+
+    // A cluster of neighbouring triangles that is culled as a whole. Stored as is in the .nmesh meshlet table.
+    struct Meshlet{
+        // The meshlet's triangles are the index range firstIndex up to firstIndex + 3 * triangleCount, so a renderer
+        // without mesh shaders can draw every visible meshlet with the index buffer
+        uint32_t firstIndex;
+        uint32_t triangleCount;
+        // The same triangles for mesh shaders and compute: meshletTriangles[3 * triangleOffset] on hold 3 local indices
+        // per triangle into meshletVertices[vertexOffset] up to meshletVertices[vertexOffset + vertexCount]
+        uint32_t vertexOffset;
+        uint32_t vertexCount;
+        uint32_t triangleOffset;
+        // Sphere around all vertices
+        Vec3Packed center;
+        float radius;
+        // Every triangle faces away from a camera at position p when dot(center - p, coneAxis) >= coneCutoff *
+        // length(center - p) + radius, see isBackfacing. coneCutoff is 1 when the normals spread too far for the test.
+        Vec3Packed coneAxis;
+        float coneCutoff;
+    };
+
+    struct Meshlets{
+        std::vector<Meshlet> meshlets;
+        // Mesh vertex of every meshlet vertex
+        std::vector<uint32_t> vertices;
+        // Three indices into the meshlet's vertices per triangle
+        std::vector<uint8_t> triangles;
+    };
+
+    // Splits a triangle list into meshlets of at most maxVertices vertices and maxTriangles triangles and reorders
+    // indices so each meshlet's triangles are consecutive, firstIndex counts from the start of indices. A meshlet grows
+    // by the neighbouring triangle that adds the fewest vertices, then the one closest to its center and normal, so
+    // meshlets stay round and flat and their spheres and cones tight. A full or isolated meshlet continues with the next
+    // triangle of the input order, which keeps the order of a vertex cache optimized list mostly intact.
+    Meshlets buildMeshlets(std::span<uint32_t> indices, std::span<const Vec3Packed> positions,
+        uint32_t maxVertices = maxMeshletVertices, uint32_t maxTriangles = maxMeshletTriangles);
+
+    // True when a camera at cameraPosition sees only the back of every triangle in the meshlet. cameraPosition is in
+    // the space of the mesh, the test holds under rotation, translation, mirroring and uniform scale.
+    bool isBackfacing(const Meshlet& meshlet, const Vec3& cameraPosition);
+
+    // Left, right, bottom, top, near and far plane of clipFromLocal (projection * view * model) with normals pointing
+    // inside, so the planes are in the space of the mesh. near and far assume a -1 to 1 depth range, for a 0 to 1
+    // range the near plane is conservative.
+    std::array<Vec4, 6> frustumPlanes(const Mat4x4& clipFromLocal);
+
+    // True when the meshlet's sphere lies entirely outside one of planes
+    bool isOutsideFrustum(const Meshlet& meshlet, std::span<const Vec4, 6> planes);
+}
@@ -1,86 +1,806 @@
 #pragma once
 
-#include <fstream> 
-#include <iostream> 
-#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "mapped_file.hpp"
 
 namespace obj {
 	struct Index {
+		// Missing indices, like the texture coordinate of "f 1//1", are stored as none
+		static constexpr size_t none = static_cast<size_t>(-1);
+
 		size_t vertex_index;
 		size_t tex_coord_index;
 		size_t normal_index;
 	};
 
+	// Faces sharing the names of the last o, g and usemtl statements before them, names that were never set are empty
+	struct Group {
+		std::string object;
+		std::string group;
+		std::string material;
+		size_t first_index;
+		size_t index_count;
+	};
+
 	struct Object {
 		std::vector<float> vertices;
 		std::vector<float> normals;
 		std::vector<float> tex_coords;
+		// Triangle corners, polygons are triangulated while reading
 		std::vector<Index> indices;
+		// Every index belongs to exactly one group. Each group is one contiguous range, and groups with the same
+		// material are adjacent in order of the material's first use, so a material can be drawn with a single call.
+		std::vector<Group> groups;
+		std::vector<std::string> material_libraries;
+	};
+
+	/// <summary>
+	/// Thrown for malformed obj text, line is the 1 based line number in the file.
+	/// </summary>
+	class ParseError : public std::runtime_error {
+	public:
+		ParseError(const std::string& reason, size_t line)
+			: std::runtime_error("Failed to parse obj file, " + reason + " on line " + std::to_string(line)), reason(reason), line(line) {}
+
+		std::string reason;
+		size_t line;
+	};
+
+	/// <summary>
+	/// Parses obj text into object, appending to its arrays. Lines are tokenized in place, nothing is allocated per line.
+	/// </summary>
+	void ParseObj(std::string_view text, Object& object);
+
+	// Chunks smaller than this aren't worth a thread
+	inline constexpr size_t defaultMinChunkSize = 1 << 20;
+
+	/// <summary>
+	/// Parses obj text on threadCount threads, 0 uses one per core. The text is split into chunks of at least
+	/// minChunkSize bytes at line boundaries, every chunk is parsed into its own arrays and the results are concatenated
+	/// in file order.
+	/// </summary>
+	void ParseObjParallel(std::string_view text, Object& object, unsigned threadCount = 0, size_t minChunkSize = defaultMinChunkSize);
+
+	void ReadObjFile(const std::filesystem::path& path, Object& object, unsigned threadCount = 0);
+
+	// A face corner with its attributes looked up, missing texture coordinates and normals are 0
+	struct TriangleVertex {
+		float position[3];
+		float tex_coord[2];
+		float normal[3];
+	};
+
+	struct Triangle {
+		TriangleVertex vertices[3];
 	};
 
-	std::vector<std::string> SplitString(const std::string& str, char delim) {
-		std::vector<std::string> result;
-		std::string current;
-		for (int i = 0; i < str.size(); i++) {
-			if (str[i] == delim) {
-				result.emplace_back(current);
-				current.clear();
+	using TriangleBatchCallback = std::function<void(std::span<const Triangle>)>;
+
+	/// <summary>
+	/// Parses obj text and passes its faces as triangles to callback, at most batchSize per call and in file order.
+	/// Only the v/vt/vn arrays are kept, so memory is bounded by them plus one batch no matter how many faces there are.
+	/// Faces may only use vertices defined before them.
+	/// </summary>
+	void StreamObj(std::string_view text, size_t batchSize, const TriangleBatchCallback& callback);
+
+	/// <summary>
+	/// StreamObj over a mapped file. The mapping is read sequentially, so the OS can evict pages that were already parsed.
+	/// </summary>
+	void StreamObjFile(const std::filesystem::path& path, size_t batchSize, const TriangleBatchCallback& callback);
+
+	//
+	// Parsing
+	//
+
+	namespace detail {
+		inline bool IsBlank(char c) {
+			return c == ' ' || c == '\t' || c == '\r';
+		}
+
+		inline const char* SkipBlanks(const char* it, const char* end) {
+			while (it < end && IsBlank(*it)) {
+				it++;
 			}
-			else {
-				current.push_back(str[i]);
+			return it;
+		}
+
+		[[noreturn]] inline void ThrowParseError(const char* what, size_t line) {
+			throw ParseError(what, line);
+		}
+
+		// The rest of the line without surrounding blanks, names may contain spaces
+		inline std::string Trimmed(const char* it, const char* end) {
+			it = SkipBlanks(it, end);
+			while (end > it && IsBlank(end[-1])) {
+				end--;
 			}
+			return std::string(it, end);
 		}
-		result.emplace_back(current);
-		return result;
-	}
 
-	void ReadObjFile(const char* path, Object& object) {
-		std::ifstream file(path);
-		if (!file.is_open()) {
-			throw std::runtime_error("Failed to open obj file");
+		// Parses the next blank separated float, a missing value reads as 0
+		inline const char* ParseFloat(const char* it, const char* end, float& value, size_t line) {
+			it = SkipBlanks(it, end);
+			if (it == end) {
+				value = 0;
+				return it;
+			}
+			// from_chars doesn't accept a leading '+'
+			if (*it == '+') {
+				it++;
+			}
+			const auto [ptr, ec] = std::from_chars(it, end, value);
+			if (ec != std::errc()) {
+				ThrowParseError("invalid number", line);
+			}
+			return ptr;
 		}
 
-		std::string line;
+		// Parses a 1 based obj index into a 0 based one, an empty index is Index::none.
+		// Negative indices count back from count, the number of elements read so far, and set relative.
+		inline const char* ParseIndex(const char* it, const char* end, size_t count, size_t& index, bool& relative, size_t line) {
+			relative = false;
+			if (it == end || *it == '/' || IsBlank(*it)) {
+				index = Index::none;
+				return it;
+			}
+			if (*it == '-') {
+				relative = true;
+				it++;
+			}
+			size_t value;
+			const auto [ptr, ec] = std::from_chars(it, end, value);
+			if (ec != std::errc() || value == 0) {
+				ThrowParseError("invalid face index", line);
+			}
+			// A relative index may point before the chunk being parsed, the wrapped value is fixed by adding the chunk's offset
+			index = relative ? count - value : value - 1;
+			return ptr;
+		}
 
-		while (std::getline(file, line)) {
-			if (line[0] == '#') {
-				continue;
+		inline void ParseFloats(const char* it, const char* end, std::vector<float>& out, size_t count, size_t line) {
+			for (size_t i = 0; i < count; i++) {
+				float value;
+				it = ParseFloat(it, end, value, line);
+				out.push_back(value);
 			}
+		}
 
-			std::vector<std::string> parts = SplitString(line, ' ');
-			std::string& type = parts[0];
+		// Members of Index in the order they appear in a face vertex
+		inline constexpr size_t Index::* indexMembers[] = { &Index::vertex_index, &Index::tex_coord_index, &Index::normal_index };
 
+		// Appends the corners of a face to out. Positions of relative indices are added to relative as
+		// 3 * corner + member, their values are still missing the elements that came before attributes.
+		inline void ParseFace(const char* it, const char* end, const Object& attributes, std::vector<Index>& out, std::vector<size_t>& relative, size_t line) {
+			const size_t counts[] = { attributes.vertices.size() / 3, attributes.tex_coords.size() / 2, attributes.normals.size() / 3 };
+			while ((it = SkipBlanks(it, end)) < end) {
+				Index index{ Index::none, Index::none, Index::none };
+				for (size_t member = 0; member < 3; member++) {
+					if (member > 0) {
+						if (it == end || *it != '/') {
+							break;
+						}
+						it++;
+					}
+					bool isRelative;
+					it = ParseIndex(it, end, counts[member], index.*indexMembers[member], isRelative, line);
+					if (isRelative) {
+						relative.push_back(3 * out.size() + member);
+					}
+				}
+				if (it < end && !IsBlank(*it)) {
+					ThrowParseError("invalid face vertex", line);
+				}
+				out.push_back(index);
+			}
+		}
 
-			if (type == "v") {
-				for (size_t i = 1; i < parts.size(); i++) {
-					object.vertices.emplace_back(std::stof(parts[i]));
+		// Calls statement(type, arguments, lineEnd, line) for every line, the arguments start after the type
+		template<typename Statement>
+		inline void ForEachStatement(std::string_view text, Statement statement) {
+			const char* it = text.data();
+			const char* end = it + text.size();
+			for (size_t line = 1; it < end; line++) {
+				const char* lineEnd = static_cast<const char*>(std::memchr(it, '\n', end - it));
+				if (!lineEnd) {
+					lineEnd = end;
+				}
+
+				const char* start = SkipBlanks(it, lineEnd);
+				const char* typeEnd = start;
+				while (typeEnd < lineEnd && !IsBlank(*typeEnd)) {
+					typeEnd++;
 				}
+				statement(std::string_view(start, typeEnd - start), typeEnd, lineEnd, line);
+
+				it = lineEnd + 1;
+			}
+		}
+
+		// Appends v, vt and vn lines to object, returns false for any other type.
+		// Positions and normals are always read as xyz and texture coordinates as uv,
+		// so the arrays keep a fixed stride even if a line has extra or missing components.
+		inline bool ParseAttribute(std::string_view type, const char* it, const char* end, Object& object, size_t line) {
+			if (type == "v") {
+				ParseFloats(it, end, object.vertices, 3, line);
 			}
 			else if (type == "vt") {
-				for (size_t i = 1; i < parts.size(); i++) {
-					object.tex_coords.emplace_back(std::stof(parts[i]));
-				}
+				ParseFloats(it, end, object.tex_coords, 2, line);
 			}
 			else if (type == "vn") {
-				for (size_t i = 1; i < parts.size(); i++) {
-					object.normals.emplace_back(std::stof(parts[i]));
+				ParseFloats(it, end, object.normals, 3, line);
+			}
+			else {
+				return false;
+			}
+			return true;
+		}
+
+		struct Counts {
+			size_t vertices = 0;
+			size_t normals = 0;
+			size_t texCoords = 0;
+			size_t faces = 0;
+			size_t faceVertices = 0;
+		};
+
+		// Counts the elements of every line type, the spaces of face lines approximate their vertex count
+		inline Counts PreScan(std::string_view text) {
+			Counts counts;
+			const char* it = text.data();
+			const char* end = it + text.size();
+			while (it < end) {
+				const char* lineEnd = static_cast<const char*>(std::memchr(it, '\n', end - it));
+				if (!lineEnd) {
+					lineEnd = end;
+				}
+
+				if (lineEnd - it > 2) {
+					if (it[0] == 'v') {
+						counts.vertices += it[1] == ' ';
+						counts.texCoords += it[1] == 't';
+						counts.normals += it[1] == 'n';
+					}
+					else if (it[0] == 'f' && it[1] == ' ') {
+						counts.faces++;
+						counts.faceVertices += std::count(it + 2, lineEnd, ' ') + 1;
+					}
 				}
+				it = lineEnd + 1;
 			}
-			else if (type == "f") {
-				for (size_t i = 1; i < parts.size(); i++) {
-					std::vector<std::string> indices = SplitString(parts[i], '/');
-					object.indices.emplace_back(
-						static_cast<size_t>(std::stoi(indices[0])) - 1,
-						static_cast<size_t>(std::stoi(indices[1])) - 1,
-						static_cast<size_t>(std::stoi(indices[2])) - 1
-					);
+			return counts;
+		}
+
+		//
+		// Triangulation
+		//
+
+		/// <summary>
+		/// Replaces out with the triangles of a polygon as corner numbers into polygon, keeping its winding. Polygons with
+		/// more than 3 corners are ear clipped in the plane of their Newell normal so concave faces are split correctly,
+		/// degenerate ones fall back to a fan.
+		/// </summary>
+		inline void TriangulatePolygon(std::span<const Index> polygon, const std::vector<float>& positions, std::vector<uint32_t>& out, std::vector<uint32_t>& remaining) {
+			out.clear();
+			if (polygon.size() == 3) {
+				out.insert(out.end(), { 0, 1, 2 });
+				return;
+			}
+
+			const auto position = [&](size_t corner, size_t axis) { return positions[3 * polygon[corner].vertex_index + axis]; };
+			float normal[3] = { 0, 0, 0 };
+			for (size_t i = 0; i < polygon.size(); i++) {
+				const size_t j = (i + 1) % polygon.size();
+				normal[0] += (position(i, 1) - position(j, 1)) * (position(i, 2) + position(j, 2));
+				normal[1] += (position(i, 2) - position(j, 2)) * (position(i, 0) + position(j, 0));
+				normal[2] += (position(i, 0) - position(j, 0)) * (position(i, 1) + position(j, 1));
+			}
+			// Project along the largest normal axis, the orientation flips with the sign of the normal
+			const size_t dominant = std::abs(normal[0]) > std::abs(normal[1])
+				? (std::abs(normal[0]) > std::abs(normal[2]) ? 0 : 2)
+				: (std::abs(normal[1]) > std::abs(normal[2]) ? 1 : 2);
+			const size_t u = (dominant + 1) % 3;
+			const size_t v = (dominant + 2) % 3;
+			const float orientation = normal[dominant] < 0 ? -1.0f : 1.0f;
+			const auto cross = [&](uint32_t a, uint32_t b, uint32_t c) {
+				return orientation * ((position(b, u) - position(a, u)) * (position(c, v) - position(a, v)) - (position(b, v) - position(a, v)) * (position(c, u) - position(a, u)));
+			};
+			const auto emit = [&](uint32_t a, uint32_t b, uint32_t c) {
+				out.insert(out.end(), { a, b, c });
+			};
+
+			remaining.resize(polygon.size());
+			for (uint32_t i = 0; i < remaining.size(); i++) {
+				remaining[i] = i;
+			}
+			while (remaining.size() > 3) {
+				const size_t count = remaining.size();
+				bool clipped = false;
+				for (size_t i = 0; i < count && !clipped; i++) {
+					const uint32_t a = remaining[(i + count - 1) % count];
+					const uint32_t b = remaining[i];
+					const uint32_t c = remaining[(i + 1) % count];
+					// Reflex or degenerate corner
+					if (cross(a, b, c) <= 0) {
+						continue;
+					}
+					bool isEar = true;
+					for (const uint32_t other : remaining) {
+						if (other != a && other != b && other != c && cross(a, b, other) > 0 && cross(b, c, other) > 0 && cross(c, a, other) > 0) {
+							isEar = false;
+							break;
+						}
+					}
+					if (isEar) {
+						emit(a, b, c);
+						remaining.erase(remaining.begin() + i);
+						clipped = true;
+					}
+				}
+				if (!clipped) {
+					for (size_t i = 1; i + 1 < remaining.size(); i++) {
+						emit(remaining[0], remaining[i], remaining[i + 1]);
+					}
+					return;
 				}
 			}
-			else {
+			emit(remaining[0], remaining[1], remaining[2]);
+		}
+
+		//
+		// Chunks
+		//
+
+		// Names set by o, g and usemtl statements, names that aren't set are inherited from the text before the chunk
+		struct GroupNames {
+			std::optional<std::string> object;
+			std::optional<std::string> group;
+			std::optional<std::string> material;
+		};
+
+		struct ChunkGroup {
+			GroupNames names;
+			// Face index while parsing, index into the chunk's triangles once resolved
+			size_t first;
+		};
+
+		// Everything parsed from one piece of the text, its indices are only usable once the chunks are merged
+		struct Chunk {
+			Object object;
+			std::vector<uint32_t> faceSizes;
+			// Line of every face counted from the start of the chunk, for errors found once the chunks are merged
+			std::vector<size_t> faceLines;
+			std::vector<size_t> relativeIndices;
+			std::vector<ChunkGroup> groups;
+			GroupNames names;
+			bool namesChanged = true;
+			std::vector<Index> triangles;
+		};
+
+		inline void ParseChunk(std::string_view text, Chunk& chunk) {
+			const Counts counts = PreScan(text);
+			Object& object = chunk.object;
+			object.vertices.reserve(counts.vertices * 3);
+			object.tex_coords.reserve(counts.texCoords * 2);
+			object.normals.reserve(counts.normals * 3);
+			object.indices.reserve(counts.faceVertices);
+			chunk.faceSizes.reserve(counts.faces);
+			chunk.faceLines.reserve(counts.faces);
+
+			ForEachStatement(text, [&](std::string_view type, const char* it, const char* end, size_t line) {
+				if (ParseAttribute(type, it, end, object, line)) {
+					return;
+				}
+
+				if (type == "f") {
+					// Groups start at the first face after a name change, so they are never empty
+					if (chunk.namesChanged) {
+						chunk.groups.push_back({ chunk.names, chunk.faceSizes.size() });
+						chunk.namesChanged = false;
+					}
+					const size_t first = object.indices.size();
+					ParseFace(it, end, object, object.indices, chunk.relativeIndices, line);
+					if (object.indices.size() - first < 3) {
+						ThrowParseError("face with less than 3 vertices", line);
+					}
+					chunk.faceSizes.push_back(static_cast<uint32_t>(object.indices.size() - first));
+					chunk.faceLines.push_back(line);
+				}
+				else if (type == "o") {
+					chunk.names.object = Trimmed(it, end);
+					chunk.namesChanged = true;
+				}
+				else if (type == "g") {
+					chunk.names.group = Trimmed(it, end);
+					chunk.namesChanged = true;
+				}
+				else if (type == "usemtl") {
+					chunk.names.material = Trimmed(it, end);
+					chunk.namesChanged = true;
+				}
+				else if (type == "mtllib") {
+					while ((it = SkipBlanks(it, end)) < end) {
+						const char* nameEnd = it;
+						while (nameEnd < end && !IsBlank(*nameEnd)) {
+							nameEnd++;
+						}
+						object.material_libraries.emplace_back(it, nameEnd);
+						it = nameEnd;
+					}
+				}
+				// Comments and unsupported statements are skipped
+			});
+		}
+
+		// Offsets the relative indices of chunk by the elements before it, checks every index and triangulates the faces.
+		// object already holds the attributes of all chunks.
+		inline void ResolveChunk(Chunk& chunk, const size_t (&offsets)[3], const Object& object) {
+			std::vector<Index>& corners = chunk.object.indices;
+			const size_t counts[] = { object.vertices.size() / 3, object.tex_coords.size() / 2, object.normals.size() / 3 };
+			size_t relative = 0;
+			size_t corner = 0;
+			for (size_t face = 0; face < chunk.faceSizes.size(); face++) {
+				const size_t faceEnd = corner + chunk.faceSizes[face];
+				// A relative index before the chunk wrapped below zero, one before the file would wrap again when the
+				// offset is added and could land on Index::none
+				for (; relative < chunk.relativeIndices.size() && chunk.relativeIndices[relative] / 3 < faceEnd; relative++) {
+					const size_t position = chunk.relativeIndices[relative];
+					size_t& index = corners[position / 3].*indexMembers[position % 3];
+					if (static_cast<std::ptrdiff_t>(index) < 0 && 0 - index > offsets[position % 3]) {
+						ThrowParseError("face index out of range", chunk.faceLines[face]);
+					}
+					index += offsets[position % 3];
+				}
+				for (; corner < faceEnd; corner++) {
+					if (corners[corner].vertex_index == Index::none) {
+						ThrowParseError("face vertex without position", chunk.faceLines[face]);
+					}
+					for (size_t member = 0; member < 3; member++) {
+						const size_t index = corners[corner].*indexMembers[member];
+						if (index != Index::none && index >= counts[member]) {
+							ThrowParseError("face index out of range", chunk.faceLines[face]);
+						}
+					}
+				}
 			}
 
+			// Files with only triangles keep their corners as they are
+			if (corners.size() == 3 * chunk.faceSizes.size()) {
+				for (ChunkGroup& group : chunk.groups) {
+					group.first *= 3;
+				}
+				chunk.triangles = std::move(corners);
+				return;
+			}
+
+			size_t triangleCorners = 0;
+			for (const uint32_t size : chunk.faceSizes) {
+				triangleCorners += 3 * (size - 2);
+			}
+			chunk.triangles.reserve(triangleCorners);
+
+			std::vector<uint32_t> triangles;
+			std::vector<uint32_t> remaining;
+			corner = 0;
+			size_t group = 0;
+			for (size_t face = 0; face < chunk.faceSizes.size(); face++) {
+				if (group < chunk.groups.size() && chunk.groups[group].first == face) {
+					chunk.groups[group++].first = chunk.triangles.size();
+				}
+				const std::span<const Index> polygon = std::span<const Index>(corners).subspan(corner, chunk.faceSizes[face]);
+				TriangulatePolygon(polygon, object.vertices, triangles, remaining);
+				for (const uint32_t triangleCorner : triangles) {
+					chunk.triangles.push_back(polygon[triangleCorner]);
+				}
+				corner += chunk.faceSizes[face];
+			}
+			corners = {};
 		}
+
+		/// <summary>
+		/// Reorders the triangles of object so every distinct (object, group, material) is one range and ranges of the
+		/// same material are adjacent, both in order of first appearance. Adjacent ranges with equal names are merged.
+		/// </summary>
+		inline void MergeGroups(Object& object) {
+			using Names = std::tuple<std::string_view, std::string_view, std::string_view>;
+			const auto names = [](const Group& group) { return Names(group.object, group.group, group.material); };
+
+			std::map<std::string_view, size_t> materialOrder;
+			std::map<Names, size_t> nameOrder;
+			std::vector<size_t> firstGroups;
+			for (size_t i = 0; i < object.groups.size(); i++) {
+				materialOrder.try_emplace(object.groups[i].material, materialOrder.size());
+				if (nameOrder.try_emplace(names(object.groups[i]), nameOrder.size()).second) {
+					firstGroups.push_back(i);
+				}
+			}
+
+			// Distinct names sorted by the first use of their material, then by their own first use
+			std::vector<size_t> order(firstGroups.size());
+			for (size_t i = 0; i < order.size(); i++) {
+				order[i] = i;
+			}
+			std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+				return materialOrder[object.groups[firstGroups[a]].material] < materialOrder[object.groups[firstGroups[b]].material];
+			});
+			std::vector<size_t> rankOfName(order.size());
+			for (size_t i = 0; i < order.size(); i++) {
+				rankOfName[order[i]] = i;
+			}
+			std::vector<size_t> rank(object.groups.size());
+			for (size_t i = 0; i < object.groups.size(); i++) {
+				rank[i] = rankOfName[nameOrder[names(object.groups[i])]];
+			}
+
+			std::vector<Group> merged;
+			merged.reserve(order.size());
+			if (std::is_sorted(rank.begin(), rank.end())) {
+				for (Group& group : object.groups) {
+					if (!merged.empty() && names(merged.back()) == names(group)) {
+						merged.back().index_count += group.index_count;
+					}
+					else {
+						merged.push_back(std::move(group));
+					}
+				}
+				object.groups = std::move(merged);
+				return;
+			}
+
+			std::vector<Index> indices;
+			indices.reserve(object.indices.size());
+			for (size_t r = 0; r < order.size(); r++) {
+				Group group = object.groups[firstGroups[order[r]]];
+				group.first_index = indices.size();
+				for (size_t i = 0; i < object.groups.size(); i++) {
+					if (rank[i] == r) {
+						const auto begin = object.indices.begin() + object.groups[i].first_index;
+						indices.insert(indices.end(), begin, begin + object.groups[i].index_count);
+					}
+				}
+				group.index_count = indices.size() - group.first_index;
+				merged.push_back(std::move(group));
+			}
+			object.indices = std::move(indices);
+			object.groups = std::move(merged);
+		}
+
+		// Runs work(i) for i in [0, count), one thread per index with the last one on the calling thread
+		template<typename Work>
+		inline void ParallelFor(size_t count, Work work) {
+			std::vector<std::jthread> threads;
+			threads.reserve(count - 1);
+			for (size_t i = 0; i + 1 < count; i++) {
+				threads.emplace_back(work, i);
+			}
+			work(count - 1);
+		}
+
+		// Grows array to fit the arrays of all chunks, returns where every chunk starts from the prefix sum of their sizes
+		template<typename T>
+		inline std::vector<size_t> ResizeForChunks(std::vector<T>& array, const std::vector<Chunk>& chunks, std::vector<T> Object::* chunkArray) {
+			std::vector<size_t> offsets(chunks.size());
+			size_t offset = array.size();
+			for (size_t i = 0; i < chunks.size(); i++) {
+				offsets[i] = offset;
+				offset += (chunks[i].object.*chunkArray).size();
+			}
+			array.resize(offset);
+			return offsets;
+		}
+
+		// Rethrows the error of the first failed chunk, ParseErrors with the line counted from the start of text
+		inline void RethrowFirstError(std::string_view text, const std::vector<size_t>& bounds, const std::vector<std::exception_ptr>& errors) {
+			for (size_t i = 0; i < errors.size(); i++) {
+				if (!errors[i]) {
+					continue;
+				}
+				try {
+					std::rethrow_exception(errors[i]);
+				}
+				catch (const ParseError& error) {
+					// Chunks count lines from their own start, the file line is only needed on failure
+					const size_t previousLines = std::count(text.begin(), text.begin() + bounds[i], '\n');
+					throw ParseError(error.reason, previousLines + error.line);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Parses the text between consecutive bounds, one thread per chunk, and appends the result to object.
+		/// </summary>
+		inline void ParseChunks(std::string_view text, const std::vector<size_t>& bounds, Object& object) {
+			const size_t chunkCount = bounds.size() - 1;
+			std::vector<Chunk> chunks(chunkCount);
+			std::vector<std::exception_ptr> errors(chunkCount);
+			ParallelFor(chunkCount, [&](size_t i) {
+				try {
+					ParseChunk(text.substr(bounds[i], bounds[i + 1] - bounds[i]), chunks[i]);
+				}
+				catch (...) {
+					errors[i] = std::current_exception();
+				}
+			});
+
+			RethrowFirstError(text, bounds, errors);
+
+			// Attributes are concatenated first, faces can use the attributes of any chunk before them
+			const std::vector<size_t> vertexOffsets = ResizeForChunks(object.vertices, chunks, &Object::vertices);
+			const std::vector<size_t> texCoordOffsets = ResizeForChunks(object.tex_coords, chunks, &Object::tex_coords);
+			const std::vector<size_t> normalOffsets = ResizeForChunks(object.normals, chunks, &Object::normals);
+			ParallelFor(chunkCount, [&](size_t i) {
+				std::copy(chunks[i].object.vertices.begin(), chunks[i].object.vertices.end(), object.vertices.begin() + vertexOffsets[i]);
+				std::copy(chunks[i].object.tex_coords.begin(), chunks[i].object.tex_coords.end(), object.tex_coords.begin() + texCoordOffsets[i]);
+				std::copy(chunks[i].object.normals.begin(), chunks[i].object.normals.end(), object.normals.begin() + normalOffsets[i]);
+			});
+
+			ParallelFor(chunkCount, [&](size_t i) {
+				try {
+					const size_t offsets[] = { vertexOffsets[i] / 3, texCoordOffsets[i] / 2, normalOffsets[i] / 3 };
+					ResolveChunk(chunks[i], offsets, object);
+				}
+				catch (...) {
+					errors[i] = std::current_exception();
+				}
+			});
+			RethrowFirstError(text, bounds, errors);
+
+			// Faces at the start of a chunk continue with the names of the text before it
+			std::vector<size_t> indexOffsets(chunkCount);
+			size_t indexCount = object.indices.size();
+			GroupNames names;
+			for (size_t i = 0; i < chunkCount; i++) {
+				const Chunk& chunk = chunks[i];
+				indexOffsets[i] = indexCount;
+				for (size_t g = 0; g < chunk.groups.size(); g++) {
+					const ChunkGroup& group = chunk.groups[g];
+					const size_t end = g + 1 < chunk.groups.size() ? chunk.groups[g + 1].first : chunk.triangles.size();
+					object.groups.push_back({
+						group.names.object.value_or(names.object.value_or("")),
+						group.names.group.value_or(names.group.value_or("")),
+						group.names.material.value_or(names.material.value_or("")),
+						indexCount + group.first,
+						end - group.first
+					});
+				}
+				indexCount += chunk.triangles.size();
+
+				names.object = chunk.names.object ? chunk.names.object : names.object;
+				names.group = chunk.names.group ? chunk.names.group : names.group;
+				names.material = chunk.names.material ? chunk.names.material : names.material;
+				object.material_libraries.insert(object.material_libraries.end(), chunk.object.material_libraries.begin(), chunk.object.material_libraries.end());
+			}
+
+			object.indices.resize(indexCount);
+			ParallelFor(chunkCount, [&](size_t i) {
+				std::copy(chunks[i].triangles.begin(), chunks[i].triangles.end(), object.indices.begin() + indexOffsets[i]);
+			});
+
+			MergeGroups(object);
+		}
+	}
+
+	inline void ParseObj(std::string_view text, Object& object) {
+		detail::ParseChunks(text, { 0, text.size() }, object);
+	}
+
+	inline void ParseObjParallel(std::string_view text, Object& object, unsigned threadCount, size_t minChunkSize) {
+		if (threadCount == 0) {
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+		}
+		const size_t chunkCount = std::clamp<size_t>(text.size() / std::max<size_t>(minChunkSize, 1), 1, threadCount);
+
+		// Split at evenly spaced offsets, moved forward to the start of the next line
+		std::vector<size_t> bounds(chunkCount + 1, text.size());
+		bounds[0] = 0;
+		for (size_t i = 1; i < chunkCount; i++) {
+			const size_t newline = text.find('\n', std::max(i * text.size() / chunkCount, bounds[i - 1]));
+			bounds[i] = newline == std::string_view::npos ? text.size() : newline + 1;
+		}
+		detail::ParseChunks(text, bounds, object);
+	}
+
+	inline void ReadObjFile(const std::filesystem::path& path, Object& object, unsigned threadCount) {
+		const nwt::MappedFile file(path);
+		ParseObjParallel(file.view(), object, threadCount);
+	}
+
+	//
+	// Streaming
+	//
+
+	namespace detail {
+		inline void CopyAttribute(const std::vector<float>& values, size_t index, size_t count, float* out, size_t line) {
+			if (index == Index::none) {
+				std::fill(out, out + count, 0.0f);
+				return;
+			}
+			if (index >= values.size() / count) {
+				ThrowParseError("face index out of range", line);
+			}
+			std::copy(values.begin() + index * count, values.begin() + (index + 1) * count, out);
+		}
+
+		inline TriangleVertex ResolveVertex(const Object& attributes, const Index& index, size_t line) {
+			if (index.vertex_index == Index::none) {
+				ThrowParseError("face vertex without position", line);
+			}
+			TriangleVertex vertex;
+			CopyAttribute(attributes.vertices, index.vertex_index, 3, vertex.position, line);
+			CopyAttribute(attributes.tex_coords, index.tex_coord_index, 2, vertex.tex_coord, line);
+			CopyAttribute(attributes.normals, index.normal_index, 3, vertex.normal, line);
+			return vertex;
+		}
+	}
+
+	inline void StreamObj(std::string_view text, size_t batchSize, const TriangleBatchCallback& callback) {
+		if (batchSize == 0) {
+			throw std::invalid_argument("obj stream batch size must not be 0");
+		}
+
+		// Only the attributes are stored, the corners of one face at a time go through face and are dropped
+		Object attributes;
+		std::vector<Index> face;
+		std::vector<uint32_t> triangles;
+		std::vector<size_t> relative;
+		std::vector<uint32_t> remaining;
+		std::vector<TriangleVertex> corners;
+		std::vector<Triangle> batch;
+		batch.reserve(batchSize);
+
+		detail::ForEachStatement(text, [&](std::string_view type, const char* it, const char* end, size_t line) {
+			if (detail::ParseAttribute(type, it, end, attributes, line) || type != "f") {
+				return;
+			}
+
+			// Every element before the face is known here, so relative indices already come out absolute
+			face.clear();
+			detail::ParseFace(it, end, attributes, face, relative, line);
+			relative.clear();
+			if (face.size() < 3) {
+				detail::ThrowParseError("face with less than 3 vertices", line);
+			}
+			// Resolving first also checks the indices before triangulation reads their positions
+			corners.clear();
+			for (const Index& corner : face) {
+				corners.push_back(detail::ResolveVertex(attributes, corner, line));
+			}
+
+			detail::TriangulatePolygon(face, attributes.vertices, triangles, remaining);
+			for (size_t i = 0; i < triangles.size(); i += 3) {
+				batch.push_back({ { corners[triangles[i + 0]], corners[triangles[i + 1]], corners[triangles[i + 2]] } });
+
+				if (batch.size() == batchSize) {
+					callback(batch);
+					batch.clear();
+				}
+			}
+		});
+
+		if (!batch.empty()) {
+			callback(batch);
+		}
+	}
+
+	inline void StreamObjFile(const std::filesystem::path& path, size_t batchSize, const TriangleBatchCallback& callback) {
+		const nwt::MappedFile file(path);
+		StreamObj(file.view(), batchSize, callback);
 	}
-}
\ No newline at end of file
+}
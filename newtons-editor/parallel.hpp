@@ -0,0 +1,29 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace nwt{
+    // Calls work(begin, end) on about equal ranges of [0, count), one per thread with the last range on the calling
+    // thread. threadCount 0 is one thread per core.
+    template<typename Work>
+    void parallelFor(size_t count, unsigned threadCount, Work work) {
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        const size_t threads = std::min<size_t>(threadCount, count);
+        if (threads <= 1) {
+            work(size_t(0), count);
+            return;
+        }
+
+        std::vector<std::jthread> workers;
+        workers.reserve(threads - 1);
+        for (size_t i = 0; i + 1 < threads; i++) {
+            workers.emplace_back(work, count * i / threads, count * (i + 1) / threads);
+        }
+        work(count * (threads - 1) / threads, count);
+    }
+}
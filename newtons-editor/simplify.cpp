@@ -0,0 +1,588 @@
+#include "simplify.hpp"
+#include "mesh_optimize.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <tuple>
+
+namespace nwt{
+namespace {
+    // Position, texture coordinate and normal, the attributes scaled by their weights
+    constexpr size_t dimension = 8;
+    using Point = std::array<float, dimension>;
+
+    // Border edges count this much more than the surface, so open borders keep their outline
+    constexpr float borderWeight = 10.0f;
+    // A collapse may turn the normal of a triangle it keeps by up to about 75 degrees
+    constexpr float minNormalCosine = 0.25f;
+
+    // Index of row <= column in an upper triangle stored row by row
+    constexpr size_t packedIndex(size_t row, size_t column) {
+        return row * dimension - row * (row - 1) / 2 + column - row;
+    }
+
+    // Weighted squared distance x^T A x + 2 b^T x + c, the symmetric A stored as its upper triangle. The weights are
+    // areas and edge lengths, so the sum is divided by them again to get a distance.
+    struct Quadric{
+        float a[dimension * (dimension + 1) / 2] = {};
+        float b[dimension] = {};
+        float c = 0.0f;
+        float weight = 0.0f;
+
+        Quadric& operator+=(const Quadric& other) {
+            for (size_t i = 0; i < std::size(a); i++) {
+                a[i] += other.a[i];
+            }
+            for (size_t i = 0; i < dimension; i++) {
+                b[i] += other.b[i];
+            }
+            c += other.c;
+            weight += other.weight;
+            return *this;
+        }
+
+        float evaluate(const Point& x) const {
+            // Rounding can take a point on the plane slightly below 0
+            return weight > 0.0f ? std::max(sum(x), 0.0f) / weight : 0.0f;
+        }
+
+        // The weighted sum before dividing by weight, so the quadrics of several vertices can be evaluated as one
+        float sum(const Point& x) const {
+            float result = c;
+            size_t k = 0;
+            for (size_t row = 0; row < dimension; row++) {
+                float rowSum = a[k++] * x[row];
+                for (size_t column = row + 1; column < dimension; column++) {
+                    rowSum += 2.0f * a[k++] * x[column];
+                }
+                result += x[row] * rowSum + 2.0f * b[row] * x[row];
+            }
+            return result;
+        }
+    };
+
+    // Squared distance to the plane of a triangle in all dimensions, A = I - e1 e1^T - e2 e2^T for an orthonormal
+    // basis e1, e2 of the triangle
+    Quadric triangleQuadric(const Point& p0, const Point& p1, const Point& p2, float weight) {
+        double e1[dimension], e2[dimension];
+        double e1Length = 0.0;
+        for (size_t i = 0; i < dimension; i++) {
+            e1[i] = static_cast<double>(p1[i]) - p0[i];
+            e1Length += e1[i] * e1[i];
+        }
+        Quadric quadric;
+        if (e1Length == 0.0) {
+            return quadric;
+        }
+        e1Length = std::sqrt(e1Length);
+        double along = 0.0;
+        for (size_t i = 0; i < dimension; i++) {
+            e1[i] /= e1Length;
+            along += (static_cast<double>(p2[i]) - p0[i]) * e1[i];
+        }
+        double e2Length = 0.0;
+        for (size_t i = 0; i < dimension; i++) {
+            e2[i] = static_cast<double>(p2[i]) - p0[i] - along * e1[i];
+            e2Length += e2[i] * e2[i];
+        }
+        if (e2Length == 0.0) {
+            return quadric;
+        }
+        e2Length = std::sqrt(e2Length);
+
+        double p0e1 = 0.0, p0e2 = 0.0, p0p0 = 0.0;
+        for (size_t i = 0; i < dimension; i++) {
+            e2[i] /= e2Length;
+            p0e1 += p0[i] * e1[i];
+            p0e2 += p0[i] * e2[i];
+            p0p0 += static_cast<double>(p0[i]) * p0[i];
+        }
+
+        size_t k = 0;
+        for (size_t row = 0; row < dimension; row++) {
+            for (size_t column = row; column < dimension; column++) {
+                const double identity = row == column ? 1.0 : 0.0;
+                quadric.a[k++] = static_cast<float>(weight * (identity - e1[row] * e1[column] - e2[row] * e2[column]));
+            }
+            quadric.b[row] = static_cast<float>(weight * (p0e1 * e1[row] + p0e2 * e2[row] - p0[row]));
+        }
+        quadric.c = static_cast<float>(weight * (p0p0 - p0e1 * p0e1 - p0e2 * p0e2));
+        quadric.weight = weight;
+        return quadric;
+    }
+
+    // Squared distance to the plane normal . x + distance = 0 in position space
+    void addPlane(Quadric& quadric, const Vec3& normal, float distance, float weight) {
+        const float n[3] = { normal.x, normal.y, normal.z };
+        for (size_t row = 0; row < 3; row++) {
+            for (size_t column = row; column < 3; column++) {
+                quadric.a[packedIndex(row, column)] += weight * n[row] * n[column];
+            }
+            quadric.b[row] += weight * distance * n[row];
+        }
+        quadric.c += weight * distance * distance;
+        quadric.weight += weight;
+    }
+
+    Vec3 positionOf(const Point& point) {
+        return { point[0], point[1], point[2] };
+    }
+
+    uint64_t edgeKey(uint32_t a, uint32_t b) {
+        return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+    }
+
+    // Undirected edges of the triangles, sorted, and how many triangles use each
+    void collectEdges(const std::vector<uint32_t>& indices, std::vector<uint64_t>& edges, std::vector<uint32_t>& uses) {
+        std::vector<uint64_t> all(indices.size());
+        for (size_t i = 0; i < indices.size(); i++) {
+            all[i] = edgeKey(indices[i], indices[i - i % 3 + (i + 1) % 3]);
+        }
+        std::sort(all.begin(), all.end());
+
+        edges.clear();
+        uses.clear();
+        for (size_t i = 0; i < all.size(); i++) {
+            if (i == 0 || all[i] != all[i - 1]) {
+                edges.push_back(all[i]);
+                uses.push_back(0);
+            }
+            uses.back()++;
+        }
+    }
+
+    // Moves every vertex at the position of corner from onto one at corner to
+    struct Collapse{
+        float cost;
+        uint32_t from;
+        uint32_t to;
+    };
+
+    // Runs of vertices with the same position and texture coordinate, which only differ in their normal. Members are in
+    // ascending order, so the first is the lowest.
+    struct NormalSplits{
+        std::vector<uint32_t> members;
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> runOf;
+    };
+
+    NormalSplits findNormalSplits(std::span<const Vec3Packed> positions, std::span<const Vec2> texCoords) {
+        NormalSplits splits;
+        splits.members.resize(positions.size());
+        splits.runOf.resize(positions.size());
+        std::iota(splits.members.begin(), splits.members.end(), 0);
+        const auto key = [&](uint32_t vertex) {
+            const Vec2 texCoord = texCoords.empty() ? Vec2(0.0f, 0.0f) : texCoords[vertex];
+            return std::make_tuple(positions[vertex].x, positions[vertex].y, positions[vertex].z, texCoord.x, texCoord.y);
+        };
+        std::sort(splits.members.begin(), splits.members.end(), [&](uint32_t a, uint32_t b) { return key(a) < key(b) || (!(key(b) < key(a)) && a < b); });
+        for (size_t i = 0; i < splits.members.size(); i++) {
+            if (i == 0 || key(splits.members[i]) != key(splits.members[i - 1])) {
+                splits.offsets.push_back(static_cast<uint32_t>(i));
+            }
+            splits.runOf[splits.members[i]] = static_cast<uint32_t>(splits.offsets.size() - 1);
+        }
+        splits.offsets.push_back(static_cast<uint32_t>(splits.members.size()));
+        return splits;
+    }
+
+    // The work of simplify, on only the vertices the indices use
+    std::vector<uint32_t> simplifyLocal(std::vector<uint32_t> result, std::span<const Vec3Packed> positions, std::span<const Vec2> texCoords,
+        std::span<const Vec3Packed> normals, size_t targetIndexCount, const SimplifyOptions& options, float& error) {
+        const size_t vertexCount = positions.size();
+
+        Vec3 minimum(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+        Vec3 maximum = -minimum;
+        for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+            minimum = Vec3(std::min(minimum.x, positions[vertex].x), std::min(minimum.y, positions[vertex].y), std::min(minimum.z, positions[vertex].z));
+            maximum = Vec3(std::max(maximum.x, positions[vertex].x), std::max(maximum.y, positions[vertex].y), std::max(maximum.z, positions[vertex].z));
+        }
+        // Working in a unit cube keeps the float quadrics precise and the attribute weights independent of the mesh size
+        const Vec3 extent = maximum - minimum;
+        float scale = std::max({ extent.x, extent.y, extent.z });
+        if (!(scale > 0.0f)) {
+            scale = 1.0f;
+        }
+
+        const bool hasTexCoords = texCoords.size() == vertexCount;
+        const bool hasNormals = normals.size() == vertexCount;
+        std::vector<Point> points(vertexCount);
+        for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+            const Vec3 position = (Vec3(positions[vertex]) - minimum) / scale;
+            const Vec2 texCoord = hasTexCoords ? texCoords[vertex] * options.texCoordWeight : Vec2(0.0f, 0.0f);
+            const Vec3 normal = hasNormals ? Vec3(normals[vertex]) * options.normalWeight : Vec3(0.0f, 0.0f, 0.0f);
+            points[vertex] = { position.x, position.y, position.z, texCoord.x, texCoord.y, normal.x, normal.y, normal.z };
+        }
+
+        // Vertices with the same position are corners of the surface that are split along texture seams or hard edges.
+        // A corner moves as a whole, every one of its vertices onto the vertex of the target corner it shares an edge
+        // with, so the seams move with the surface instead of tearing or holding it in place.
+        std::vector<uint32_t> cornerOf(vertexCount);
+        std::vector<uint32_t> cornerOffsets;
+        std::vector<uint32_t> cornerVertices(vertexCount);
+        {
+            std::iota(cornerVertices.begin(), cornerVertices.end(), 0);
+            const auto key = [&](uint32_t vertex) { return std::tie(positions[vertex].x, positions[vertex].y, positions[vertex].z); };
+            std::sort(cornerVertices.begin(), cornerVertices.end(), [&](uint32_t a, uint32_t b) { return key(a) < key(b) || (!(key(b) < key(a)) && a < b); });
+            for (size_t i = 0; i < vertexCount; i++) {
+                if (i == 0 || key(cornerVertices[i]) != key(cornerVertices[i - 1])) {
+                    cornerOffsets.push_back(static_cast<uint32_t>(i));
+                }
+                cornerOf[cornerVertices[i]] = static_cast<uint32_t>(cornerOffsets.size() - 1);
+            }
+            cornerOffsets.push_back(static_cast<uint32_t>(vertexCount));
+        }
+        const size_t cornerCount = cornerOffsets.size() - 1;
+        std::vector<uint8_t> locked(cornerCount, 0);
+        for (size_t vertex = 0; vertex < options.lockedVertices.size() && vertex < vertexCount; vertex++) {
+            locked[cornerOf[vertex]] |= options.lockedVertices[vertex] != 0;
+        }
+
+        // The quadrics of the vertices rank the collapses with their attributes, those of the corners only measure
+        // how far the surface moves
+        std::vector<Quadric> quadrics(vertexCount);
+        std::vector<Quadric> positionQuadrics(cornerCount);
+        for (size_t i = 0; i < result.size(); i += 3) {
+            const Point& p0 = points[result[i + 0]];
+            const Point& p1 = points[result[i + 1]];
+            const Point& p2 = points[result[i + 2]];
+            const Vec3 normal = Vec3::cross(positionOf(p1) - positionOf(p0), positionOf(p2) - positionOf(p0));
+            const float area = 0.5f * normal.magnitude();
+            const Quadric quadric = triangleQuadric(p0, p1, p2, area);
+            Quadric positionQuadric;
+            if (area > 0.0f) {
+                const Vec3 unitNormal = normal / (2.0f * area);
+                addPlane(positionQuadric, unitNormal, -Vec3::dot(unitNormal, positionOf(p0)), area);
+            }
+            for (size_t corner = 0; corner < 3; corner++) {
+                quadrics[result[i + corner]] += quadric;
+                positionQuadrics[cornerOf[result[i + corner]]] += positionQuadric;
+            }
+        }
+
+        // An open border edge pulls both its vertices towards the plane through it perpendicular to its triangle. Seams
+        // are no border, the vertices on both sides move together.
+        std::vector<uint64_t> edges;
+        std::vector<uint32_t> edgeUses;
+        std::vector<uint32_t> cornerIndices(result.size());
+        for (size_t i = 0; i < result.size(); i++) {
+            cornerIndices[i] = cornerOf[result[i]];
+        }
+        collectEdges(cornerIndices, edges, edgeUses);
+        for (size_t i = 0; i < result.size(); i++) {
+            const uint32_t a = result[i];
+            const uint32_t b = result[i - i % 3 + (i + 1) % 3];
+            const uint32_t opposite = result[i - i % 3 + (i + 2) % 3];
+            const size_t edge = std::lower_bound(edges.begin(), edges.end(), edgeKey(cornerOf[a], cornerOf[b])) - edges.begin();
+            if (edgeUses[edge] != 1) {
+                continue;
+            }
+            const Vec3 pa = positionOf(points[a]);
+            const Vec3 along = positionOf(points[b]) - pa;
+            const Vec3 faceNormal = Vec3::cross(along, positionOf(points[opposite]) - pa);
+            const Vec3 planeNormal = Vec3::cross(along, faceNormal);
+            const float length = planeNormal.magnitude();
+            if (length == 0.0f) {
+                continue;
+            }
+            const Vec3 unitNormal = planeNormal / length;
+            const float weight = borderWeight * along.sqrMagnitude();
+            addPlane(quadrics[a], unitNormal, -Vec3::dot(unitNormal, pa), weight);
+            addPlane(quadrics[b], unitNormal, -Vec3::dot(unitNormal, pa), weight);
+            addPlane(positionQuadrics[cornerOf[a]], unitNormal, -Vec3::dot(unitNormal, pa), weight);
+            addPlane(positionQuadrics[cornerOf[b]], unitNormal, -Vec3::dot(unitNormal, pa), weight);
+        }
+
+        const size_t targetTriangles = targetIndexCount / 3;
+        const float maxCost = options.maxError < std::numeric_limits<float>::max() ? (options.maxError / scale) * (options.maxError / scale) : std::numeric_limits<float>::max();
+        float largestCost = 0.0f;
+
+        std::vector<uint32_t> borderEdgeCounts(cornerCount);
+        std::vector<uint32_t> triangleOffsets(vertexCount + 1);
+        std::vector<uint32_t> vertexTriangles;
+        std::vector<uint8_t> touched(cornerCount);
+        std::vector<uint32_t> remap(vertexCount);
+        std::vector<Collapse> collapses;
+        std::vector<std::pair<uint32_t, uint32_t>> moves;
+
+        // Each pass collapses the cheapest edges that don't share a neighbourhood with one collapsed before in the pass,
+        // then rebuilds the connectivity from the new triangles
+        size_t triangleCount = result.size() / 3;
+        while (triangleCount > targetTriangles) {
+            std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+            for (const uint32_t index : result) {
+                triangleOffsets[index + 1]++;
+            }
+            for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+                triangleOffsets[vertex + 1] += triangleOffsets[vertex];
+            }
+            vertexTriangles.resize(result.size());
+            {
+                std::vector<uint32_t> next(triangleOffsets.begin(), triangleOffsets.end() - 1);
+                for (size_t i = 0; i < result.size(); i++) {
+                    vertexTriangles[next[result[i]]++] = static_cast<uint32_t>(i / 3);
+                }
+            }
+
+            // Pairs every vertex of corner from that still has triangles with the one vertex of corner to it shares
+            // edges with. Fails if a vertex has none, then it would have to take attributes from across a seam, or
+            // several, then its triangles would stay connected to to in two places.
+            const auto findMoves = [&](uint32_t from, uint32_t to) {
+                moves.clear();
+                for (uint32_t i = cornerOffsets[from]; i < cornerOffsets[from + 1]; i++) {
+                    const uint32_t vertex = cornerVertices[i];
+                    if (triangleOffsets[vertex] == triangleOffsets[vertex + 1]) {
+                        continue;
+                    }
+                    uint32_t target = ~0u;
+                    for (uint32_t t = triangleOffsets[vertex]; t < triangleOffsets[vertex + 1]; t++) {
+                        for (size_t corner = 0; corner < 3; corner++) {
+                            const uint32_t other = result[3 * static_cast<size_t>(vertexTriangles[t]) + corner];
+                            if (cornerOf[other] != to || other == target) {
+                                continue;
+                            }
+                            if (target != ~0u) {
+                                return false;
+                            }
+                            target = other;
+                        }
+                    }
+                    if (target == ~0u) {
+                        return false;
+                    }
+                    moves.push_back({ vertex, target });
+                }
+                return !moves.empty();
+            };
+            const auto collapseCost = [&](uint32_t from, uint32_t to) {
+                if (!findMoves(from, to)) {
+                    return std::numeric_limits<float>::infinity();
+                }
+                float sum = 0.0f;
+                float weight = 0.0f;
+                for (const auto& [vertex, target] : moves) {
+                    sum += quadrics[vertex].sum(points[target]);
+                    weight += quadrics[vertex].weight;
+                }
+                return weight > 0.0f ? std::max(sum, 0.0f) / weight : 0.0f;
+            };
+            const auto positionCost = [&](uint32_t from, uint32_t to) {
+                return positionQuadrics[from].evaluate(points[cornerVertices[cornerOffsets[to]]]);
+            };
+
+            for (size_t i = 0; i < result.size(); i++) {
+                cornerIndices[i] = cornerOf[result[i]];
+            }
+            collectEdges(cornerIndices, edges, edgeUses);
+            std::fill(borderEdgeCounts.begin(), borderEdgeCounts.end(), 0);
+            for (size_t edge = 0; edge < edges.size(); edge++) {
+                if (edgeUses[edge] == 1) {
+                    borderEdgeCounts[edges[edge] >> 32]++;
+                    borderEdgeCounts[edges[edge] & 0xffffffff]++;
+                }
+            }
+
+            // An interior corner may move along any edge, a border corner only along its border, and a corner where
+            // more than two border edges meet is a junction that has to stay
+            const auto canMove = [&](uint32_t corner, bool borderEdge) {
+                if (locked[corner]) {
+                    return false;
+                }
+                return borderEdgeCounts[corner] == 0 || (!options.lockBorder && borderEdgeCounts[corner] == 2 && borderEdge);
+            };
+            collapses.clear();
+            for (size_t edge = 0; edge < edges.size(); edge++) {
+                const uint32_t a = static_cast<uint32_t>(edges[edge] >> 32);
+                const uint32_t b = static_cast<uint32_t>(edges[edge] & 0xffffffff);
+                if (a == b) {
+                    continue;
+                }
+                const bool borderEdge = edgeUses[edge] == 1;
+                const float costAB = canMove(a, borderEdge) && positionCost(a, b) <= maxCost ? collapseCost(a, b) : std::numeric_limits<float>::infinity();
+                const float costBA = canMove(b, borderEdge) && positionCost(b, a) <= maxCost ? collapseCost(b, a) : std::numeric_limits<float>::infinity();
+                if (costAB <= costBA && costAB < std::numeric_limits<float>::infinity()) {
+                    collapses.push_back({ costAB, a, b });
+                }
+                else if (costBA < costAB) {
+                    collapses.push_back({ costBA, b, a });
+                }
+            }
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+            std::fill(touched.begin(), touched.end(), 0);
+            std::iota(remap.begin(), remap.end(), 0);
+            // Collapses further down the list are rejected or touch earlier ones, so a pass can't reach the goal with the
+            // cost it would take if none were skipped. Going past it by half ends the pass, the next one ranks again.
+            const size_t passGoal = triangleCount - targetTriangles;
+            const size_t goalCollapse = std::min((passGoal + 1) / 2, collapses.size() - 1);
+            const float passCostLimit = collapses.empty() ? 0.0f : 1.5f * collapses[goalCollapse].cost;
+            size_t removedTriangles = 0;
+            for (const Collapse& collapse : collapses) {
+                if (removedTriangles >= passGoal || (collapse.cost > passCostLimit && removedTriangles > 0)) {
+                    break;
+                }
+                if (touched[collapse.from] || touched[collapse.to]) {
+                    continue;
+                }
+                findMoves(collapse.from, collapse.to);
+
+                // Triangles that keep existing must not turn over or collapse to a sliver
+                const Vec3 destination = positionOf(points[moves.front().second]);
+                bool flips = false;
+                size_t removed = 0;
+                for (size_t move = 0; move < moves.size() && !flips; move++) {
+                    const uint32_t vertex = moves[move].first;
+                    for (uint32_t i = triangleOffsets[vertex]; i < triangleOffsets[vertex + 1] && !flips; i++) {
+                        const uint32_t* corners = &result[3 * static_cast<size_t>(vertexTriangles[i])];
+                        Vec3 p[3], moved[3];
+                        bool collapsed = false;
+                        for (size_t corner = 0; corner < 3; corner++) {
+                            collapsed |= cornerOf[corners[corner]] == collapse.to;
+                            p[corner] = positionOf(points[corners[corner]]);
+                            moved[corner] = cornerOf[corners[corner]] == collapse.from ? destination : p[corner];
+                        }
+                        if (collapsed) {
+                            removed++;
+                            continue;
+                        }
+                        const Vec3 before = Vec3::cross(p[1] - p[0], p[2] - p[0]);
+                        const Vec3 after = Vec3::cross(moved[1] - moved[0], moved[2] - moved[0]);
+                        const float beforeLength = before.magnitude();
+                        flips = beforeLength > 0.0f && Vec3::dot(before, after) <= minNormalCosine * beforeLength * after.magnitude();
+                    }
+                }
+                if (flips) {
+                    continue;
+                }
+
+                touched[collapse.from] = touched[collapse.to] = 1;
+                for (const auto& [vertex, target] : moves) {
+                    remap[vertex] = target;
+                    quadrics[target] += quadrics[vertex];
+                    for (uint32_t i = triangleOffsets[vertex]; i < triangleOffsets[vertex + 1]; i++) {
+                        for (size_t corner = 0; corner < 3; corner++) {
+                            touched[cornerOf[result[3 * static_cast<size_t>(vertexTriangles[i]) + corner]]] = 1;
+                        }
+                    }
+                }
+                largestCost = std::max(largestCost, positionCost(collapse.from, collapse.to));
+                positionQuadrics[collapse.to] += positionQuadrics[collapse.from];
+                removedTriangles += removed;
+            }
+            if (removedTriangles == 0) {
+                break;
+            }
+
+            // Triangles with two corners at one position are gone, even if their vertices differ
+            size_t write = 0;
+            for (size_t i = 0; i < result.size(); i += 3) {
+                const uint32_t a = remap[result[i + 0]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+                if (cornerOf[a] != cornerOf[b] && cornerOf[b] != cornerOf[c] && cornerOf[a] != cornerOf[c]) {
+                    result[write++] = a;
+                    result[write++] = b;
+                    result[write++] = c;
+                }
+            }
+            result.resize(write);
+            triangleCount = write / 3;
+        }
+
+        error = std::sqrt(largestCost) * scale;
+        return result;
+    }
+}
+
+std::vector<uint32_t> simplify(std::span<const uint32_t> indices, std::span<const Vec3Packed> positions, std::span<const Vec2> texCoords,
+    std::span<const Vec3Packed> normals, size_t targetIndexCount, const SimplifyOptions& options, float& error) {
+    error = 0.0f;
+    const std::span<const uint32_t> triangles = indices.first(indices.size() - indices.size() % 3);
+    if (triangles.size() <= targetIndexCount) {
+        return std::vector<uint32_t>(triangles.begin(), triangles.end());
+    }
+
+    // All scratch is per vertex, so it works on the vertices the indices use rather than the whole buffer they index
+    LocalVertices local = compactVertices(triangles);
+    const std::vector<Vec3Packed> localPositions = local.gather(positions);
+    const std::vector<Vec2> localTexCoords = texCoords.size() == positions.size() ? local.gather(texCoords) : std::vector<Vec2>();
+    std::vector<Vec3Packed> localNormals = normals.size() == positions.size() ? local.gather(normals) : std::vector<Vec3Packed>();
+    std::vector<uint8_t> localLocked;
+    if (!options.lockedVertices.empty()) {
+        localLocked.resize(local.vertices.size());
+        for (size_t vertex = 0; vertex < local.vertices.size(); vertex++) {
+            localLocked[vertex] = local.vertices[vertex] < options.lockedVertices.size() && options.lockedVertices[local.vertices[vertex]];
+        }
+    }
+
+    // The sides of a hard edge are simplified as one vertex with their average normal, so flat shaded meshes reduce as
+    // far as smooth ones. Every triangle left takes the side whose normal is closest to its own.
+    NormalSplits splits;
+    if (!localNormals.empty()) {
+        splits = findNormalSplits(localPositions, localTexCoords);
+        for (size_t run = 0; run + 1 < splits.offsets.size(); run++) {
+            const uint32_t first = splits.members[splits.offsets[run]];
+            Vec3 sum(0.0f, 0.0f, 0.0f);
+            for (uint32_t i = splits.offsets[run]; i < splits.offsets[run + 1]; i++) {
+                const Vec3 normal = localNormals[splits.members[i]];
+                const float length = normal.magnitude();
+                sum += length > 0.0f ? normal / length : normal;
+                if (!localLocked.empty()) {
+                    localLocked[first] |= localLocked[splits.members[i]];
+                }
+            }
+            const float length = sum.magnitude();
+            localNormals[first] = length > 0.0f ? Vec3Packed(sum / length) : Vec3Packed(localNormals[first]);
+        }
+        for (uint32_t& index : local.indices) {
+            index = splits.members[splits.offsets[splits.runOf[index]]];
+        }
+    }
+    SimplifyOptions localOptions = options;
+    localOptions.lockedVertices = localLocked;
+
+    std::vector<uint32_t> result = simplifyLocal(std::move(local.indices), localPositions, localTexCoords, localNormals, targetIndexCount, localOptions, error);
+    if (!splits.offsets.empty()) {
+        for (size_t i = 0; i < result.size(); i += 3) {
+            const Vec3 p0 = localPositions[result[i + 0]];
+            const Vec3 faceNormal = Vec3::cross(Vec3(localPositions[result[i + 1]]) - p0, Vec3(localPositions[result[i + 2]]) - p0);
+            for (size_t corner = 0; corner < 3; corner++) {
+                const uint32_t run = splits.runOf[result[i + corner]];
+                float best = -std::numeric_limits<float>::infinity();
+                for (uint32_t member = splits.offsets[run]; member < splits.offsets[run + 1]; member++) {
+                    const Vec3 normal = normals[local.vertices[splits.members[member]]];
+                    const float length = normal.magnitude();
+                    const float alignment = length > 0.0f ? Vec3::dot(normal, faceNormal) / length : -std::numeric_limits<float>::max();
+                    if (alignment > best) {
+                        best = alignment;
+                        result[i + corner] = splits.members[member];
+                    }
+                }
+            }
+        }
+    }
+    for (uint32_t& index : result) {
+        index = local.vertices[index];
+    }
+    return result;
+}
+
+std::vector<LodLevel> buildLodChain(std::span<const uint32_t> indices, std::span<const Vec3Packed> positions, std::span<const Vec2> texCoords,
+    std::span<const Vec3Packed> normals, std::span<const float> ratios, const SimplifyOptions& options) {
+    std::vector<LodLevel> chain;
+    for (const float ratio : ratios) {
+        const std::span<const uint32_t> previous = chain.empty() ? indices : std::span<const uint32_t>(chain.back().indices);
+        const float previousError = chain.empty() ? 0.0f : chain.back().error;
+        const size_t targetIndexCount = static_cast<size_t>(static_cast<double>(indices.size() / 3) * ratio) * 3;
+
+        float levelError;
+        std::vector<uint32_t> level = simplify(previous, positions, texCoords, normals, targetIndexCount, options, levelError);
+        if (previous.size() <= targetIndexCount || (previous.size() - level.size()) * 4 < previous.size() - targetIndexCount) {
+            break;
+        }
+        // The quadrics start over from each level, so the deviations from the full mesh add up at most
+        chain.push_back({ std::move(level), previousError + levelError });
+    }
+    return chain;
+}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "vec2.hpp"
+#include "vec3.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace nwt{
+    struct SimplifyOptions{
+        // Scale of texture coordinate and normal differences against position differences, with the mesh scaled to fit
+        // a unit cube. Higher weights keep texture seams and shading in place at the cost of shape. Normals are off by
+        // default: those of flat shaded meshes jump at every edge, which costs far more shape than it saves shading.
+        float texCoordWeight = 1.0f;
+        float normalWeight = 0.0f;
+        // Keeps every vertex on an open border, so the mesh still fits against whatever it touches there
+        bool lockBorder = false;
+        // No collapse moves the surface further than this, in mesh units
+        float maxError = std::numeric_limits<float>::max();
+        // Nonzero for vertices that must stay, indexed by vertex. May be empty.
+        std::span<const uint8_t> lockedVertices;
+    };
+
+    // Simplifies a triangle list towards targetIndexCount indices with quadric error metrics (Garland and Heckbert,
+    // extended to texture coordinates and normals in their 1998 paper). Every collapse moves a vertex onto a neighbour
+    // along an edge, so the result indexes the same vertices and can share their buffer. Vertices with the same
+    // position but different attributes, along texture seams, move together onto the vertices on the same side of the
+    // seam, so the surface neither tears nor stays in place there. Vertices that only differ in their normal, the sides
+    // of hard edges, are simplified as one, and each triangle left uses the side whose normal is closest to its own.
+    // texCoords and normals may be empty. error gets how far the surface moved at most in mesh units, the attribute
+    // differences only decide which collapses go first.
+    std::vector<uint32_t> simplify(std::span<const uint32_t> indices, std::span<const Vec3Packed> positions, std::span<const Vec2> texCoords,
+        std::span<const Vec3Packed> normals, size_t targetIndexCount, const SimplifyOptions& options, float& error);
+
+    struct LodLevel{
+        std::vector<uint32_t> indices;
+        // How far the surface is from the full mesh at most in mesh units, see simplify
+        float error;
+    };
+
+    // Simplifies to every ratio of the full index count in turn, largest ratio first, each level from the one before.
+    // The chain stops at a level that gets less than a quarter of the way from the level before to its target, which
+    // would be stored at almost the same size.
+    std::vector<LodLevel> buildLodChain(std::span<const uint32_t> indices, std::span<const Vec3Packed> positions, std::span<const Vec2> texCoords,
+        std::span<const Vec3Packed> normals, std::span<const float> ratios, const SimplifyOptions& options);
+}
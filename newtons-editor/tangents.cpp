@@ -0,0 +1,186 @@
+#include "tangents.hpp"
+#include "mathf.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+namespace nwt{
+namespace {
+    // Below this a thread costs more than the triangles or vertices it takes over
+    constexpr size_t minItemsPerThread = 4096;
+
+    enum class Winding : uint8_t{
+        // No texture area, the corner adds nothing and stays with the vertex it uses
+        Degenerate,
+        Preserved,
+        Mirrored,
+    };
+
+    Vec3 projectOntoPlane(const Vec3& v, const Vec3& normal) {
+        return v - normal * Vec3::dot(normal, v);
+    }
+
+    Vec3 normalizedOrZero(const Vec3& v) {
+        const float length = v.magnitude();
+        return length > 0.0f ? v / length : Vec3(0.0f, 0.0f, 0.0f);
+    }
+
+    // Some unit vector in the plane of normal, for vertices whose triangles all lack texture area
+    Vec3 anyPerpendicular(const Vec3& normal) {
+        const Vec3 axis = std::abs(normal.x) < 0.9f ? Vec3(1.0f, 0.0f, 0.0f) : Vec3(0.0f, 1.0f, 0.0f);
+        return normalizedOrZero(projectOntoPlane(axis, normal));
+    }
+
+    uint32_t packSnorm(float value, float max, uint32_t bits, uint32_t shift) {
+        const int32_t snorm = static_cast<int32_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * max));
+        return (static_cast<uint32_t>(snorm) & ((1u << bits) - 1)) << shift;
+    }
+
+    float unpackSnorm(uint32_t packed, float max, uint32_t bits, uint32_t shift) {
+        // Moving the field to the top bits and shifting it back sign extends it
+        const int32_t snorm = static_cast<int32_t>(packed << (32 - bits - shift)) >> (32 - bits);
+        return std::max(static_cast<float>(snorm) / max, -1.0f);
+    }
+
+    unsigned threadsFor(size_t count, unsigned threadCount) {
+        return static_cast<unsigned>(std::clamp<size_t>(count / minItemsPerThread, 1, threadCount));
+    }
+}
+
+uint32_t packSnorm1010102(const Vec3& xyz, float w) {
+    return packSnorm(xyz.x, 511.0f, 10, 0) | packSnorm(xyz.y, 511.0f, 10, 10) | packSnorm(xyz.z, 511.0f, 10, 20) | packSnorm(w, 1.0f, 2, 30);
+}
+
+Vec4 unpackSnorm1010102(uint32_t packed) {
+    return { unpackSnorm(packed, 511.0f, 10, 0), unpackSnorm(packed, 511.0f, 10, 10), unpackSnorm(packed, 511.0f, 10, 20), unpackSnorm(packed, 1.0f, 2, 30) };
+}
+
+TangentSpace generateTangents(std::span<const Vec3Packed> positions, std::span<const Vec3Packed> normals, std::span<const Vec2> texCoords,
+    std::span<uint32_t> indices, unsigned threadCount) {
+    if (normals.size() != positions.size() || texCoords.size() != positions.size()) {
+        throw std::runtime_error("Generating tangents needs a normal and a texture coordinate for every vertex");
+    }
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const size_t vertexCount = positions.size();
+    const size_t triangleCount = indices.size() / 3;
+    const size_t cornerCount = 3 * triangleCount;
+
+    // Every corner gets its triangle's u direction in the plane of the corner's normal, times the corner angle
+    std::vector<Vec3Packed> cornerTangents(cornerCount);
+    std::vector<Winding> cornerWindings(cornerCount);
+    parallelFor(triangleCount, threadsFor(triangleCount, threadCount), [&](size_t begin, size_t end) {
+        for (size_t triangle = begin; triangle < end; triangle++) {
+            const uint32_t* corners = &indices[3 * triangle];
+            const Vec3 p[3] = { positions[corners[0]], positions[corners[1]], positions[corners[2]] };
+            const Vec2 s1 = texCoords[corners[1]] - texCoords[corners[0]];
+            const Vec2 s2 = texCoords[corners[2]] - texCoords[corners[0]];
+            const float signedArea = s1.x * s2.y - s1.y * s2.x;
+
+            Winding winding = Winding::Degenerate;
+            if (std::abs(signedArea) > std::numeric_limits<float>::min()) {
+                winding = signedArea > 0.0f ? Winding::Preserved : Winding::Mirrored;
+            }
+            // Solving the edges for the change along u gives this direction, scaled by the signed texture area
+            const Vec3 uDirection = ((p[1] - p[0]) * s2.y - (p[2] - p[0]) * s1.y) * (signedArea < 0.0f ? -1.0f : 1.0f);
+
+            for (size_t corner = 0; corner < 3; corner++) {
+                const size_t cornerIndex = 3 * triangle + corner;
+                cornerWindings[cornerIndex] = winding;
+                if (winding == Winding::Degenerate) {
+                    cornerTangents[cornerIndex] = Vec3Packed(0.0f, 0.0f, 0.0f);
+                    continue;
+                }
+
+                // Like MikkTSpace the angle is measured between the edges projected into the normal's plane. atan2 of
+                // their cross and dot products needs neither edge normalized.
+                const Vec3 normal = normals[corners[corner]];
+                const Vec3 toNext = projectOntoPlane(p[(corner + 1) % 3] - p[corner], normal);
+                const Vec3 toPrevious = projectOntoPlane(p[(corner + 2) % 3] - p[corner], normal);
+                const float angle = Mathf::fastAtan2(Vec3::cross(toNext, toPrevious).magnitude(), Vec3::dot(toNext, toPrevious));
+                cornerTangents[cornerIndex] = normalizedOrZero(projectOntoPlane(uDirection, normal)) * angle;
+            }
+        }
+    });
+
+    // Corners of vertex v are vertexCorners[cornerOffsets[v]] up to vertexCorners[cornerOffsets[v + 1]]
+    std::vector<uint32_t> cornerOffsets(vertexCount + 1, 0);
+    for (size_t corner = 0; corner < cornerCount; corner++) {
+        cornerOffsets[indices[corner] + 1]++;
+    }
+    std::partial_sum(cornerOffsets.begin(), cornerOffsets.end(), cornerOffsets.begin());
+    std::vector<uint32_t> vertexCorners(cornerCount);
+    {
+        std::vector<uint32_t> next(cornerOffsets.begin(), cornerOffsets.end() - 1);
+        for (size_t corner = 0; corner < cornerCount; corner++) {
+            vertexCorners[next[indices[corner]]++] = static_cast<uint32_t>(corner);
+        }
+    }
+
+    const unsigned vertexThreads = threadsFor(vertexCount, threadCount);
+    const auto windingsAround = [&](size_t vertex, bool& preserved, bool& mirrored) {
+        preserved = mirrored = false;
+        for (uint32_t i = cornerOffsets[vertex]; i < cornerOffsets[vertex + 1]; i++) {
+            preserved |= cornerWindings[vertexCorners[i]] == Winding::Preserved;
+            mirrored |= cornerWindings[vertexCorners[i]] == Winding::Mirrored;
+        }
+    };
+
+    // The copy of a split vertex, 0 where the vertex isn't split since every copy comes after the original vertices
+    std::vector<uint32_t> splitCopies(vertexCount);
+    parallelFor(vertexCount, vertexThreads, [&](size_t begin, size_t end) {
+        for (size_t vertex = begin; vertex < end; vertex++) {
+            bool preserved, mirrored;
+            windingsAround(vertex, preserved, mirrored);
+            splitCopies[vertex] = preserved && mirrored;
+        }
+    });
+    TangentSpace result;
+    for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+        if (splitCopies[vertex]) {
+            splitCopies[vertex] = static_cast<uint32_t>(vertexCount + result.splitVertices.size());
+            result.splitVertices.push_back(static_cast<uint32_t>(vertex));
+        }
+    }
+
+    // Every corner belongs to one vertex, so the threads rewrite disjoint indices
+    result.tangents.resize(vertexCount + result.splitVertices.size());
+    parallelFor(vertexCount, vertexThreads, [&](size_t begin, size_t end) {
+        for (size_t vertex = begin; vertex < end; vertex++) {
+            Vec3 sums[3] = {};
+            for (uint32_t i = cornerOffsets[vertex]; i < cornerOffsets[vertex + 1]; i++) {
+                sums[static_cast<size_t>(cornerWindings[vertexCorners[i]])] += cornerTangents[vertexCorners[i]];
+            }
+            const Vec3 normal = normals[vertex];
+            const auto pack = [&](const Vec3& sum, float sign) {
+                const Vec3 tangent = normalizedOrZero(sum);
+                return packSnorm1010102(tangent.sqrMagnitude() > 0.0f ? tangent : anyPerpendicular(normal), sign);
+            };
+
+            const Vec3& preservedSum = sums[static_cast<size_t>(Winding::Preserved)];
+            const Vec3& mirroredSum = sums[static_cast<size_t>(Winding::Mirrored)];
+            if (const uint32_t copy = splitCopies[vertex]) {
+                result.tangents[vertex] = pack(preservedSum, 1.0f);
+                result.tangents[copy] = pack(mirroredSum, -1.0f);
+                for (uint32_t i = cornerOffsets[vertex]; i < cornerOffsets[vertex + 1]; i++) {
+                    if (cornerWindings[vertexCorners[i]] == Winding::Mirrored) {
+                        indices[vertexCorners[i]] = copy;
+                    }
+                }
+            }
+            else {
+                bool preserved, mirrored;
+                windingsAround(vertex, preserved, mirrored);
+                result.tangents[vertex] = pack(preservedSum + mirroredSum, mirrored ? -1.0f : 1.0f);
+            }
+        }
+    });
+    return result;
+}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "vec2.hpp"
+#include "vec3.hpp"
+#include "vec4.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace nwt{
+    // Packs a unit vector into xyz and -1, 0 or 1 into w as 10:10:10:2 snorm, the bit layout of
+    // VK_FORMAT_A2B10G10R10_SNORM_PACK32 with x in the low bits
+    uint32_t packSnorm1010102(const Vec3& xyz, float w);
+    Vec4 unpackSnorm1010102(uint32_t packed);
+
+    struct TangentSpace{
+        // One packed tangent per vertex including the split ones, w is the bitangent sign:
+        // bitangent = w * cross(normal, tangent)
+        std::vector<uint32_t> tangents;
+        // Vertex count + i is a copy of vertex splitVertices[i], made where triangles with mirrored texture coordinates
+        // meet triangles without, since a vertex can only have one bitangent sign
+        std::vector<uint32_t> splitVertices;
+    };
+
+    // Generates tangents the way MikkTSpace does for an indexed mesh: each corner adds its triangle's texture u direction,
+    // projected into the plane of the vertex normal and weighted by the corner angle, and the bitangent sign follows the
+    // winding of the triangle in texture space. Triangles without texture area only take the tangent of their neighbours.
+    // The triangles are split across threadCount threads (0 is one per core), then the vertices. The corners of the
+    // mirrored triangles at a split vertex are rewritten in indices to point at the copy.
+    TangentSpace generateTangents(std::span<const Vec3Packed> positions, std::span<const Vec3Packed> normals, std::span<const Vec2> texCoords,
+        std::span<uint32_t> indices, unsigned threadCount = 0);
+}
@@ -0,0 +1,150 @@
+#include <catch2/catch_test_macros.hpp>
+#include "mesh_cache.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace nwt;
+
+namespace {
+    // A grid of quads split between two materials, with texture coordinates for the tangent frames
+    std::string gridObj(int size) {
+        std::string text;
+        for (int y = 0; y <= size; y++) {
+            for (int x = 0; x <= size; x++) {
+                text += "v " + std::to_string(x) + " " + std::to_string(y) + " " + std::to_string((x * y) % 3) + "\n";
+                text += "vt " + std::to_string(x / double(size)) + " " + std::to_string(y / double(size)) + "\n";
+            }
+        }
+        for (int y = 0; y < size; y++) {
+            text += y == 0 ? "usemtl floor\n" : y == size / 2 ? "usemtl wall\n" : "";
+            for (int x = 0; x < size; x++) {
+                const int a = y * (size + 1) + x + 1, b = a + 1, c = a + size + 1, d = c + 1;
+                const auto corner = [](int index) { return " " + std::to_string(index) + "/" + std::to_string(index); };
+                text += "f" + corner(a) + corner(b) + corner(d) + corner(c) + "\n";
+            }
+        }
+        return text;
+    }
+
+    void writeText(const std::filesystem::path& path, const std::string& text) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    }
+
+    // What MeshCache::load does before writing the cache
+    MeshData importMesh(const std::filesystem::path& path, const MeshImportOptions& options) {
+        MeshData mesh = importObj(path);
+        if (options.tangents) {
+            generateTangentFrames(mesh);
+        }
+        generateLods(mesh, options.lodRatios);
+        optimizeMesh(mesh);
+        generateMeshlets(mesh);
+        return mesh;
+    }
+
+    template<typename T>
+    bool sameBytes(std::span<const T> a, std::span<const T> b) {
+        return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size_bytes()) == 0;
+    }
+
+    // A directory of its own for every test case, removed again at the end
+    struct TemporaryDirectory{
+        std::filesystem::path path;
+
+        explicit TemporaryDirectory(const char* name)
+            : path(std::filesystem::temp_directory_path() / name) {
+            std::filesystem::remove_all(path);
+            std::filesystem::create_directories(path);
+        }
+        ~TemporaryDirectory() {
+            std::error_code error;
+            std::filesystem::remove_all(path, error);
+        }
+    };
+}
+
+TEST_CASE( "A written mesh cache opens with the same arrays", "[mesh_cache]" ) {
+    const TemporaryDirectory directory("nwt-mesh-cache-roundtrip");
+    const std::filesystem::path objPath = directory.path / "grid.obj";
+    const std::filesystem::path cachePath = directory.path / "grid.nmesh";
+    writeText(objPath, gridObj(24));
+
+    MeshImportOptions options;
+    options.tangents = true;
+    const MeshData mesh = importMesh(objPath, options);
+    REQUIRE(mesh.subMeshes.size() > 2);
+    REQUIRE(!mesh.tangentFrames.empty());
+    REQUIRE(!mesh.meshlets.empty());
+    MeshCache::write(cachePath, mesh, AssetSource::fromFile(objPath), options);
+
+    const std::unique_ptr<MeshCache> cache = MeshCache::open(cachePath, objPath, options);
+    REQUIRE(cache != nullptr);
+    REQUIRE(sameBytes(cache->vertices(), std::span<const Vertex>(mesh.vertices)));
+    REQUIRE(sameBytes(cache->indices(), std::span<const uint32_t>(mesh.indices)));
+    REQUIRE(sameBytes(cache->tangentFrames(), std::span<const TangentFrame>(mesh.tangentFrames)));
+    REQUIRE(sameBytes(cache->lods(), std::span<const MeshLod>(mesh.lods)));
+    REQUIRE(sameBytes(cache->meshlets(), std::span<const Meshlet>(mesh.meshlets)));
+    REQUIRE(sameBytes(cache->meshletVertices(), std::span<const uint32_t>(mesh.meshletVertices)));
+    REQUIRE(sameBytes(cache->meshletTriangles(), std::span<const uint8_t>(mesh.meshletTriangles)));
+
+    REQUIRE(cache->subMeshes().size() == mesh.subMeshes.size());
+    for (size_t i = 0; i < mesh.subMeshes.size(); i++) {
+        const SubMesh& read = cache->subMeshes()[i];
+        const SubMesh& written = mesh.subMeshes[i];
+        REQUIRE(read.material == written.material);
+        REQUIRE(read.firstIndex == written.firstIndex);
+        REQUIRE(read.indexCount == written.indexCount);
+        REQUIRE(read.firstMeshlet == written.firstMeshlet);
+        REQUIRE(read.meshletCount == written.meshletCount);
+    }
+}
+
+TEST_CASE( "Stale, truncated and differently imported mesh caches are rejected", "[mesh_cache]" ) {
+    const TemporaryDirectory directory("nwt-mesh-cache-rejected");
+    const std::filesystem::path objPath = directory.path / "grid.obj";
+    const std::filesystem::path cachePath = directory.path / "grid.nmesh";
+    const std::string text = gridObj(12);
+    writeText(objPath, text);
+
+    const MeshImportOptions options;
+    MeshCache::write(cachePath, importMesh(objPath, options), AssetSource::fromFile(objPath), options);
+    REQUIRE(MeshCache::open(cachePath, objPath, options) != nullptr);
+
+    // Other import options
+    MeshImportOptions withTangents;
+    withTangents.tangents = true;
+    REQUIRE(MeshCache::open(cachePath, objPath, withTangents) == nullptr);
+    const float otherRatios[] = { 0.5f, 0.2f };
+    MeshImportOptions otherLods;
+    otherLods.lodRatios = otherRatios;
+    REQUIRE(MeshCache::open(cachePath, objPath, otherLods) == nullptr);
+
+    // A cut off file, from losing only its last byte to keeping only part of the header
+    const std::filesystem::path truncatedPath = directory.path / "truncated.nmesh";
+    const uintmax_t size = std::filesystem::file_size(cachePath);
+    for (const uintmax_t truncatedSize : { size - 1, size / 2, uintmax_t(sizeof(MeshCacheHeader)), uintmax_t(16) }) {
+        std::filesystem::copy_file(cachePath, truncatedPath, std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::resize_file(truncatedPath, truncatedSize);
+        REQUIRE(MeshCache::open(truncatedPath, objPath, options) == nullptr);
+    }
+
+    // A source of the same size with another modification time is hashed, one of another size is stale right away
+    const std::filesystem::file_time_type modified = std::filesystem::last_write_time(objPath);
+    std::string sameSize = text;
+    sameSize.replace(sameSize.find("v 0 0 0"), 7, "v 0 0 1");
+    writeText(objPath, sameSize);
+    std::filesystem::last_write_time(objPath, modified + std::chrono::seconds(2));
+    REQUIRE(MeshCache::open(cachePath, objPath, options) == nullptr);
+    writeText(objPath, text + "v 0 0 0\n");
+    REQUIRE(MeshCache::open(cachePath, objPath, options) == nullptr);
+
+    // Restoring the source with a new modification time keeps the cache, its hash still matches
+    writeText(objPath, text);
+    std::filesystem::last_write_time(objPath, modified + std::chrono::seconds(4));
+    REQUIRE(MeshCache::open(cachePath, objPath, options) != nullptr);
+}
@@ -0,0 +1,76 @@
+#include <catch2/catch_test_macros.hpp>
+#include "mesh.hpp"
+
+#include <cmath>
+#include <numbers>
+
+using namespace nwt;
+
+namespace {
+    bool near(const Vec3& a, const Vec3& b, float tolerance) {
+        return std::abs(a.x - b.x) <= tolerance && std::abs(a.y - b.y) <= tolerance && std::abs(a.z - b.z) <= tolerance;
+    }
+
+    // A grid of size by size quads in the xy plane with a bump in z, large enough to be split across threads
+    Mesh bumpyGrid(uint32_t size) {
+        std::vector<Vec3Packed> vertices;
+        std::vector<uint32_t> indices;
+        for (uint32_t y = 0; y <= size; y++) {
+            for (uint32_t x = 0; x <= size; x++) {
+                vertices.emplace_back(float(x), float(y), std::sin(0.3f * float(x)) * std::cos(0.2f * float(y)));
+            }
+        }
+        for (uint32_t y = 0; y < size; y++) {
+            for (uint32_t x = 0; x < size; x++) {
+                const uint32_t a = y * (size + 1) + x, b = a + 1, c = a + size + 1, d = c + 1;
+                indices.insert(indices.end(), { a, b, d, a, d, c });
+            }
+        }
+        return Mesh(vertices, indices);
+    }
+}
+
+TEST_CASE( "Normals are weighted by triangle area and corner angle", "[mesh]" ) {
+    // A right triangle in the xy plane and one twice its area in the xz plane, sharing the edge from 0 to 1. Both
+    // corners at vertex 0 are right angles, at vertex 1 they are 45 degrees and atan(2).
+    Mesh mesh({ { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 2.0f } }, { 0, 1, 2, 0, 3, 1 });
+    mesh.recalculateNormals();
+    REQUIRE(mesh.normals.size() == 4);
+
+    const float pi = std::numbers::pi_v<float>;
+    // Each triangle adds its normal, whose length is twice its area, times the corner's angle
+    const Vec3 expected[] = {
+        Vec3::normalize(Vec3(0.0f, 0.0f, 1.0f) * (pi / 2) + Vec3(0.0f, 2.0f, 0.0f) * (pi / 2)),
+        Vec3::normalize(Vec3(0.0f, 0.0f, 1.0f) * (pi / 4) + Vec3(0.0f, 2.0f, 0.0f) * std::atan(2.0f)),
+        Vec3(0.0f, 0.0f, 1.0f),
+        Vec3(0.0f, 1.0f, 0.0f),
+    };
+    for (size_t vertex = 0; vertex < 4; vertex++) {
+        REQUIRE(near(mesh.normals[vertex], expected[vertex], 1e-5f));
+    }
+}
+
+TEST_CASE( "Recalculating the normals of moved vertices matches a full recalculation", "[mesh]" ) {
+    Mesh mesh = bumpyGrid(128);
+    mesh.recalculateNormals();
+
+    // Both single vertices and a patch, including corners and edges of the grid
+    std::vector<uint32_t> dirty = { 0, 128, 129 * 129 - 1, 129 * 64 + 64 };
+    for (uint32_t y = 20; y < 30; y++) {
+        for (uint32_t x = 40; x < 50; x++) {
+            dirty.push_back(y * 129 + x);
+        }
+    }
+    for (int round = 0; round < 2; round++) {
+        for (const uint32_t vertex : dirty) {
+            mesh.vertices[vertex].z += 0.5f + 0.25f * float(vertex % 3);
+        }
+        mesh.recalculateNormals(dirty);
+
+        Mesh full(mesh.vertices, mesh.indices);
+        full.recalculateNormals();
+        for (size_t vertex = 0; vertex < mesh.vertices.size(); vertex++) {
+            REQUIRE(near(mesh.normals[vertex], full.normals[vertex], 1e-5f));
+        }
+    }
+}
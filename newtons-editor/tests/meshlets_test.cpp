@@ -0,0 +1,96 @@
+#include <catch2/catch_test_macros.hpp>
+#include "meshlets.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace nwt;
+
+namespace {
+    struct Grid{
+        std::vector<Vec3Packed> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    // A grid of size by size quads facing +z, folded into hills so the meshlets face different ways
+    Grid hillyGrid(uint32_t size) {
+        Grid grid;
+        for (uint32_t y = 0; y <= size; y++) {
+            for (uint32_t x = 0; x <= size; x++) {
+                grid.positions.emplace_back(float(x), float(y), 4.0f * std::sin(0.25f * float(x)) * std::cos(0.2f * float(y)));
+            }
+        }
+        for (uint32_t y = 0; y < size; y++) {
+            for (uint32_t x = 0; x < size; x++) {
+                const uint32_t a = y * (size + 1) + x, b = a + 1, c = a + size + 1, d = c + 1;
+                grid.indices.insert(grid.indices.end(), { a, b, d, a, d, c });
+            }
+        }
+        return grid;
+    }
+}
+
+TEST_CASE( "Meshlets stay within their limits and reproduce the index ranges", "[meshlets]" ) {
+    Grid grid = hillyGrid(40);
+    const std::vector<uint32_t> original = grid.indices;
+    const Meshlets meshlets = buildMeshlets(grid.indices, grid.positions);
+    REQUIRE(!meshlets.meshlets.empty());
+
+    uint32_t nextIndex = 0;
+    for (const Meshlet& meshlet : meshlets.meshlets) {
+        REQUIRE(meshlet.vertexCount <= maxMeshletVertices);
+        REQUIRE(meshlet.triangleCount > 0);
+        REQUIRE(meshlet.triangleCount <= maxMeshletTriangles);
+        // The meshlets cover the index buffer in order without gaps
+        REQUIRE(meshlet.firstIndex == nextIndex);
+        nextIndex += 3 * meshlet.triangleCount;
+
+        for (uint32_t corner = 0; corner < 3 * meshlet.triangleCount; corner++) {
+            const uint8_t local = meshlets.triangles[3 * static_cast<size_t>(meshlet.triangleOffset) + corner];
+            REQUIRE(local < meshlet.vertexCount);
+            REQUIRE(meshlets.vertices[meshlet.vertexOffset + local] == grid.indices[meshlet.firstIndex + corner]);
+        }
+    }
+    REQUIRE(nextIndex == grid.indices.size());
+
+    // Only the order of the triangles changed
+    std::vector<uint32_t> sortedOriginal = original, sortedIndices = grid.indices;
+    std::sort(sortedOriginal.begin(), sortedOriginal.end());
+    std::sort(sortedIndices.begin(), sortedIndices.end());
+    REQUIRE(sortedIndices == sortedOriginal);
+}
+
+TEST_CASE( "Meshlet bounds hold every vertex and cull no visible triangle", "[meshlets]" ) {
+    Grid grid = hillyGrid(40);
+    const Meshlets meshlets = buildMeshlets(grid.indices, grid.positions);
+
+    for (const Meshlet& meshlet : meshlets.meshlets) {
+        for (uint32_t vertex = 0; vertex < meshlet.vertexCount; vertex++) {
+            const Vec3 position = grid.positions[meshlets.vertices[meshlet.vertexOffset + vertex]];
+            REQUIRE((position - Vec3(meshlet.center)).magnitude() <= meshlet.radius * 1.0001f + 1e-5f);
+        }
+    }
+
+    // Cameras all around the grid, near enough for the cones to matter and far above and below it
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> coordinate(-60.0f, 100.0f);
+    size_t culled = 0;
+    for (int camera = 0; camera < 200; camera++) {
+        const Vec3 cameraPosition(coordinate(random), coordinate(random), coordinate(random) - 20.0f);
+        for (const Meshlet& meshlet : meshlets.meshlets) {
+            if (!isBackfacing(meshlet, cameraPosition)) {
+                continue;
+            }
+            culled++;
+            for (uint32_t triangle = 0; triangle < meshlet.triangleCount; triangle++) {
+                const uint32_t* corners = grid.indices.data() + meshlet.firstIndex + 3 * triangle;
+                const Vec3 p0 = grid.positions[corners[0]], p1 = grid.positions[corners[1]], p2 = grid.positions[corners[2]];
+                const Vec3 normal = Vec3::cross(p1 - p0, p2 - p0);
+                REQUIRE(Vec3::dot(normal, cameraPosition - p0) <= 0.0f);
+            }
+        }
+    }
+    // The test is conservative, not useless
+    REQUIRE(culled > 0);
+}
@@ -0,0 +1,256 @@
+#include <catch2/catch_test_macros.hpp>
+#include "obj_reader.hpp"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+    // Rows of 6 vertices joined by quads, alternating between absolute and negative indices, with every 7th row
+    // joined by one 12 sided polygon instead. withGroups switches objects, groups and materials on the way, revisiting
+    // earlier names so the groups have to be merged.
+    std::string generatedObj(bool withGroups) {
+        std::string text = withGroups ? "mtllib scene.mtl\n" : "";
+        const char* materials[] = { "stone", "wood", "stone", "metal" };
+        int count = 0;
+        for (int row = 0; row < 40; row++) {
+            if (withGroups && row % 5 == 0) {
+                text += "o part" + std::to_string(row / 10) + "\n";
+            }
+            if (withGroups && row % 4 == 2) {
+                text += "g side" + std::to_string(row % 3) + "\n";
+            }
+            if (withGroups && row % 3 == 0) {
+                text += "usemtl " + std::string(materials[row % 4]) + "\n";
+            }
+            for (int i = 0; i < 6; i++) {
+                text += "v " + std::to_string(i) + " " + std::to_string(row) + " " + std::to_string(0.25 * (i * row % 7)) + "\n";
+                text += "vt " + std::to_string(i / 5.0) + " " + std::to_string(row / 40.0) + "\n";
+                text += "vn 0 " + std::to_string(0.1 * i) + " 1\n";
+            }
+            count += 6;
+            if (row == 0) {
+                continue;
+            }
+
+            // 1 based indices of the previous and this row, and their negative form
+            const auto previous = [&](int i) { return count - 11 + i; };
+            const auto current = [&](int i) { return count - 5 + i; };
+            const auto corner = [&](int index, bool negative) {
+                const std::string value = std::to_string(negative ? index - count - 1 : index);
+                return " " + value + "/" + value + "/" + value;
+            };
+            if (row % 7 == 0) {
+                text += "f";
+                for (int i = 0; i < 6; i++) {
+                    text += corner(previous(i), false);
+                }
+                for (int i = 5; i >= 0; i--) {
+                    text += corner(current(i), true);
+                }
+                text += "\n";
+                continue;
+            }
+            for (int i = 0; i < 5; i++) {
+                const bool negative = i % 2 == 1;
+                text += "f" + corner(previous(i), negative) + corner(previous(i + 1), negative) + corner(current(i + 1), negative)
+                    + corner(current(i), negative) + "\n";
+            }
+        }
+        return text;
+    }
+
+    bool sameIndex(const obj::Index& a, const obj::Index& b) {
+        return a.vertex_index == b.vertex_index && a.tex_coord_index == b.tex_coord_index && a.normal_index == b.normal_index;
+    }
+
+    bool sameObject(const obj::Object& a, const obj::Object& b) {
+        if (a.vertices != b.vertices || a.normals != b.normals || a.tex_coords != b.tex_coords
+            || a.material_libraries != b.material_libraries || a.indices.size() != b.indices.size() || a.groups.size() != b.groups.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.indices.size(); i++) {
+            if (!sameIndex(a.indices[i], b.indices[i])) {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < a.groups.size(); i++) {
+            const obj::Group& x = a.groups[i];
+            const obj::Group& y = b.groups[i];
+            if (x.object != y.object || x.group != y.group || x.material != y.material || x.first_index != y.first_index || x.index_count != y.index_count) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Line of the ParseError text throws, 0 when it parses
+    size_t errorLine(const std::string& text, bool parallel) {
+        try {
+            obj::Object object;
+            if (parallel) {
+                obj::ParseObjParallel(text, object, 8, 64);
+            }
+            else {
+                obj::ParseObj(text, object);
+            }
+        }
+        catch (const obj::ParseError& error) {
+            return error.line;
+        }
+        return 0;
+    }
+
+    // Twice the signed area of a triangle in the xy plane
+    float twiceArea(const obj::Object& object, const obj::Index* corners) {
+        const auto x = [&](size_t corner) { return object.vertices[3 * corners[corner].vertex_index + 0]; };
+        const auto y = [&](size_t corner) { return object.vertices[3 * corners[corner].vertex_index + 1]; };
+        return (x(1) - x(0)) * (y(2) - y(0)) - (y(1) - y(0)) * (x(2) - x(0));
+    }
+}
+
+TEST_CASE( "Parsing in small chunks matches parsing serially", "[obj]" ) {
+    for (const bool withGroups : { false, true }) {
+        const std::string text = generatedObj(withGroups);
+        obj::Object serial;
+        obj::ParseObj(text, serial);
+        REQUIRE(!serial.indices.empty());
+
+        // Chunks of at least 64 bytes split the text at many places, inside runs of faces and between names
+        for (const unsigned threadCount : { 2u, 3u, 8u, 16u }) {
+            obj::Object parallel;
+            obj::ParseObjParallel(text, parallel, threadCount, 64);
+            REQUIRE(sameObject(parallel, serial));
+        }
+    }
+}
+
+TEST_CASE( "Parse errors report their line across chunk borders", "[obj]" ) {
+    const std::string text = generatedObj(true);
+    std::vector<size_t> lineStarts = { 0 };
+    for (size_t i = 0; i + 1 < text.size(); i++) {
+        if (text[i] == '\n') {
+            lineStarts.push_back(i + 1);
+        }
+    }
+
+    // Malformed numbers fail while a chunk is parsed, indices out of range only once the chunks are resolved
+    const char* errors[] = { "v 1 x 2", "f 1 2 100000", "f -100000 1 2", "f 1 2" };
+    for (size_t line = 1; line <= lineStarts.size(); line += 13) {
+        for (const char* error : errors) {
+            const size_t start = lineStarts[line - 1];
+            const size_t end = text.find('\n', start);
+            std::string broken = text;
+            broken.replace(start, end - start, error);
+            REQUIRE(errorLine(broken, false) == line);
+            REQUIRE(errorLine(broken, true) == line);
+        }
+    }
+}
+
+TEST_CASE( "Streamed batches hold the triangles of a full parse", "[obj]" ) {
+    const std::string text = generatedObj(false);
+    obj::Object object;
+    obj::ParseObj(text, object);
+
+    std::vector<obj::Triangle> streamed;
+    std::vector<size_t> batchSizes;
+    obj::StreamObj(text, 7, [&](std::span<const obj::Triangle> batch) {
+        batchSizes.push_back(batch.size());
+        streamed.insert(streamed.end(), batch.begin(), batch.end());
+    });
+
+    // Every batch is full but the last
+    REQUIRE(!batchSizes.empty());
+    for (size_t i = 0; i + 1 < batchSizes.size(); i++) {
+        REQUIRE(batchSizes[i] == 7);
+    }
+    REQUIRE(batchSizes.back() >= 1);
+    REQUIRE(batchSizes.back() <= 7);
+
+    REQUIRE(3 * streamed.size() == object.indices.size());
+    for (size_t i = 0; i < object.indices.size(); i++) {
+        const obj::Index& index = object.indices[i];
+        const obj::TriangleVertex& vertex = streamed[i / 3].vertices[i % 3];
+        for (size_t axis = 0; axis < 3; axis++) {
+            REQUIRE(vertex.position[axis] == object.vertices[3 * index.vertex_index + axis]);
+            REQUIRE(vertex.normal[axis] == object.normals[3 * index.normal_index + axis]);
+        }
+        for (size_t axis = 0; axis < 2; axis++) {
+            REQUIRE(vertex.tex_coord[axis] == object.tex_coords[2 * index.tex_coord_index + axis]);
+        }
+    }
+}
+
+TEST_CASE( "Groups with the same material are adjacent ranges", "[obj]" ) {
+    const std::string text =
+        "mtllib a.mtl\n"
+        "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+        "o box\n"
+        "usemtl red\nf 1 2 3\n"
+        "usemtl blue\nf 1 3 4\n"
+        "usemtl red\nf 4 3 2\n"
+        "g side\nf 1 2 4\n";
+    obj::Object object;
+    obj::ParseObj(text, object);
+
+    // red comes first, its two ranges without a group are merged, the one in side follows before blue
+    REQUIRE(object.material_libraries == std::vector<std::string>{ "a.mtl" });
+    REQUIRE(object.groups.size() == 3);
+    const struct { const char* group; const char* material; size_t first; size_t count; } expected[] = {
+        { "", "red", 0, 6 }, { "side", "red", 6, 3 }, { "", "blue", 9, 3 },
+    };
+    for (size_t i = 0; i < 3; i++) {
+        REQUIRE(object.groups[i].object == "box");
+        REQUIRE(object.groups[i].group == expected[i].group);
+        REQUIRE(object.groups[i].material == expected[i].material);
+        REQUIRE(object.groups[i].first_index == expected[i].first);
+        REQUIRE(object.groups[i].index_count == expected[i].count);
+    }
+
+    const size_t vertices[] = { 0, 1, 2, 3, 2, 1, 0, 1, 3, 0, 2, 3 };
+    REQUIRE(object.indices.size() == 12);
+    for (size_t i = 0; i < 12; i++) {
+        REQUIRE(object.indices[i].vertex_index == vertices[i]);
+    }
+}
+
+TEST_CASE( "Negative indices count back from the last element", "[obj]" ) {
+    const std::string text =
+        "v 0 0 0\nv 1 0 0\nv 0 1 0\n"
+        "f -3 -2 -1\n"
+        "v 5 5 5\nvt 0.5 0.5\nvn 0 0 1\n"
+        "f -4/-1/-1 -3/-1/-1 -1/-1/-1\n";
+    obj::Object object;
+    obj::ParseObj(text, object);
+
+    const obj::Index expected[] = {
+        { 0, obj::Index::none, obj::Index::none }, { 1, obj::Index::none, obj::Index::none }, { 2, obj::Index::none, obj::Index::none },
+        { 0, 0, 0 }, { 1, 0, 0 }, { 3, 0, 0 },
+    };
+    REQUIRE(object.indices.size() == 6);
+    for (size_t i = 0; i < 6; i++) {
+        REQUIRE(sameIndex(object.indices[i], expected[i]));
+    }
+
+    REQUIRE(errorLine("v 0 0 0\nv 1 0 0\nf -3 -2 -1\n", false) == 3);
+}
+
+TEST_CASE( "Concave polygons are ear clipped", "[obj]" ) {
+    // A U shape, the fan from its first corner would cross the notch
+    const std::string text =
+        "v 0 0 0\nv 3 0 0\nv 3 3 0\nv 2 3 0\nv 2 1 0\nv 1 1 0\nv 1 3 0\nv 0 3 0\n"
+        "f 1 2 3 4 5 6 7 8\n";
+    obj::Object object;
+    obj::ParseObj(text, object);
+
+    REQUIRE(object.indices.size() == 3 * 6);
+    float area = 0.0f;
+    for (size_t i = 0; i < object.indices.size(); i += 3) {
+        // Every triangle keeps the polygon's counterclockwise winding and lies inside it
+        const float triangleArea = twiceArea(object, &object.indices[i]);
+        REQUIRE(triangleArea > 0.0f);
+        area += triangleArea;
+    }
+    REQUIRE(std::abs(area - 2.0f * 7.0f) < 1e-4f);
+}
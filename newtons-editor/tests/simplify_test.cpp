@@ -0,0 +1,41 @@
+#include <catch2/catch_test_macros.hpp>
+#include "mesh_cache.hpp"
+
+#include <algorithm>
+
+using namespace nwt;
+
+namespace {
+    size_t lodIndexCount(const MeshData& mesh, const MeshLod& lod) {
+        size_t count = 0;
+        for (uint32_t subMesh = lod.firstSubMesh; subMesh < lod.firstSubMesh + lod.subMeshCount; subMesh++) {
+            count += mesh.subMeshes[subMesh].indexCount;
+        }
+        return count;
+    }
+}
+
+TEST_CASE( "Levels of detail of a flat shaded model reach their ratios", "[simplify]" ) {
+    // The viking room has texture seams and hard edges at most of its positions
+    MeshData mesh = importObj(NWT_TEST_MODELS_DIR "/viking_room.obj");
+    REQUIRE(mesh.normals.size() == mesh.vertices.size());
+    const size_t fullIndexCount = mesh.indices.size();
+    generateLods(mesh);
+
+    Vec3 minimum = mesh.vertices[0].pos, maximum = mesh.vertices[0].pos;
+    for (const Vertex& vertex : mesh.vertices) {
+        minimum = Vec3(std::min(minimum.x, vertex.pos.x), std::min(minimum.y, vertex.pos.y), std::min(minimum.z, vertex.pos.z));
+        maximum = Vec3(std::max(maximum.x, vertex.pos.x), std::max(maximum.y, vertex.pos.y), std::max(maximum.z, vertex.pos.z));
+    }
+    const float size = (maximum - minimum).magnitude();
+
+    REQUIRE(mesh.lods.size() == std::size(defaultLodRatios) + 1);
+    for (size_t level = 1; level < mesh.lods.size(); level++) {
+        const double ratio = static_cast<double>(lodIndexCount(mesh, mesh.lods[level])) / fullIndexCount;
+        REQUIRE(ratio <= defaultLodRatios[level - 1] + 0.01);
+        REQUIRE(mesh.lods[level].error >= mesh.lods[level - 1].error);
+    }
+    // The error is the distance the surface moved, a few percent of the model's size for a tenth of its triangles
+    REQUIRE(mesh.lods[1].error < 0.02f * size);
+    REQUIRE(mesh.lods.back().error < 0.1f * size);
+}
@@ -0,0 +1,201 @@
+#include <catch2/catch_test_macros.hpp>
+#include "texture.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace nwt;
+
+namespace {
+    // Smooth gradients with a sharp edged disc and a band of fine stripes, alpha falls off towards the corners
+    TextureLevel testImage(uint32_t width, uint32_t height) {
+        TextureLevel level{ width, height, std::vector<uint8_t>(size_t(width) * height * 4) };
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                uint8_t* pixel = &level.data[(size_t(y) * width + x) * 4];
+                const float dx = float(x) - width / 2.0f, dy = float(y) - height / 2.0f;
+                const bool disc = dx * dx + dy * dy < width * height / 16.0f;
+                pixel[0] = static_cast<uint8_t>(disc ? 230 : x * 255 / width);
+                pixel[1] = static_cast<uint8_t>(disc ? 40 : y * 255 / height);
+                pixel[2] = static_cast<uint8_t>(y > height * 3 / 4 && x % 4 < 2 ? 200 : (x + y) * 127 / (width + height));
+                pixel[3] = static_cast<uint8_t>(255 - std::min(255.0f, std::sqrt(dx * dx + dy * dy) * 3.0f));
+            }
+        }
+        return level;
+    }
+
+    using Pixels = uint8_t[16][4];
+
+    uint8_t expand(uint32_t value, uint32_t bits) {
+        return static_cast<uint8_t>(value << (8 - bits) | value >> (2 * bits - 8));
+    }
+
+    // BC1 as in the format's specification, both the 4 color and the 3 color mode
+    void decodeBC1(const uint8_t* block, Pixels& out) {
+        const uint16_t color0 = uint16_t(block[0] | block[1] << 8), color1 = uint16_t(block[2] | block[3] << 8);
+        int palette[4][3];
+        for (size_t e = 0; e < 2; e++) {
+            const uint16_t color = e == 0 ? color0 : color1;
+            palette[e][0] = expand(color >> 11, 5);
+            palette[e][1] = expand(color >> 5 & 63, 6);
+            palette[e][2] = expand(color & 31, 5);
+        }
+        for (size_t c = 0; c < 3; c++) {
+            if (color0 > color1) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            else {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+        const uint32_t indices = uint32_t(block[4] | block[5] << 8 | block[6] << 16 | uint32_t(block[7]) << 24);
+        for (size_t i = 0; i < 16; i++) {
+            const uint32_t index = indices >> (2 * i) & 3;
+            out[i][0] = uint8_t(palette[index][0]);
+            out[i][1] = uint8_t(palette[index][1]);
+            out[i][2] = uint8_t(palette[index][2]);
+            out[i][3] = index == 3 && color0 <= color1 ? 0 : 255;
+        }
+    }
+
+    // BC7 mode 6, the only mode the encoder writes. Returns false for a block in any other mode.
+    bool decodeBC7Mode6(const uint8_t* block, Pixels& out) {
+        size_t position = 0;
+        const auto read = [&](size_t bits) {
+            uint32_t value = 0;
+            for (size_t i = 0; i < bits; i++, position++) {
+                value |= uint32_t(block[position / 8] >> (position % 8) & 1) << i;
+            }
+            return value;
+        };
+        if (read(7) != 1 << 6) {
+            return false;
+        }
+        uint32_t endpoints[2][4];
+        for (size_t c = 0; c < 4; c++) {
+            endpoints[0][c] = read(7);
+            endpoints[1][c] = read(7);
+        }
+        const uint32_t pBits[2] = { read(1), read(1) };
+        static constexpr uint32_t weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+        for (size_t i = 0; i < 16; i++) {
+            const uint32_t index = read(i == 0 ? 3 : 4);
+            for (size_t c = 0; c < 4; c++) {
+                const uint32_t e0 = endpoints[0][c] << 1 | pBits[0], e1 = endpoints[1][c] << 1 | pBits[1];
+                out[i][c] = uint8_t(((64 - weights[index]) * e0 + weights[index] * e1 + 32) >> 6);
+            }
+        }
+        return true;
+    }
+
+    // Peak signal to noise ratio in dB over the first channels of every pixel
+    float psnr(const TextureLevel& image, TextureFormat format, const std::vector<uint8_t>& encoded, size_t channels) {
+        const uint32_t blocksX = (image.width + 3) / 4, blocksY = (image.height + 3) / 4;
+        double squaredError = 0.0;
+        for (uint32_t blockY = 0; blockY < blocksY; blockY++) {
+            for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+                const size_t blockIndex = size_t(blockY) * blocksX + blockX;
+                Pixels decoded;
+                if (format == TextureFormat::BC1) {
+                    decodeBC1(&encoded[blockIndex * 8], decoded);
+                }
+                else if (!decodeBC7Mode6(&encoded[blockIndex * 16], decoded)) {
+                    return 0.0f;
+                }
+                for (uint32_t i = 0; i < 16; i++) {
+                    const uint32_t x = blockX * 4 + i % 4, y = blockY * 4 + i / 4;
+                    if (x >= image.width || y >= image.height) {
+                        continue;
+                    }
+                    for (size_t c = 0; c < channels; c++) {
+                        const double difference = double(decoded[i][c]) - image.data[(size_t(y) * image.width + x) * 4 + c];
+                        squaredError += difference * difference;
+                    }
+                }
+            }
+        }
+        const double meanSquaredError = squaredError / (double(image.width) * image.height * channels);
+        return meanSquaredError == 0.0 ? 100.0f : float(10.0 * std::log10(255.0 * 255.0 / meanSquaredError));
+    }
+
+    void overwrite(const std::filesystem::path& path, size_t offset, const void* data, size_t size) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+}
+
+TEST_CASE( "BC1 and BC7 blocks decode close to their source", "[texture]" ) {
+    // Not a multiple of 4, so the last row and column of blocks are padded
+    const TextureLevel image = testImage(70, 66);
+
+    const std::vector<uint8_t> bc1 = encodeLevel(image, TextureFormat::BC1, 3);
+    REQUIRE(bc1.size() == levelSize(TextureFormat::BC1, image.width, image.height));
+    // The floors sit a little under what the encoders reach, the disc's edge costs both of them the most
+    REQUIRE(psnr(image, TextureFormat::BC1, bc1, 3) > 34.0f);
+
+    const std::vector<uint8_t> bc7 = encodeLevel(image, TextureFormat::BC7, 3);
+    REQUIRE(bc7.size() == levelSize(TextureFormat::BC7, image.width, image.height));
+    REQUIRE(psnr(image, TextureFormat::BC7, bc7, 4) > 36.0f);
+    REQUIRE(psnr(image, TextureFormat::BC7, bc7, 3) > psnr(image, TextureFormat::BC1, bc1, 3));
+}
+
+TEST_CASE( "Texture caches with a broken level index are rejected", "[texture]" ) {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "nwt-texture-cache";
+    std::filesystem::create_directories(directory);
+    const std::filesystem::path path = directory / "image.ntex";
+    const std::filesystem::path broken = directory / "broken.ntex";
+    // A missing source never makes the cache stale
+    const std::filesystem::path source = directory / "missing.png";
+
+    const TextureLevel image = testImage(40, 24);
+    TextureData texture{ TextureFormat::BC1, true, buildMipChain(image.data.data(), image.width, image.height, true) };
+    for (TextureLevel& level : texture.levels) {
+        level.data = encodeLevel(level, texture.format, 1);
+    }
+    TextureCache::write(path, texture, AssetSource{ 0, 0, 0 });
+
+    const std::unique_ptr<TextureCache> cache = TextureCache::open(path, source, TextureFormat::BC1);
+    REQUIRE(cache != nullptr);
+    REQUIRE(cache->levels().size() == 6);
+    REQUIRE(TextureCache::open(path, source, TextureFormat::BC7) == nullptr);
+
+    TextureCacheLevel levels[6];
+    std::ifstream(path, std::ios::binary).seekg(sizeof(TextureCacheHeader)).read(reinterpret_cast<char*>(levels), sizeof(levels));
+    const auto levelEntry = [](size_t i) { return sizeof(TextureCacheHeader) + i * sizeof(TextureCacheLevel); };
+    const auto rejects = [&](size_t offset, const void* data, size_t size) {
+        std::filesystem::copy_file(path, broken, std::filesystem::copy_options::overwrite_existing);
+        overwrite(broken, offset, data, size);
+        return TextureCache::open(broken, source, TextureFormat::BC1) == nullptr;
+    };
+
+    // The data of two levels in the wrong order, each still inside the file
+    TextureCacheLevel swapped[2] = { levels[1], levels[2] };
+    std::swap(swapped[0].offset, swapped[1].offset);
+    REQUIRE(rejects(levelEntry(1), swapped, sizeof(swapped)));
+
+    // A level overlapping the one before
+    TextureCacheLevel overlapping = levels[3];
+    overlapping.offset = levels[2].offset;
+    REQUIRE(rejects(levelEntry(3), &overlapping, sizeof(overlapping)));
+
+    // A level of another size with a matching byte count, 10x6 and 12x8 both take 3x2 BC1 blocks
+    REQUIRE(levels[2].width == 10);
+    REQUIRE(levels[2].height == 6);
+    TextureCacheLevel resized = levels[2];
+    resized.width = 12;
+    resized.height = 8;
+    REQUIRE(levelSize(TextureFormat::BC1, 12, 8) == levels[2].size);
+    REQUIRE(rejects(levelEntry(2), &resized, sizeof(resized)));
+
+    // A header whose size disagrees with the base level
+    TextureCacheHeader header = cache->header();
+    header.width = 44;
+    REQUIRE(rejects(0, &header, sizeof(header)));
+
+    std::filesystem::remove_all(directory);
+}
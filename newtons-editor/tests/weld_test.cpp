@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+#include "weld.hpp"
+
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+using namespace nwt;
+
+namespace {
+    // A grid of quads with both triangles repeating their shared corners, corners shared by neighbouring quads, and
+    // corners that differ from another one only in the last bit or the sign of zero
+    std::vector<Vertex> weldFixture() {
+        std::vector<Vertex> corners;
+        const auto corner = [](float x, float y) {
+            Vertex vertex{};
+            vertex.pos = { x, y, 0.0f };
+            vertex.color = { 1.0f, 1.0f, 1.0f };
+            vertex.texCoord = { x / 64.0f, y / 64.0f };
+            return vertex;
+        };
+        for (int y = 0; y < 64; y++) {
+            for (int x = 0; x < 64; x++) {
+                const Vertex a = corner(float(x), float(y)), b = corner(float(x + 1), float(y));
+                const Vertex c = corner(float(x), float(y + 1)), d = corner(float(x + 1), float(y + 1));
+                corners.insert(corners.end(), { a, b, d, a, d, c });
+            }
+        }
+        for (size_t i = 0; i < corners.size(); i += 7) {
+            Vertex near = corners[i];
+            near.pos.x = std::nextafter(near.pos.x, 1000.0f);
+            corners.push_back(near);
+            Vertex negativeZero = corners[i];
+            negativeZero.pos.z = -0.0f;
+            corners.push_back(negativeZero);
+        }
+        return corners;
+    }
+
+    // The welding weldVertices replaced, kept to check that sorting gives the same result
+    void weldWithHashMap(std::span<const Vertex> corners, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        std::unordered_map<Vertex, uint32_t> uniqueVertices;
+        for (const Vertex& corner : corners) {
+            const auto [it, inserted] = uniqueVertices.try_emplace(corner, static_cast<uint32_t>(vertices.size()));
+            if (inserted) {
+                vertices.push_back(corner);
+            }
+            indices.push_back(it->second);
+        }
+    }
+}
+
+TEST_CASE( "Welding without tolerances matches welding with a hash map", "[weld]" ) {
+    const std::vector<Vertex> corners = weldFixture();
+    std::vector<Vertex> expectedVertices;
+    std::vector<uint32_t> expectedIndices;
+    weldWithHashMap(corners, expectedVertices, expectedIndices);
+
+    for (const unsigned threadCount : { 1u, 4u }) {
+        WeldOptions options;
+        options.threadCount = threadCount;
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        weldVertices(corners, options, vertices, indices);
+
+        REQUIRE(vertices.size() == expectedVertices.size());
+        REQUIRE(vertices == expectedVertices);
+        REQUIRE(indices == expectedIndices);
+    }
+}
+
+TEST_CASE( "Welding with a tolerance snaps to a grid", "[weld]" ) {
+    const auto corner = [](float x) {
+        Vertex vertex{};
+        vertex.pos = { x, 0.0f, 0.0f };
+        return vertex;
+    };
+    WeldOptions options;
+    options.positionTolerance = 1.0f;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+
+    // 0.45 and 0.55 are closer than the tolerance but lie in the cells of 0 and 1, 0.55 and 1.45 are further apart
+    // but share the cell of 1
+    const Vertex corners[] = { corner(0.45f), corner(0.55f), corner(1.45f) };
+    weldVertices(corners, options, vertices, indices);
+
+    REQUIRE(vertices.size() == 2);
+    REQUIRE(indices == std::vector<uint32_t>{ 0, 1, 1 });
+}
@@ -0,0 +1,635 @@
+#include "texture.hpp"
+#include "parallel.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace nwt{
+namespace {
+    constexpr uint64_t levelAlignment = 16;
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    //
+    // Color space
+    //
+
+    float srgbToLinear(uint8_t value) {
+        static const std::array<float, 256> table = [] {
+            std::array<float, 256> result;
+            for (size_t i = 0; i < result.size(); i++) {
+                const float c = i / 255.0f;
+                result[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            return result;
+        }();
+        return table[value];
+    }
+
+    uint8_t linearToSrgb(float value) {
+        // 4096 steps are finer than the 8 bit output over the whole curve
+        static const std::array<uint8_t, 4096> table = [] {
+            std::array<uint8_t, 4096> result;
+            for (size_t i = 0; i < result.size(); i++) {
+                const float c = i / 4095.0f;
+                const float encoded = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+                result[i] = static_cast<uint8_t>(std::clamp(encoded * 255.0f + 0.5f, 0.0f, 255.0f));
+            }
+            return result;
+        }();
+        return table[static_cast<size_t>(std::clamp(value, 0.0f, 1.0f) * 4095.0f + 0.5f)];
+    }
+
+    //
+    // Block encoding
+    //
+
+    using Block = std::array<std::array<uint8_t, 4>, 16>;
+
+    // Reads the 4x4 block at (blockX, blockY), pixels past the edge repeat the last row or column
+    Block loadBlock(const TextureLevel& level, uint32_t blockX, uint32_t blockY) {
+        Block block;
+        for (uint32_t y = 0; y < 4; y++) {
+            for (uint32_t x = 0; x < 4; x++) {
+                const uint32_t px = std::min(blockX * 4 + x, level.width - 1);
+                const uint32_t py = std::min(blockY * 4 + y, level.height - 1);
+                std::memcpy(block[y * 4 + x].data(), &level.data[(static_cast<size_t>(py) * level.width + px) * 4], 4);
+            }
+        }
+        return block;
+    }
+
+    // Principal axis of the first channels of the block by power iteration on their covariance
+    template<size_t channels>
+    void principalAxis(const Block& block, float (&mean)[channels], float (&axis)[channels]) {
+        for (size_t c = 0; c < channels; c++) {
+            mean[c] = 0;
+            for (const auto& pixel : block) {
+                mean[c] += pixel[c];
+            }
+            mean[c] /= 16.0f;
+        }
+
+        float covariance[channels][channels] = {};
+        for (const auto& pixel : block) {
+            for (size_t i = 0; i < channels; i++) {
+                for (size_t j = 0; j < channels; j++) {
+                    covariance[i][j] += (pixel[i] - mean[i]) * (pixel[j] - mean[j]);
+                }
+            }
+        }
+
+        for (size_t c = 0; c < channels; c++) {
+            axis[c] = 1.0f;
+        }
+        for (int iteration = 0; iteration < 8; iteration++) {
+            float next[channels] = {};
+            float length = 0;
+            for (size_t i = 0; i < channels; i++) {
+                for (size_t j = 0; j < channels; j++) {
+                    next[i] += covariance[i][j] * axis[j];
+                }
+                length = std::max(length, std::abs(next[i]));
+            }
+            // A flat block has no axis, any direction gives the same single color
+            if (length < 1e-6f) {
+                return;
+            }
+            for (size_t c = 0; c < channels; c++) {
+                axis[c] = next[c] / length;
+            }
+        }
+    }
+
+    // Endpoints along the principal axis through the extreme pixels of the block
+    template<size_t channels>
+    void axisEndpoints(const Block& block, float (&first)[channels], float (&second)[channels]) {
+        float mean[channels], axis[channels];
+        principalAxis(block, mean, axis);
+        float minT = 0, maxT = 0, length2 = 0;
+        for (size_t c = 0; c < channels; c++) {
+            length2 += axis[c] * axis[c];
+        }
+        for (const auto& pixel : block) {
+            float t = 0;
+            for (size_t c = 0; c < channels; c++) {
+                t += (pixel[c] - mean[c]) * axis[c];
+            }
+            minT = std::min(minT, t / length2);
+            maxT = std::max(maxT, t / length2);
+        }
+        for (size_t c = 0; c < channels; c++) {
+            first[c] = mean[c] + axis[c] * maxT;
+            second[c] = mean[c] + axis[c] * minT;
+        }
+    }
+
+    uint16_t pack565(const float (&color)[3]) {
+        const auto quantize = [](float value, int max) { return static_cast<uint16_t>(std::clamp(static_cast<int>(value * max / 255.0f + 0.5f), 0, max)); };
+        return static_cast<uint16_t>(quantize(color[0], 31) << 11 | quantize(color[1], 63) << 5 | quantize(color[2], 31));
+    }
+
+    void unpack565(uint16_t packed, int (&color)[3]) {
+        const int r = packed >> 11 & 31, g = packed >> 5 & 63, b = packed & 31;
+        color[0] = r << 3 | r >> 2;
+        color[1] = g << 2 | g >> 4;
+        color[2] = b << 3 | b >> 2;
+    }
+
+    // Picks the closest of the 4 BC1 palette colors for every pixel, returns the squared error
+    int selectColorIndices(const Block& block, uint16_t first, uint16_t second, uint32_t& indices) {
+        int palette[4][3];
+        unpack565(first, palette[0]);
+        unpack565(second, palette[1]);
+        for (size_t c = 0; c < 3; c++) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        indices = 0;
+        int totalError = 0;
+        for (size_t i = 0; i < 16; i++) {
+            int bestError = INT32_MAX;
+            uint32_t best = 0;
+            for (uint32_t p = 0; p < 4; p++) {
+                int error = 0;
+                for (size_t c = 0; c < 3; c++) {
+                    const int difference = block[i][c] - palette[p][c];
+                    error += difference * difference;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    best = p;
+                }
+            }
+            indices |= best << (2 * i);
+            totalError += bestError;
+        }
+        return totalError;
+    }
+
+    // Least squares endpoints for fixed indices, returns false if the indices don't constrain both endpoints
+    bool refineColorEndpoints(const Block& block, uint32_t indices, float (&first)[3], float (&second)[3]) {
+        static constexpr float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+        float aa = 0, ab = 0, bb = 0, ax[3] = {}, bx[3] = {};
+        for (size_t i = 0; i < 16; i++) {
+            const float a = weights[indices >> (2 * i) & 3];
+            const float b = 1.0f - a;
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+            for (size_t c = 0; c < 3; c++) {
+                ax[c] += a * block[i][c];
+                bx[c] += b * block[i][c];
+            }
+        }
+        const float determinant = aa * bb - ab * ab;
+        if (std::abs(determinant) < 1e-6f) {
+            return false;
+        }
+        for (size_t c = 0; c < 3; c++) {
+            first[c] = (bb * ax[c] - ab * bx[c]) / determinant;
+            second[c] = (aa * bx[c] - ab * ax[c]) / determinant;
+        }
+        return true;
+    }
+
+    // BC1 color block, always in 4 color mode so it is also valid as the color half of BC3
+    void encodeColorBlock(const Block& block, uint8_t* out) {
+        float first[3], second[3];
+        axisEndpoints(block, first, second);
+        // Inset the endpoints a little, the extremes are rarely worth a palette entry of their own
+        for (size_t c = 0; c < 3; c++) {
+            const float inset = (first[c] - second[c]) / 16.0f;
+            first[c] -= inset;
+            second[c] += inset;
+        }
+
+        uint16_t color0 = pack565(first), color1 = pack565(second);
+        uint32_t indices;
+        int error = selectColorIndices(block, color0, color1, indices);
+        if (refineColorEndpoints(block, indices, first, second)) {
+            const uint16_t refined0 = pack565(first), refined1 = pack565(second);
+            uint32_t refinedIndices;
+            const int refinedError = selectColorIndices(block, refined0, refined1, refinedIndices);
+            if (refinedError < error) {
+                color0 = refined0;
+                color1 = refined1;
+                indices = refinedIndices;
+                error = refinedError;
+            }
+        }
+
+        // 4 color mode needs color0 > color1, swapping the endpoints swaps index 0 with 1 and 2 with 3
+        if (color0 < color1) {
+            std::swap(color0, color1);
+            indices ^= 0x55555555;
+        }
+        else if (color0 == color1) {
+            indices = 0;
+        }
+
+        std::memcpy(out + 0, &color0, 2);
+        std::memcpy(out + 2, &color1, 2);
+        std::memcpy(out + 4, &indices, 4);
+    }
+
+    // BC4 block of the alpha channel in 8 value mode
+    void encodeAlphaBlock(const Block& block, uint8_t* out) {
+        uint8_t alpha0 = 0, alpha1 = 255;
+        for (const auto& pixel : block) {
+            alpha0 = std::max(alpha0, pixel[3]);
+            alpha1 = std::min(alpha1, pixel[3]);
+        }
+
+        int palette[8] = { alpha0, alpha1 };
+        for (int i = 2; i < 8; i++) {
+            palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1) / 7;
+        }
+
+        uint64_t indices = 0;
+        if (alpha0 != alpha1) {
+            for (size_t i = 0; i < 16; i++) {
+                uint64_t best = 0;
+                for (uint64_t p = 1; p < 8; p++) {
+                    if (std::abs(block[i][3] - palette[p]) < std::abs(block[i][3] - palette[best])) {
+                        best = p;
+                    }
+                }
+                indices |= best << (3 * i);
+            }
+        }
+
+        out[0] = alpha0;
+        out[1] = alpha1;
+        for (size_t i = 0; i < 6; i++) {
+            out[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+        }
+    }
+
+    class BitWriter{
+    public:
+        explicit BitWriter(uint8_t* out) : _out(out) { std::memset(out, 0, 16); }
+
+        void write(uint32_t value, uint32_t bits) {
+            for (uint32_t i = 0; i < bits; i++, _position++) {
+                _out[_position / 8] |= static_cast<uint8_t>((value >> i & 1) << (_position % 8));
+            }
+        }
+
+    private:
+        uint8_t* _out;
+        uint32_t _position = 0;
+    };
+
+    // BC7 mode 6: one subset, 7 bit RGBA endpoints with a p-bit each and 4 bit indices.
+    // Only this mode is used, it suits smooth color gradients and keeps the encoder fast.
+    void encodeBC7Block(const Block& block, uint8_t* out) {
+        static constexpr int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        float first[4], second[4];
+        axisEndpoints(block, first, second);
+
+        int bestError = INT32_MAX;
+        uint32_t bestQuantized[2][4] = {}, bestPBits[2] = {};
+        uint8_t bestIndices[16] = {};
+        // Every p-bit combination is tried, they shift the representable endpoints by one
+        for (uint32_t pBits = 0; pBits < 4; pBits++) {
+            const uint32_t pBit[2] = { pBits & 1, pBits >> 1 };
+            uint32_t quantized[2][4];
+            int endpoints[2][4];
+            for (size_t c = 0; c < 4; c++) {
+                const float values[2] = { first[c], second[c] };
+                for (size_t e = 0; e < 2; e++) {
+                    quantized[e][c] = static_cast<uint32_t>(std::clamp(static_cast<int>((values[e] - pBit[e]) / 2.0f + 0.5f), 0, 127));
+                    endpoints[e][c] = static_cast<int>(quantized[e][c] << 1 | pBit[e]);
+                }
+            }
+
+            int direction[4], length2 = 0;
+            for (size_t c = 0; c < 4; c++) {
+                direction[c] = endpoints[1][c] - endpoints[0][c];
+                length2 += direction[c] * direction[c];
+            }
+
+            int error = 0;
+            uint8_t indices[16];
+            for (size_t i = 0; i < 16; i++) {
+                // Project onto the endpoint segment, then check the neighbours since the weights aren't exactly uniform
+                int dot = 0;
+                for (size_t c = 0; c < 4; c++) {
+                    dot += (block[i][c] - endpoints[0][c]) * direction[c];
+                }
+                const int guess = length2 > 0 ? std::clamp(static_cast<int>(15.0f * dot / length2 + 0.5f), 0, 15) : 0;
+                int pixelError = INT32_MAX;
+                for (int index = std::max(guess - 1, 0); index <= std::min(guess + 1, 15); index++) {
+                    int candidateError = 0;
+                    for (size_t c = 0; c < 4; c++) {
+                        const int value = ((64 - weights[index]) * endpoints[0][c] + weights[index] * endpoints[1][c] + 32) >> 6;
+                        candidateError += (block[i][c] - value) * (block[i][c] - value);
+                    }
+                    if (candidateError < pixelError) {
+                        pixelError = candidateError;
+                        indices[i] = static_cast<uint8_t>(index);
+                    }
+                }
+                error += pixelError;
+            }
+
+            if (error < bestError) {
+                bestError = error;
+                std::memcpy(bestQuantized, quantized, sizeof(quantized));
+                bestPBits[0] = pBit[0];
+                bestPBits[1] = pBit[1];
+                std::memcpy(bestIndices, indices, sizeof(indices));
+            }
+        }
+
+        // The first index is stored with 3 bits, so its top bit has to be 0. Swapping the endpoints inverts the indices.
+        if (bestIndices[0] >= 8) {
+            std::swap(bestQuantized[0], bestQuantized[1]);
+            std::swap(bestPBits[0], bestPBits[1]);
+            for (uint8_t& index : bestIndices) {
+                index = static_cast<uint8_t>(15 - index);
+            }
+        }
+
+        BitWriter writer(out);
+        writer.write(1 << 6, 7);
+        for (size_t c = 0; c < 4; c++) {
+            writer.write(bestQuantized[0][c], 7);
+            writer.write(bestQuantized[1][c], 7);
+        }
+        writer.write(bestPBits[0], 1);
+        writer.write(bestPBits[1], 1);
+        writer.write(bestIndices[0], 3);
+        for (size_t i = 1; i < 16; i++) {
+            writer.write(bestIndices[i], 4);
+        }
+    }
+
+    size_t blockBytes(TextureFormat format) {
+        return format == TextureFormat::BC1 ? 8 : 16;
+    }
+
+    bool isValid(const TextureCacheHeader& header, TextureFormat format) {
+        return std::memcmp(header.magic, TextureCacheHeader::expectedMagic, sizeof(header.magic)) == 0
+            && header.version == TextureCacheHeader::currentVersion
+            && header.format == format
+            && header.levelCount > 0 && header.levelCount <= 32
+            && header.width > 0 && header.height > 0;
+    }
+
+    // Reads the level index, returns false unless it is the mip chain of the header's size, base level first, with every
+    // level inside the file and after the one before
+    bool readLevels(const MappedFile& file, const TextureCacheHeader& header, std::vector<TextureCacheLevel>& levels) {
+        uint64_t end = sizeof(header) + static_cast<uint64_t>(header.levelCount) * sizeof(TextureCacheLevel);
+        if (file.size() < end) {
+            return false;
+        }
+        levels.resize(header.levelCount);
+        std::memcpy(levels.data(), file.data() + sizeof(header), levels.size() * sizeof(TextureCacheLevel));
+        for (uint32_t i = 0; i < header.levelCount; i++) {
+            const TextureCacheLevel& level = levels[i];
+            if (level.width != std::max(header.width >> i, 1u) || level.height != std::max(header.height >> i, 1u)
+                || level.offset % levelAlignment != 0 || level.offset < end || level.offset > file.size() || level.size > file.size() - level.offset
+                || level.size != levelSize(header.format, level.width, level.height)) {
+                return false;
+            }
+            end = level.offset + level.size;
+        }
+        return true;
+    }
+
+    // Offsets of the levels in a file, packed after the header and the level index
+    std::vector<TextureCacheLevel> layoutLevels(const TextureData& texture) {
+        std::vector<TextureCacheLevel> levels;
+        uint64_t offset = alignUp(sizeof(TextureCacheHeader) + texture.levels.size() * sizeof(TextureCacheLevel), levelAlignment);
+        for (const TextureLevel& level : texture.levels) {
+            levels.push_back({ offset, level.data.size(), level.width, level.height });
+            offset = alignUp(offset + level.data.size(), levelAlignment);
+        }
+        return levels;
+    }
+
+    TextureCacheHeader makeHeader(const TextureData& texture, const AssetSource& source) {
+        TextureCacheHeader header{};
+        std::memcpy(header.magic, TextureCacheHeader::expectedMagic, sizeof(header.magic));
+        header.version = TextureCacheHeader::currentVersion;
+        header.format = texture.format;
+        header.srgb = texture.srgb ? 1 : 0;
+        header.width = texture.levels.front().width;
+        header.height = texture.levels.front().height;
+        header.levelCount = static_cast<uint32_t>(texture.levels.size());
+        header.source = source;
+        return header;
+    }
+}
+
+VkFormat toVkFormat(TextureFormat format, bool srgb) {
+    switch (format) {
+    case TextureFormat::RGBA8:
+        return srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    case TextureFormat::BC1:
+        return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+    case TextureFormat::BC3:
+        return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+    case TextureFormat::BC7:
+        return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+    }
+    throw std::invalid_argument("unknown texture format");
+}
+
+size_t levelSize(TextureFormat format, uint32_t width, uint32_t height) {
+    if (format == TextureFormat::RGBA8) {
+        return static_cast<size_t>(width) * height * 4;
+    }
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockBytes(format);
+}
+
+std::vector<TextureLevel> buildMipChain(const uint8_t* pixels, uint32_t width, uint32_t height, bool srgb) {
+    std::vector<TextureLevel> levels;
+    levels.push_back({ width, height, std::vector<uint8_t>(pixels, pixels + static_cast<size_t>(width) * height * 4) });
+
+    while (levels.back().width > 1 || levels.back().height > 1) {
+        const TextureLevel& source = levels.back();
+        TextureLevel level{ std::max(source.width / 2, 1u), std::max(source.height / 2, 1u), {} };
+        level.data.resize(static_cast<size_t>(level.width) * level.height * 4);
+
+        for (uint32_t y = 0; y < level.height; y++) {
+            for (uint32_t x = 0; x < level.width; x++) {
+                // 2x2 box filter, a dimension that is already 1 samples the same texel twice
+                const uint32_t xs[2] = { std::min(2 * x, source.width - 1), std::min(2 * x + 1, source.width - 1) };
+                const uint32_t ys[2] = { std::min(2 * y, source.height - 1), std::min(2 * y + 1, source.height - 1) };
+                const uint8_t* texels[4] = {
+                    &source.data[(static_cast<size_t>(ys[0]) * source.width + xs[0]) * 4],
+                    &source.data[(static_cast<size_t>(ys[0]) * source.width + xs[1]) * 4],
+                    &source.data[(static_cast<size_t>(ys[1]) * source.width + xs[0]) * 4],
+                    &source.data[(static_cast<size_t>(ys[1]) * source.width + xs[1]) * 4],
+                };
+                uint8_t* out = &level.data[(static_cast<size_t>(y) * level.width + x) * 4];
+                for (size_t c = 0; c < 4; c++) {
+                    // Alpha is linear in both cases
+                    if (srgb && c < 3) {
+                        out[c] = linearToSrgb((srgbToLinear(texels[0][c]) + srgbToLinear(texels[1][c]) + srgbToLinear(texels[2][c]) + srgbToLinear(texels[3][c])) * 0.25f);
+                    }
+                    else {
+                        out[c] = static_cast<uint8_t>((texels[0][c] + texels[1][c] + texels[2][c] + texels[3][c] + 2) / 4);
+                    }
+                }
+            }
+        }
+        levels.push_back(std::move(level));
+    }
+    return levels;
+}
+
+std::vector<uint8_t> encodeLevel(const TextureLevel& level, TextureFormat format, unsigned threadCount) {
+    if (format == TextureFormat::RGBA8) {
+        return level.data;
+    }
+
+    const uint32_t blocksX = (level.width + 3) / 4;
+    const uint32_t blocksY = (level.height + 3) / 4;
+    const size_t bytes = blockBytes(format);
+    std::vector<uint8_t> out(static_cast<size_t>(blocksX) * blocksY * bytes);
+
+    parallelFor(blocksY, threadCount, [&](size_t begin, size_t end) {
+        for (size_t blockY = begin; blockY < end; blockY++) {
+            for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+                const Block block = loadBlock(level, blockX, static_cast<uint32_t>(blockY));
+                uint8_t* blockOut = &out[(blockY * blocksX + blockX) * bytes];
+                switch (format) {
+                case TextureFormat::BC1:
+                    encodeColorBlock(block, blockOut);
+                    break;
+                case TextureFormat::BC3:
+                    encodeAlphaBlock(block, blockOut);
+                    encodeColorBlock(block, blockOut + 8);
+                    break;
+                case TextureFormat::BC7:
+                    encodeBC7Block(block, blockOut);
+                    break;
+                case TextureFormat::RGBA8:
+                    break;
+                }
+            }
+        }
+    });
+    return out;
+}
+
+TextureData processTexture(const std::filesystem::path& imagePath, TextureFormat format, bool srgb, unsigned threadCount) {
+    int width, height, channels;
+    stbi_uc* pixels = stbi_load(imagePath.string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    if (!pixels) {
+        throw std::runtime_error("failed to load texture image " + imagePath.string());
+    }
+
+    TextureData texture{ format, srgb, buildMipChain(pixels, static_cast<uint32_t>(width), static_cast<uint32_t>(height), srgb) };
+    stbi_image_free(pixels);
+
+    for (TextureLevel& level : texture.levels) {
+        level.data = encodeLevel(level, format, threadCount);
+    }
+    return texture;
+}
+
+TextureCache::TextureCache(MappedFile file, const TextureCacheHeader& header, std::vector<TextureCacheLevel> levels)
+    : _file(std::move(file)), _header(header), _levels(std::move(levels)) {
+    // open checked that the levels follow each other, so the payload runs from the first to the end of the last
+    const uint64_t begin = _levels.front().offset;
+    const uint64_t end = _levels.back().offset + _levels.back().size;
+    _payload = { reinterpret_cast<const uint8_t*>(_file.data()) + begin, static_cast<size_t>(end - begin) };
+    for (TextureCacheLevel& level : _levels) {
+        level.offset -= begin;
+    }
+}
+
+TextureCache::TextureCache(const TextureData& texture, const AssetSource& source)
+    : _header(makeHeader(texture, source)), _levels(layoutLevels(texture)) {
+    const uint64_t begin = _levels.front().offset;
+    _ownedPayload.resize(_levels.back().offset + _levels.back().size - begin);
+    for (size_t i = 0; i < _levels.size(); i++) {
+        _levels[i].offset -= begin;
+        std::copy(texture.levels[i].data.begin(), texture.levels[i].data.end(), _ownedPayload.begin() + _levels[i].offset);
+    }
+    _payload = _ownedPayload;
+}
+
+std::unique_ptr<TextureCache> TextureCache::open(const std::filesystem::path& path, const std::filesystem::path& sourcePath, TextureFormat format) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        return nullptr;
+    }
+
+    MappedFile file(path);
+    TextureCacheHeader header;
+    if (file.size() < sizeof(header)) {
+        return nullptr;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    std::vector<TextureCacheLevel> levels;
+    if (!isValid(header, format) || !readLevels(file, header, levels) || header.source.isStale(sourcePath)) {
+        return nullptr;
+    }
+    return std::unique_ptr<TextureCache>(new TextureCache(std::move(file), header, std::move(levels)));
+}
+
+void TextureCache::write(const std::filesystem::path& path, const TextureData& texture, const AssetSource& source) {
+    const TextureCacheHeader header = makeHeader(texture, source);
+    const std::vector<TextureCacheLevel> levels = layoutLevels(texture);
+    const char padding[levelAlignment] = {};
+
+    // Written next to the target and renamed over it, so a reader never maps a half written cache
+    std::filesystem::path temporaryPath = path;
+    temporaryPath += ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to create texture cache " + temporaryPath.string());
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(levels.data()), levels.size() * sizeof(TextureCacheLevel));
+        uint64_t position = sizeof(header) + levels.size() * sizeof(TextureCacheLevel);
+        for (size_t i = 0; i < levels.size(); i++) {
+            file.write(padding, levels[i].offset - position);
+            file.write(reinterpret_cast<const char*>(texture.levels[i].data.data()), texture.levels[i].data.size());
+            position = levels[i].offset + levels[i].size;
+        }
+        if (!file) {
+            throw std::runtime_error("Failed to write texture cache " + temporaryPath.string());
+        }
+    }
+    std::filesystem::rename(temporaryPath, path);
+}
+
+std::unique_ptr<TextureCache> TextureCache::load(const std::filesystem::path& imagePath, const std::filesystem::path& cachePath, TextureFormat format) {
+    if (std::unique_ptr<TextureCache> cache = open(cachePath, imagePath, format)) {
+        return cache;
+    }
+
+    const TextureData texture = processTexture(imagePath, format);
+    const AssetSource source = AssetSource::fromFile(imagePath);
+    try {
+        write(cachePath, texture, source);
+        if (std::unique_ptr<TextureCache> cache = open(cachePath, imagePath, format)) {
+            return cache;
+        }
+    }
+    catch (const std::exception&) {
+        // A read only image directory only costs the processing on the next launch
+    }
+    return std::unique_ptr<TextureCache>(new TextureCache(texture, source));
+}
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "asset_source.hpp"
+#include "mapped_file.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace nwt{
+    enum class TextureFormat : uint32_t{
+        RGBA8,
+        // 4x4 blocks: BC1 8 bytes without alpha, BC3 16 bytes with BC4 alpha, BC7 16 bytes
+        BC1,
+        BC3,
+        BC7,
+    };
+
+    VkFormat toVkFormat(TextureFormat format, bool srgb);
+
+    // Bytes of one width x height level, BC levels are padded to whole 4x4 blocks
+    size_t levelSize(TextureFormat format, uint32_t width, uint32_t height);
+
+    struct TextureLevel{
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint8_t> data;
+    };
+
+    struct TextureData{
+        TextureFormat format;
+        bool srgb;
+        // Base level first, down to 1x1
+        std::vector<TextureLevel> levels;
+    };
+
+    // Downsamples RGBA8 pixels into a full mip chain including the base level.
+    // With srgb the color channels are averaged in linear space, so dark and bright texels keep their weight.
+    std::vector<TextureLevel> buildMipChain(const uint8_t* pixels, uint32_t width, uint32_t height, bool srgb);
+
+    // Encodes an RGBA8 level into format, the block rows are split across threadCount threads (0 is one per core)
+    std::vector<uint8_t> encodeLevel(const TextureLevel& level, TextureFormat format, unsigned threadCount = 0);
+
+    // Decodes an image file, builds its mip chain and encodes every level
+    TextureData processTexture(const std::filesystem::path& imagePath, TextureFormat format, bool srgb = true, unsigned threadCount = 0);
+
+    // .ntex level index entry, offsets are relative to the start of the file
+    struct TextureCacheLevel{
+        uint64_t offset;
+        uint64_t size;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    // Layout of a .ntex file, modeled on KTX2: this header, levelCount TextureCacheLevel entries and the level data,
+    // base level first and each level 16 byte aligned so the whole payload can be copied into one staging buffer.
+    struct TextureCacheHeader{
+        static constexpr char expectedMagic[4] = { 'N', 'T', 'E', 'X' };
+        static constexpr uint32_t currentVersion = 1;
+
+        char magic[4];
+        uint32_t version;
+        TextureFormat format;
+        uint32_t srgb;
+        uint32_t width;
+        uint32_t height;
+        uint32_t levelCount;
+        uint32_t reserved;
+        AssetSource source;
+    };
+    static_assert(std::is_trivially_copyable_v<TextureCacheHeader> && std::is_trivially_copyable_v<TextureCacheLevel>);
+
+    class TextureCache{
+    public:
+        // Maps a cache file, returns nullptr if it is missing, invalid, in another format or stale compared to sourcePath
+        static std::unique_ptr<TextureCache> open(const std::filesystem::path& path, const std::filesystem::path& sourcePath, TextureFormat format);
+
+        static void write(const std::filesystem::path& path, const TextureData& texture, const AssetSource& source);
+
+        // Opens the cache of an image, processing the image and writing the cache first when needed.
+        // If the cache can't be written the processed texture is kept in memory instead.
+        static std::unique_ptr<TextureCache> load(const std::filesystem::path& imagePath, const std::filesystem::path& cachePath, TextureFormat format);
+
+        const TextureCacheHeader& header() const { return _header; }
+        VkFormat vkFormat() const { return toVkFormat(_header.format, _header.srgb != 0); }
+        // Level offsets are relative to the start of payload()
+        const std::vector<TextureCacheLevel>& levels() const { return _levels; }
+        std::span<const uint8_t> payload() const { return _payload; }
+
+    private:
+        TextureCache(MappedFile file, const TextureCacheHeader& header, std::vector<TextureCacheLevel> levels);
+        TextureCache(const TextureData& texture, const AssetSource& source);
+
+        MappedFile _file;
+        std::vector<uint8_t> _ownedPayload;
+        TextureCacheHeader _header;
+        std::vector<TextureCacheLevel> _levels;
+        std::span<const uint8_t> _payload;
+    };
+}
@@ -12,16 +12,16 @@ namespace nwt {
 		Vec3 scale;
 
 	public:
-		Transform(const Vec3& pos, const Quaternion& q, const Vec3& scale)
+		constexpr Transform(const Vec3& pos, const Quaternion& q, const Vec3& scale)
 			: position(pos), rotation(q), scale(scale) {}
 
 	public:
-		Mat4x4 localToWorldMatrix() const;
-		Mat4x4 worldToLocalMatrix() const;
+		constexpr Mat4x4 localToWorldMatrix() const;
+		constexpr Mat4x4 worldToLocalMatrix() const;
 
-		Vec3 forward() const;
-		Vec3 up() const;
-		Vec3 right() const;
+		constexpr Vec3 forward() const;
+		constexpr Vec3 up() const;
+		constexpr Vec3 right() const;
 
 		void setForward(const Vec3& vec);
 		void setUp(const Vec3& vec);
@@ -32,7 +32,7 @@ namespace nwt {
 		bool operator!=(const Transform& other) const;
 	};
 
-	inline Mat4x4 Transform::localToWorldMatrix() const{
+	inline constexpr Mat4x4 Transform::localToWorldMatrix() const{
 		Mat4x4 result = Mat4x4::rotate(rotation);
 		result.m00 *= scale.x;
 		result.m10 *= scale.x;
@@ -52,7 +52,7 @@ namespace nwt {
 		return result;
 	}
 
-	inline Mat4x4 Transform::worldToLocalMatrix() const{
+	inline constexpr Mat4x4 Transform::worldToLocalMatrix() const{
 		Quaternion rot = rotation.conjugated();
 
 		Mat4x4 result = Mat4x4::rotate(rot);
@@ -75,15 +75,15 @@ namespace nwt {
 		return result;
 	}
 
-	inline Vec3 Transform::forward() const {
+	inline constexpr Vec3 Transform::forward() const {
 		return Quaternion::rotateVector(rotation, Vec3::forward());
 	}
 
-	inline Vec3 Transform::up() const {
+	inline constexpr Vec3 Transform::up() const {
 		return Quaternion::rotateVector(rotation, Vec3::up());
 	}
 
-	inline Vec3 Transform::right() const {
+	inline constexpr Vec3 Transform::right() const {
 		return Quaternion::rotateVector(rotation, Vec3::right());
 	}
 
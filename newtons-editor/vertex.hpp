@@ -8,8 +8,8 @@
 
 namespace nwt{
     struct Vertex{
-        Vec3 pos;
-        Vec3 color;
+        Vec3Packed pos;
+        Vec3Packed color;
         Vec2 texCoord;
         static VkVertexInputBindingDescription getBindingDescription();
         static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions();
@@ -22,10 +22,10 @@ namespace std {
 	template<>
 	struct hash<nwt::Vertex> {
 		size_t operator()(nwt::Vertex const& vertex) const {
-			size_t combinedHash = hash<nwt::Vec3>()(vertex.pos);
-			nwt::Hash::HashCombine(combinedHash, hash<nwt::Vec3>()(vertex.color));
-			nwt::Hash::HashCombine(combinedHash, hash<nwt::Vec2>()(vertex.texCoord));
-			return combinedHash;
+			return nwt::Hash::HashFloats(
+				vertex.pos.x, vertex.pos.y, vertex.pos.z,
+				vertex.color.x, vertex.color.y, vertex.color.z,
+				vertex.texCoord.x, vertex.texCoord.y);
 		}
 	};
 }
\ No newline at end of file
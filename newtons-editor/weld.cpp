@@ -0,0 +1,181 @@
+#include "weld.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <thread>
+
+namespace nwt{
+namespace {
+    // The key only has to bring equal cells together, 32 bits of their hash are enough since runs compare the
+    // cells themselves and the entries stay 8 bytes
+    struct SortEntry{
+        uint32_t key;
+        uint32_t corner;
+    };
+
+    // Attribute bits two corners must share to be welded. Without a tolerance these are the float bits with -0.0
+    // folded into 0.0, like Vertex::operator==; with one, positions and texture coordinates become grid cells. The
+    // normal is 0 for corners without one.
+    using WeldCell = std::array<uint32_t, 11>;
+
+    uint32_t quantize(float value, float tolerance) {
+        if (tolerance <= 0.0f) {
+            return static_cast<uint32_t>(Hash::CanonicalBits(value));
+        }
+        const float cell = std::floor(value / tolerance + 0.5f);
+        constexpr float limit = static_cast<float>(std::numeric_limits<int32_t>::max() / 2);
+        return static_cast<uint32_t>(static_cast<int32_t>(std::clamp(cell, -limit, limit)));
+    }
+
+    WeldCell cellOf(const Vertex& vertex, const Vec3Packed* normal, const WeldOptions& options) {
+        return {
+            quantize(vertex.pos.x, options.positionTolerance),
+            quantize(vertex.pos.y, options.positionTolerance),
+            quantize(vertex.pos.z, options.positionTolerance),
+            quantize(vertex.color.x, 0.0f),
+            quantize(vertex.color.y, 0.0f),
+            quantize(vertex.color.z, 0.0f),
+            quantize(vertex.texCoord.x, options.texCoordTolerance),
+            quantize(vertex.texCoord.y, options.texCoordTolerance),
+            normal ? quantize(normal->x, 0.0f) : 0,
+            normal ? quantize(normal->y, 0.0f) : 0,
+            normal ? quantize(normal->z, 0.0f) : 0,
+        };
+    }
+
+    // Stable LSD radix sort by key, 11 bits per pass so a pass's buckets stay in cache. Each thread counts and scatters its own slice, with the
+    // slices of a bucket laid out in thread order so equal keys keep their corner order.
+    void radixSort(std::vector<SortEntry>& entries, size_t threads) {
+        constexpr size_t digitBits = 11;
+        constexpr size_t bucketCount = size_t(1) << digitBits;
+        std::vector<SortEntry> scratch(entries.size());
+        std::vector<std::vector<size_t>> offsets(threads, std::vector<size_t>(bucketCount));
+        const size_t count = entries.size();
+
+        for (size_t shift = 0; shift < 32; shift += digitBits) {
+            parallelFor(threads, static_cast<unsigned>(threads), [&](size_t firstThread, size_t lastThread) {
+                for (size_t thread = firstThread; thread < lastThread; thread++) {
+                    std::vector<size_t>& histogram = offsets[thread];
+                    std::fill(histogram.begin(), histogram.end(), 0);
+                    for (size_t i = count * thread / threads; i < count * (thread + 1) / threads; i++) {
+                        histogram[entries[i].key >> shift & (bucketCount - 1)]++;
+                    }
+                }
+            });
+
+            size_t offset = 0;
+            for (size_t bucket = 0; bucket < bucketCount; bucket++) {
+                for (size_t thread = 0; thread < threads; thread++) {
+                    const size_t bucketSize = offsets[thread][bucket];
+                    offsets[thread][bucket] = offset;
+                    offset += bucketSize;
+                }
+            }
+
+            parallelFor(threads, static_cast<unsigned>(threads), [&](size_t firstThread, size_t lastThread) {
+                for (size_t thread = firstThread; thread < lastThread; thread++) {
+                    std::vector<size_t>& next = offsets[thread];
+                    for (size_t i = count * thread / threads; i < count * (thread + 1) / threads; i++) {
+                        scratch[next[entries[i].key >> shift & (bucketCount - 1)]++] = entries[i];
+                    }
+                }
+            });
+            entries.swap(scratch);
+        }
+    }
+
+    void weld(std::span<const Vertex> corners, std::span<const Vec3Packed> cornerNormals, const WeldOptions& options, std::vector<Vertex>& vertices,
+        std::vector<Vec3Packed>* normals, std::vector<uint32_t>& indices) {
+        const size_t count = corners.size();
+        const auto normalOf = [&](size_t corner) { return cornerNormals.empty() ? nullptr : &cornerNormals[corner]; };
+        unsigned threadCount = options.threadCount != 0 ? options.threadCount : std::max(1u, std::thread::hardware_concurrency());
+        // Below this a thread costs more than the work it takes over
+        constexpr size_t minCornersPerThread = size_t(1) << 16;
+        const size_t threads = std::clamp<size_t>(count / minCornersPerThread, 1, threadCount);
+
+        std::vector<SortEntry> entries(count);
+        parallelFor(count, static_cast<unsigned>(threads), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const WeldCell cell = cellOf(corners[i], normalOf(i), options);
+                entries[i] = { static_cast<uint32_t>(Hash::HashBytes(cell.data(), sizeof(cell)) >> 32), static_cast<uint32_t>(i) };
+            }
+        });
+        radixSort(entries, threads);
+
+        // Every corner points at the first corner of its run of equal keys, which is its lowest since the sort is stable
+        std::vector<uint32_t> remap(count);
+        parallelFor(threads, static_cast<unsigned>(threads), [&](size_t firstThread, size_t lastThread) {
+            const auto runStart = [&](size_t thread) {
+                size_t i = count * thread / threads;
+                while (i > 0 && i < count && entries[i].key == entries[i - 1].key) {
+                    i++;
+                }
+                return i;
+            };
+            for (size_t i = runStart(firstThread), end = runStart(lastThread), first = i; i < end; i++) {
+                if (entries[i].key != entries[first].key) {
+                    first = i;
+                }
+                remap[entries[i].corner] = entries[first].corner;
+            }
+        });
+
+        // A run can hold different cells whose keys collide. Checking each corner against the first of its run in
+        // corner order finds them without the cache misses of walking the corners in sorted order.
+        std::vector<uint8_t> collided(count);
+        parallelFor(count, static_cast<unsigned>(threads), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                // Identical bytes always share a cell, which spares building both cells for nearly every corner
+                const bool identical = std::memcmp(&corners[i], &corners[remap[i]], sizeof(Vertex)) == 0
+                    && (cornerNormals.empty() || std::memcmp(&cornerNormals[i], &cornerNormals[remap[i]], sizeof(Vec3Packed)) == 0);
+                collided[i] = remap[i] != i && !identical && cellOf(corners[i], normalOf(i), options) != cellOf(corners[remap[i]], normalOf(remap[i]), options);
+            }
+        });
+
+        // Numbering the first corners in corner order reproduces the order of first use. The few collided corners
+        // are welded among themselves by cell instead.
+        std::map<WeldCell, uint32_t> collisions;
+        vertices.clear();
+        if (normals) {
+            normals->clear();
+        }
+        const auto addVertex = [&](size_t corner) {
+            vertices.push_back(corners[corner]);
+            if (normals) {
+                normals->push_back(cornerNormals[corner]);
+            }
+        };
+        indices.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            if (collided[i]) {
+                const auto [it, inserted] = collisions.try_emplace(cellOf(corners[i], normalOf(i), options), static_cast<uint32_t>(vertices.size()));
+                if (inserted) {
+                    addVertex(i);
+                }
+                indices[i] = it->second;
+            }
+            else if (remap[i] == i) {
+                indices[i] = static_cast<uint32_t>(vertices.size());
+                addVertex(i);
+            }
+            else {
+                indices[i] = indices[remap[i]];
+            }
+        }
+    }
+}
+
+void weldVertices(std::span<const Vertex> corners, const WeldOptions& options, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+    weld(corners, {}, options, vertices, nullptr, indices);
+}
+
+void weldVertices(std::span<const Vertex> corners, std::span<const Vec3Packed> cornerNormals, const WeldOptions& options, std::vector<Vertex>& vertices,
+    std::vector<Vec3Packed>& normals, std::vector<uint32_t>& indices) {
+    weld(corners, cornerNormals, options, vertices, &normals, indices);
+}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "vertex.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace nwt{
+    struct WeldOptions{
+        // Positions and texture coordinates are snapped to a grid with this spacing, corners in the same cell are
+        // merged keeping the attributes of the first corner. This is not a distance test: corners closer than the
+        // spacing on either side of a cell border stay apart, and corners almost a full cell apart can merge.
+        // 0 only merges exact duplicates.
+        float positionTolerance = 0.0f;
+        float texCoordTolerance = 0.0f;
+        // 0 is one thread per core
+        unsigned threadCount = 0;
+    };
+
+    // Merges the equal corners of a triangle list into vertices and writes one index per corner. Vertices are in order
+    // of first use, so without tolerances the result is the same as inserting every corner into an
+    // std::unordered_map<Vertex, uint32_t>, but the corners are radix sorted by key on all threads instead.
+    void weldVertices(std::span<const Vertex> corners, const WeldOptions& options, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+    // Like weldVertices with a normal for every corner, which Vertex has no room for. Corners only merge if their
+    // normals are equal too, normals gets the normal of every vertex.
+    void weldVertices(std::span<const Vertex> corners, std::span<const Vec3Packed> cornerNormals, const WeldOptions& options, std::vector<Vertex>& vertices,
+        std::vector<Vec3Packed>& normals, std::vector<uint32_t>& indices);
+}
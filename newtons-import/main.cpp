@@ -0,0 +1,244 @@
+#include "mesh_cache.hpp"
+#include "texture.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Usage: newtons-import <source directory> [options]
+//   --output <directory>   where the converted assets go, mirroring the source tree (default: next to the sources)
+//   --jobs <n>             assets converted at the same time (default: one per core)
+//   --texture-format <f>   rgba8, bc1, bc3 or bc7 (default bc7)
+//   --tangents             store normals and MikkTSpace tangents with every mesh, for normal mapping
+//   --lods <r1,r2,...>     index count ratios of the simplified levels of detail, or none (default 0.5,0.25,0.1)
+//   --force                convert every asset even if its output is up to date
+// Every .obj becomes a .nmesh and every .png a .ntex, the formats the editor loads at runtime.
+// Meshes get simplified levels of detail, are reordered for the vertex cache and split into meshlets for culling,
+// and their ACMR and ATVR before and after are printed.
+// An output is up to date when it is valid, its recorded source matches by size and content hash and it was converted
+// with the same --texture-format, --tangents and --lods.
+// The exit code is 1 if any asset failed to convert.
+
+namespace {
+	struct Options {
+		std::filesystem::path sourceDirectory;
+		std::filesystem::path outputDirectory;
+		unsigned jobs = 0;
+		nwt::TextureFormat textureFormat = nwt::TextureFormat::BC7;
+		bool tangents = false;
+		std::vector<float> lodRatios{ std::begin(nwt::defaultLodRatios), std::end(nwt::defaultLodRatios) };
+		bool force = false;
+	};
+
+	enum class AssetKind {
+		Mesh,
+		Texture,
+	};
+
+	struct Asset {
+		AssetKind kind;
+		std::filesystem::path source;
+		std::filesystem::path output;
+		uintmax_t size;
+	};
+
+	enum class Outcome {
+		Converted,
+		UpToDate,
+		Failed,
+	};
+
+	const char* outcomeName(Outcome outcome) {
+		switch (outcome) {
+		case Outcome::Converted: return "converted";
+		case Outcome::UpToDate: return "up to date";
+		case Outcome::Failed: return "FAILED";
+		}
+		return "";
+	}
+
+	nwt::TextureFormat parseTextureFormat(const std::string& name) {
+		if (name == "rgba8") return nwt::TextureFormat::RGBA8;
+		if (name == "bc1") return nwt::TextureFormat::BC1;
+		if (name == "bc3") return nwt::TextureFormat::BC3;
+		if (name == "bc7") return nwt::TextureFormat::BC7;
+		throw std::runtime_error("unknown texture format " + name);
+	}
+
+	std::vector<float> parseLodRatios(const std::string& list) {
+		std::vector<float> ratios;
+		if (list == "none")
+			return ratios;
+		size_t begin = 0;
+		while (begin <= list.size()) {
+			const size_t end = std::min(list.find(',', begin), list.size());
+			const std::string item = list.substr(begin, end - begin);
+			char* parsedEnd = nullptr;
+			const float ratio = std::strtof(item.c_str(), &parsedEnd);
+			if (item.empty() || *parsedEnd != '\0' || !(ratio > 0.0f && ratio < 1.0f))
+				throw std::runtime_error("level of detail ratios must lie between 0 and 1, got " + item);
+			ratios.push_back(ratio);
+			begin = end + 1;
+		}
+		// Every level is simplified from the one before, so the ratios have to shrink
+		std::sort(ratios.begin(), ratios.end(), std::greater<float>());
+		return ratios;
+	}
+
+	Options parseOptions(int argc, char** argv) {
+		Options options;
+		for (int i = 1; i < argc; i++) {
+			const std::string arg = argv[i];
+			const bool hasValue = i + 1 < argc;
+			if (arg == "--output" && hasValue) options.outputDirectory = argv[++i];
+			else if (arg == "--jobs" && hasValue) options.jobs = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+			else if (arg == "--texture-format" && hasValue) options.textureFormat = parseTextureFormat(argv[++i]);
+			else if (arg == "--tangents") options.tangents = true;
+			else if (arg == "--lods" && hasValue) options.lodRatios = parseLodRatios(argv[++i]);
+			else if (arg == "--force") options.force = true;
+			else if (!arg.starts_with("--") && options.sourceDirectory.empty()) options.sourceDirectory = arg;
+			else throw std::runtime_error("unknown or incomplete option " + arg);
+		}
+
+		if (options.sourceDirectory.empty())
+			throw std::runtime_error("usage: newtons-import <source directory> [--output <directory>] [--jobs <n>] [--texture-format <rgba8|bc1|bc3|bc7>] [--tangents] [--lods <r1,r2,...|none>] [--force]");
+		if (!std::filesystem::is_directory(options.sourceDirectory))
+			throw std::runtime_error(options.sourceDirectory.string() + " is not a directory");
+		if (options.outputDirectory.empty())
+			options.outputDirectory = options.sourceDirectory;
+		return options;
+	}
+
+	std::vector<Asset> findAssets(const Options& options) {
+		std::vector<Asset> assets;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(options.sourceDirectory)) {
+			if (!entry.is_regular_file())
+				continue;
+
+			std::string extension = entry.path().extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+			AssetKind kind;
+			if (extension == ".obj") kind = AssetKind::Mesh;
+			else if (extension == ".png") kind = AssetKind::Texture;
+			else continue;
+
+			std::filesystem::path output = options.outputDirectory / std::filesystem::relative(entry.path(), options.sourceDirectory);
+			output.replace_extension(kind == AssetKind::Mesh ? ".nmesh" : ".ntex");
+			assets.push_back({ kind, entry.path(), std::move(output), entry.file_size() });
+		}
+
+		// Largest first, so a big asset doesn't start last and keep one job running alone at the end
+		std::sort(assets.begin(), assets.end(), [](const Asset& a, const Asset& b) { return a.size > b.size; });
+		return assets;
+	}
+
+	nwt::MeshImportOptions meshImportOptions(const Options& options) {
+		return { options.lodRatios, options.tangents };
+	}
+
+	bool isUpToDate(const Asset& asset, const Options& options) {
+		if (asset.kind == AssetKind::Mesh)
+			return nwt::MeshCache::open(asset.output, asset.source, meshImportOptions(options)) != nullptr;
+		return nwt::TextureCache::open(asset.output, asset.source, options.textureFormat) != nullptr;
+	}
+
+	// Returns details for the asset's output line
+	std::string convert(const Asset& asset, const Options& options, unsigned threadCount) {
+		std::filesystem::create_directories(asset.output.parent_path());
+		const nwt::AssetSource source = nwt::AssetSource::fromFile(asset.source);
+		if (asset.kind == AssetKind::Texture) {
+			nwt::TextureCache::write(asset.output, nwt::processTexture(asset.source, options.textureFormat, true, threadCount), source);
+			return "";
+		}
+
+		nwt::MeshData mesh = nwt::importObj(asset.source, threadCount);
+		if (options.tangents)
+			nwt::generateTangentFrames(mesh, threadCount);
+		nwt::generateLods(mesh, options.lodRatios, {}, threadCount);
+		nwt::MeshOptimizationReport report = nwt::optimizeMesh(mesh, threadCount);
+		nwt::generateMeshlets(mesh, threadCount);
+		// Meshlets move triangles again, the order written is the one that counts
+		report.after = nwt::analyzeVertexCache(mesh.indices, mesh.vertices.size());
+		nwt::MeshCache::write(asset.output, mesh, source, meshImportOptions(options));
+
+		char details[128];
+		std::snprintf(details, sizeof(details), "  (ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, %zu LODs, %zu meshlets)", report.before.acmr, report.after.acmr, report.before.atvr, report.after.atvr, mesh.lods.size(), mesh.meshlets.size());
+		return details;
+	}
+} // namespace
+
+int main(int argc, char** argv) {
+	try {
+		const Options options = parseOptions(argc, argv);
+		const std::vector<Asset> assets = findAssets(options);
+
+		const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+		const unsigned jobs = static_cast<unsigned>(std::min<size_t>(options.jobs ? options.jobs : cores, std::max<size_t>(assets.size(), 1)));
+		// Cores left over when there are fewer assets than cores go to the parsers and encoders inside each job
+		const unsigned threadsPerJob = std::max(1u, cores / jobs);
+
+		std::atomic<size_t> next = 0;
+		std::mutex outputMutex;
+		size_t counts[3] = {};
+
+		const auto start = std::chrono::steady_clock::now();
+		const auto work = [&] {
+			for (size_t i = next++; i < assets.size(); i = next++) {
+				const Asset& asset = assets[i];
+				const auto assetStart = std::chrono::steady_clock::now();
+				Outcome outcome;
+				std::string error;
+				std::string details;
+				try {
+					if (!options.force && isUpToDate(asset, options)) {
+						outcome = Outcome::UpToDate;
+					}
+					else {
+						details = convert(asset, options, threadsPerJob);
+						outcome = Outcome::Converted;
+					}
+				}
+				catch (const std::exception& e) {
+					outcome = Outcome::Failed;
+					error = e.what();
+				}
+				const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - assetStart).count();
+
+				const std::lock_guard lock(outputMutex);
+				counts[static_cast<size_t>(outcome)]++;
+				if (outcome == Outcome::Failed)
+					std::fprintf(stderr, "%10.1f ms  %-10s  %s: %s\n", ms, outcomeName(outcome), asset.source.string().c_str(), error.c_str());
+				else
+					std::printf("%10.1f ms  %-10s  %s -> %s%s\n", ms, outcomeName(outcome), asset.source.string().c_str(), asset.output.string().c_str(), details.c_str());
+			}
+		};
+		{
+			std::vector<std::jthread> workers;
+			for (unsigned i = 1; i < jobs; i++)
+				workers.emplace_back(work);
+			work();
+		}
+		const double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		const size_t failed = counts[static_cast<size_t>(Outcome::Failed)];
+		std::printf("%zu converted, %zu up to date, %zu failed in %.1f ms (%u jobs)\n",
+			counts[static_cast<size_t>(Outcome::Converted)], counts[static_cast<size_t>(Outcome::UpToDate)], failed, totalMs, jobs);
+		return failed > 0 ? 1 : 0;
+	}
+	catch (const std::exception& e) {
+		std::fprintf(stderr, "%s\n", e.what());
+		return 2;
+	}
+}
@@ -0,0 +1,209 @@
+#include "bench.hpp"
+#include "simd.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+
+// Usage: newtons-utils-bench [options]
+//   --filter <text>       only run benchmarks whose name contains text
+//   --min-time <ms>       minimum duration of one repetition (default 100)
+//   --repetitions <n>     repetitions per benchmark, the median is reported (default 5)
+//   --json <file>         write the results as JSON
+//   --baseline <file>     compare against a JSON file written by --json
+//   --threshold <ratio>   allowed slowdown against the baseline before failing (default 0.10)
+//   --list                print the benchmark names and exit
+// The exit code is 1 if any benchmark regressed past the threshold.
+
+namespace nwt::bench {
+	std::vector<Benchmark>& registry() {
+		static std::vector<Benchmark> benchmarks;
+		return benchmarks;
+	}
+
+	int registerBenchmark(const char* name, BenchmarkFunction function) {
+		registry().push_back({ name, function });
+		return 0;
+	}
+
+	namespace {
+		struct Options {
+			std::string filter;
+			double minTimeMs = 100;
+			int repetitions = 5;
+			std::string jsonPath;
+			std::string baselinePath;
+			double threshold = 0.10;
+			bool list = false;
+		};
+
+		struct Result {
+			std::string name;
+			double nsPerOp;
+			size_t iterations;
+			size_t items;
+		};
+
+		const char* simdBackend() {
+#if defined(NWT_SIMD_AVX2)
+			return "AVX2";
+#elif defined(NWT_SIMD_SSE)
+			return "SSE";
+#elif defined(NWT_SIMD_NEON)
+			return "NEON";
+#else
+			return "NONE";
+#endif
+		}
+
+		double runOnce(const Benchmark& benchmark, State& state) {
+			state.elapsedNs = 0;
+			const auto start = std::chrono::steady_clock::now();
+			benchmark.function(state);
+			const auto end = std::chrono::steady_clock::now();
+			// Benchmarks that don't time themselves are measured as a whole
+			return state.elapsedNs > 0 ? state.elapsedNs : std::chrono::duration<double, std::nano>(end - start).count();
+		}
+
+		Result measure(const Benchmark& benchmark, const Options& options) {
+			const double minTimeNs = options.minTimeMs * 1e6;
+
+			// Grow the iteration count until one run takes at least the minimum time
+			State state;
+			double elapsed = runOnce(benchmark, state);
+			while (elapsed < minTimeNs) {
+				const double scale = std::clamp(minTimeNs * 1.2 / std::max(elapsed, 1.0), 2.0, 100.0);
+				state.iterations = static_cast<size_t>(state.iterations * scale);
+				elapsed = runOnce(benchmark, state);
+			}
+
+			std::vector<double> samples;
+			samples.push_back(elapsed);
+			for (int i = 1; i < options.repetitions; i++) {
+				samples.push_back(runOnce(benchmark, state));
+			}
+			std::sort(samples.begin(), samples.end());
+
+			const double median = samples[samples.size() / 2];
+			return { benchmark.name, median / (static_cast<double>(state.iterations) * state.items), state.iterations, state.items };
+		}
+
+		// Reads the name and ns_per_op pairs of a file written by writeJson, other JSON is not supported.
+		std::map<std::string, double> readBaseline(const std::string& path) {
+			std::ifstream file(path);
+			if (!file)
+				throw std::runtime_error("failed to open baseline " + path);
+			const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+			std::map<std::string, double> baseline;
+			const std::string nameKey = "\"name\": \"";
+			const std::string valueKey = "\"ns_per_op\": ";
+			size_t pos = 0;
+			while ((pos = text.find(nameKey, pos)) != std::string::npos) {
+				pos += nameKey.size();
+				const size_t nameEnd = text.find('"', pos);
+				const size_t valuePos = text.find(valueKey, nameEnd);
+				if (nameEnd == std::string::npos || valuePos == std::string::npos)
+					break;
+				baseline[text.substr(pos, nameEnd - pos)] = std::strtod(text.c_str() + valuePos + valueKey.size(), nullptr);
+				pos = valuePos;
+			}
+			return baseline;
+		}
+
+		void writeJson(const std::string& path, const std::vector<Result>& results) {
+			std::ofstream file(path);
+			if (!file)
+				throw std::runtime_error("failed to open " + path);
+
+			file << "{\n  \"simd\": \"" << simdBackend() << "\",\n  \"benchmarks\": [\n";
+			for (size_t i = 0; i < results.size(); i++) {
+				const Result& result = results[i];
+				file << "    { \"name\": \"" << result.name << "\", \"ns_per_op\": " << result.nsPerOp
+					<< ", \"ops_per_second\": " << 1e9 / result.nsPerOp
+					<< ", \"iterations\": " << result.iterations << ", \"items\": " << result.items << " }"
+					<< (i + 1 < results.size() ? ",\n" : "\n");
+			}
+			file << "  ]\n}\n";
+		}
+
+		Options parseOptions(int argc, char** argv) {
+			Options options;
+			for (int i = 1; i < argc; i++) {
+				const std::string arg = argv[i];
+				const bool hasValue = i + 1 < argc;
+				if (arg == "--filter" && hasValue) options.filter = argv[++i];
+				else if (arg == "--min-time" && hasValue) options.minTimeMs = std::atof(argv[++i]);
+				else if (arg == "--repetitions" && hasValue) options.repetitions = std::max(1, std::atoi(argv[++i]));
+				else if (arg == "--json" && hasValue) options.jsonPath = argv[++i];
+				else if (arg == "--baseline" && hasValue) options.baselinePath = argv[++i];
+				else if (arg == "--threshold" && hasValue) options.threshold = std::atof(argv[++i]);
+				else if (arg == "--list") options.list = true;
+				else throw std::runtime_error("unknown or incomplete option " + arg);
+			}
+			return options;
+		}
+	} // namespace
+} // namespace nwt::bench
+
+int main(int argc, char** argv) {
+	using namespace nwt::bench;
+
+	try {
+		const Options options = parseOptions(argc, argv);
+
+		std::vector<Benchmark> benchmarks = registry();
+		std::sort(benchmarks.begin(), benchmarks.end(), [](const Benchmark& a, const Benchmark& b) { return a.name < b.name; });
+
+		if (options.list) {
+			for (const Benchmark& benchmark : benchmarks) {
+				std::printf("%s\n", benchmark.name.c_str());
+			}
+			return 0;
+		}
+
+		const std::map<std::string, double> baseline = options.baselinePath.empty() ? std::map<std::string, double>() : readBaseline(options.baselinePath);
+
+		std::printf("simd backend: %s\n", simdBackend());
+		std::printf("%-44s %12s %16s %10s\n", "benchmark", "ns/op", "ops/s", "baseline");
+
+		std::vector<Result> results;
+		int regressions = 0;
+		for (const Benchmark& benchmark : benchmarks) {
+			if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos)
+				continue;
+
+			const Result result = measure(benchmark, options);
+			results.push_back(result);
+
+			std::printf("%-44s %12.3f %16.4g", result.name.c_str(), result.nsPerOp, 1e9 / result.nsPerOp);
+			const auto it = baseline.find(result.name);
+			if (it != baseline.end()) {
+				const double change = result.nsPerOp / it->second - 1;
+				const bool regressed = change > options.threshold;
+				regressions += regressed;
+				std::printf(" %+9.1f%%%s", change * 100, regressed ? "  REGRESSION" : "");
+			}
+			std::printf("\n");
+		}
+
+		if (!options.jsonPath.empty())
+			writeJson(options.jsonPath, results);
+
+		if (regressions > 0) {
+			std::printf("%d benchmark(s) slower than the baseline by more than %.0f%%\n", regressions, options.threshold * 100);
+			return 1;
+		}
+		return 0;
+	}
+	catch (const std::exception& e) {
+		std::fprintf(stderr, "%s\n", e.what());
+		return 2;
+	}
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Minimal benchmark harness for the newtons-utils math kernels, see bench.cpp for the runner.
+// Every benchmark runs state.iterations times over state.items elements, results are reported per element.
+
+namespace nwt::bench {
+	struct State {
+		size_t iterations = 1;
+		// Elements processed per iteration, used for ns/op and throughput
+		size_t items = 1;
+		// Time spent in the measured loop, the input setup around it isn't counted
+		double elapsedNs = 0;
+
+		void startTimer() { _start = std::chrono::steady_clock::now(); }
+		void stopTimer() { elapsedNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - _start).count(); }
+
+	private:
+		std::chrono::steady_clock::time_point _start;
+	};
+
+	using BenchmarkFunction = void(*)(State&);
+
+	struct Benchmark {
+		std::string name;
+		BenchmarkFunction function;
+	};
+
+	std::vector<Benchmark>& registry();
+	int registerBenchmark(const char* name, BenchmarkFunction function);
+
+	/// <summary>
+	/// Keeps the compiler from optimizing the computation of value away.
+	/// </summary>
+	template<typename T>
+	inline void doNotOptimize(T& value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+		static_cast<void>(*static_cast<volatile char*>(static_cast<void*>(&value)));
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : "+m"(value) : : "memory");
+#endif
+	}
+
+	/// <summary>
+	/// Forces all pending memory writes, so results stored into arrays count as used.
+	/// </summary>
+	inline void clobberMemory() {
+#if defined(_MSC_VER) && !defined(__clang__)
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : : "memory");
+#endif
+	}
+
+	/// <summary>
+	/// Deterministic generator for the benchmark inputs, so every run measures the same data.
+	/// </summary>
+	class Random {
+	public:
+		explicit Random(uint64_t seed = 0x2545F4914F6CDD1Dull) : _state(seed) {}
+
+		uint32_t next() {
+			_state ^= _state << 13;
+			_state ^= _state >> 7;
+			_state ^= _state << 17;
+			return static_cast<uint32_t>(_state >> 32);
+		}
+
+		float range(float min, float max) {
+			return min + (max - min) * (next() >> 8) * (1.0f / 16777216.0f);
+		}
+
+	private:
+		uint64_t _state;
+	};
+
+	// Number of elements the single element benchmarks loop over per iteration
+	inline constexpr size_t batchSize = 1024;
+
+	// Results are stored into a plain array, std::vector<bool> would measure the bit packing instead
+	template<typename T>
+	using Stored = std::conditional_t<std::is_same_v<T, bool>, unsigned char, T>;
+
+	/// <summary>
+	/// Writes op(in[i]) to an output array for every element, once per iteration.
+	/// </summary>
+	template<typename In, typename Op>
+	inline void runUnary(State& state, const std::vector<In>& in, Op op) {
+		std::vector<Stored<decltype(op(in[0]))>> out(in.size(), op(in[0]));
+		state.items = in.size();
+		state.startTimer();
+		for (size_t it = 0; it < state.iterations; it++) {
+			for (size_t i = 0; i < in.size(); i++) {
+				out[i] = op(in[i]);
+			}
+			clobberMemory();
+		}
+		state.stopTimer();
+		doNotOptimize(out[0]);
+	}
+
+	/// <summary>
+	/// Writes op(a[i], b[i]) to an output array for every element, once per iteration.
+	/// </summary>
+	template<typename A, typename B, typename Op>
+	inline void runBinary(State& state, const std::vector<A>& a, const std::vector<B>& b, Op op) {
+		std::vector<Stored<decltype(op(a[0], b[0]))>> out(a.size(), op(a[0], b[0]));
+		state.items = a.size();
+		state.startTimer();
+		for (size_t it = 0; it < state.iterations; it++) {
+			for (size_t i = 0; i < a.size(); i++) {
+				out[i] = op(a[i], b[i]);
+			}
+			clobberMemory();
+		}
+		state.stopTimer();
+		doNotOptimize(out[0]);
+	}
+
+	/// <summary>
+	/// Calls kernel() once per iteration, the kernel processes items elements.
+	/// </summary>
+	template<typename Kernel>
+	inline void runBatch(State& state, size_t items, Kernel kernel) {
+		state.items = items;
+		state.startTimer();
+		for (size_t it = 0; it < state.iterations; it++) {
+			kernel();
+			clobberMemory();
+		}
+		state.stopTimer();
+	}
+} // namespace nwt::bench
+
+#define NWT_BENCH_CONCAT_IMPL(a, b) a##b
+#define NWT_BENCH_CONCAT(a, b) NWT_BENCH_CONCAT_IMPL(a, b)
+
+// Defines and registers a benchmark, the body receives nwt::bench::State& state.
+#define NWT_BENCHMARK(name) \
+	static void NWT_BENCH_CONCAT(benchmark_, __LINE__)(nwt::bench::State& state); \
+	static const int NWT_BENCH_CONCAT(registration_, __LINE__) = nwt::bench::registerBenchmark(name, NWT_BENCH_CONCAT(benchmark_, __LINE__)); \
+	static void NWT_BENCH_CONCAT(benchmark_, __LINE__)([[maybe_unused]] nwt::bench::State& state)
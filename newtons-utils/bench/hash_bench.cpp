@@ -0,0 +1,33 @@
+#include "bench.hpp"
+#include "vec2.hpp"
+#include "vec3.hpp"
+#include "vec4.hpp"
+#include "quaternion.hpp"
+#include "mat4x4.hpp"
+
+#include <functional>
+
+using namespace nwt;
+using namespace nwt::bench;
+
+namespace {
+	template<typename T, typename Make>
+	std::vector<T> randomValues(uint64_t seed, Make make) {
+		Random random(seed);
+		std::vector<T> values(batchSize, make(random));
+		for (T& value : values) value = make(random);
+		return values;
+	}
+
+	template<typename T>
+	void runHash(State& state, const std::vector<T>& values) {
+		runUnary(state, values, [](const T& value) { return std::hash<T>()(value); });
+	}
+}
+
+NWT_BENCHMARK("Hash/Vec2") { runHash(state, randomValues<Vec2>(1, [](Random& r) { return Vec2(r.range(-10, 10), r.range(-10, 10)); })); }
+NWT_BENCHMARK("Hash/Vec3") { runHash(state, randomValues<Vec3>(1, [](Random& r) { return Vec3(r.range(-10, 10), r.range(-10, 10), r.range(-10, 10)); })); }
+NWT_BENCHMARK("Hash/Vec3Packed") { runHash(state, randomValues<Vec3Packed>(1, [](Random& r) { return Vec3Packed(r.range(-10, 10), r.range(-10, 10), r.range(-10, 10)); })); }
+NWT_BENCHMARK("Hash/Vec4") { runHash(state, randomValues<Vec4>(1, [](Random& r) { return Vec4(r.range(-10, 10), r.range(-10, 10), r.range(-10, 10), r.range(-10, 10)); })); }
+NWT_BENCHMARK("Hash/Quaternion") { runHash(state, randomValues<Quaternion>(1, [](Random& r) { return Quaternion::fromEuler(r.range(-3, 3), r.range(-3, 3), r.range(-3, 3)); })); }
+NWT_BENCHMARK("Hash/Mat4x4") { runHash(state, randomValues<Mat4x4>(1, [](Random& r) { return Mat4x4::rotate(Quaternion::fromEuler(r.range(-3, 3), r.range(-3, 3), r.range(-3, 3))); })); }
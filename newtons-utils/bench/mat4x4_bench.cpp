@@ -0,0 +1,89 @@
+#include "bench.hpp"
+#include "mat4x4.hpp"
+
+using namespace nwt;
+using namespace nwt::bench;
+
+namespace {
+	std::vector<Mat4x4> randomMatrices(uint64_t seed) {
+		Random random(seed);
+		std::vector<Mat4x4> values(batchSize);
+		for (Mat4x4& value : values) {
+			const Quaternion rotation = Quaternion::fromEuler(random.range(-3, 3), random.range(-3, 3), random.range(-3, 3));
+			value = Mat4x4::rotate(rotation) * random.range(0.5f, 2.0f);
+			value.setRow(3, 0, 0, 0, 1);
+			value.setCol(3, random.range(-10, 10), random.range(-10, 10), random.range(-10, 10), 1);
+		}
+		return values;
+	}
+
+	std::vector<Vec4> randomVec4s(uint64_t seed) {
+		Random random(seed);
+		std::vector<Vec4> values(batchSize);
+		for (Vec4& value : values) value = { random.range(-10, 10), random.range(-10, 10), random.range(-10, 10), 1 };
+		return values;
+	}
+
+	std::vector<Vec3> randomVec3s(uint64_t seed) {
+		Random random(seed);
+		std::vector<Vec3> values(batchSize);
+		for (Vec3& value : values) value = { random.range(-10, 10), random.range(-10, 10), random.range(-10, 10) };
+		return values;
+	}
+
+	std::vector<Quaternion> randomRotations(uint64_t seed) {
+		Random random(seed);
+		std::vector<Quaternion> values(batchSize, Quaternion::identity());
+		for (Quaternion& value : values) value = Quaternion::fromEuler(random.range(-3, 3), random.range(-3, 3), random.range(-3, 3));
+		return values;
+	}
+
+	std::vector<float> randomFloats(uint64_t seed) {
+		Random random(seed);
+		std::vector<float> values(batchSize);
+		for (float& value : values) value = random.range(0.5f, 2.0f);
+		return values;
+	}
+}
+
+NWT_BENCHMARK("Mat4x4/mulMat") { runBinary(state, randomMatrices(1), randomMatrices(2), [](const Mat4x4& a, const Mat4x4& b) { return a * b; }); }
+NWT_BENCHMARK("Mat4x4/mulVec") { runBinary(state, randomMatrices(1), randomVec4s(2), [](const Mat4x4& a, const Vec4& b) { return a * b; }); }
+NWT_BENCHMARK("Mat4x4/mulScalar") { runBinary(state, randomMatrices(1), randomFloats(2), [](const Mat4x4& a, float b) { return a * b; }); }
+NWT_BENCHMARK("Mat4x4/transposed") { runUnary(state, randomMatrices(1), [](const Mat4x4& a) { return a.transposed(); }); }
+NWT_BENCHMARK("Mat4x4/determinant") { runUnary(state, randomMatrices(1), [](const Mat4x4& a) { return a.determinant(); }); }
+NWT_BENCHMARK("Mat4x4/inverse") { runUnary(state, randomMatrices(1), [](const Mat4x4& a) { return a.inverse(); }); }
+NWT_BENCHMARK("Mat4x4/affineInverse") { runUnary(state, randomMatrices(1), [](const Mat4x4& a) { return a.affineInverse(); }); }
+NWT_BENCHMARK("Mat4x4/getRow") { runUnary(state, randomMatrices(1), [](const Mat4x4& a) { return a.getRow(1); }); }
+NWT_BENCHMARK("Mat4x4/getCol") { runUnary(state, randomMatrices(1), [](const Mat4x4& a) { return a.getCol(1); }); }
+NWT_BENCHMARK("Mat4x4/equal") { runBinary(state, randomMatrices(1), randomMatrices(2), [](const Mat4x4& a, const Mat4x4& b) { return a == b; }); }
+NWT_BENCHMARK("Mat4x4/rotate") { runUnary(state, randomRotations(1), [](const Quaternion& q) { return Mat4x4::rotate(q); }); }
+NWT_BENCHMARK("Mat4x4/ortho") { runUnary(state, randomFloats(1), [](float size) { return Mat4x4::ortho(-size, size, -size, size, 0.1f, 100.0f); }); }
+NWT_BENCHMARK("Mat4x4/perspective") { runUnary(state, randomFloats(1), [](float fov) { return Mat4x4::perspective(fov, 1.77f, 0.1f, 100.0f); }); }
+NWT_BENCHMARK("Mat4x4/lookAt") { runBinary(state, randomVec3s(1), randomVec3s(2), [](const Vec3& pos, const Vec3& target) { return Mat4x4::lookAt(pos, target); }); }
+
+NWT_BENCHMARK("Mat4x4/transformPoints") {
+	const Mat4x4 mat = randomMatrices(1)[0];
+	const std::vector<Vec3> points = randomVec3s(2);
+	std::vector<Vec3> out(points.size());
+	runBatch(state, points.size(), [&] { transformPoints(mat, points, out); });
+}
+
+NWT_BENCHMARK("Mat4x4/transformDirections") {
+	const Mat4x4 mat = randomMatrices(1)[0];
+	const std::vector<Vec3> directions = randomVec3s(2);
+	std::vector<Vec3> out(directions.size());
+	runBatch(state, directions.size(), [&] { transformDirections(mat, directions, out); });
+}
+
+// Scalar reference for transformPoints
+NWT_BENCHMARK("Mat4x4/transformPointsScalar") {
+	const Mat4x4 mat = randomMatrices(1)[0];
+	runUnary(state, randomVec3s(2), [&](const Vec3& p) { return static_cast<Vec3>(mat * Vec4(p.x, p.y, p.z, 1)); });
+}
+
+NWT_BENCHMARK("Mat4x4d/mulMat") {
+	std::vector<Mat4x4d> a, b;
+	for (const Mat4x4& mat : randomMatrices(1)) a.emplace_back(mat);
+	for (const Mat4x4& mat : randomMatrices(2)) b.emplace_back(mat);
+	runBinary(state, a, b, [](const Mat4x4d& x, const Mat4x4d& y) { return x * y; });
+}
@@ -0,0 +1,52 @@
+#include "bench.hpp"
+#include "mathf.hpp"
+
+using namespace nwt;
+using namespace nwt::bench;
+
+namespace {
+	std::vector<float> randomFloats(uint64_t seed, float min, float max) {
+		Random random(seed);
+		std::vector<float> values(batchSize);
+		for (float& value : values) value = random.range(min, max);
+		return values;
+	}
+
+	struct SinCos {
+		float s, c;
+	};
+}
+
+NWT_BENCHMARK("Mathf/sqrt") { runUnary(state, randomFloats(1, 0.01f, 100), [](float x) { return Mathf::sqrt(x); }); }
+NWT_BENCHMARK("Mathf/rsqrt") { runUnary(state, randomFloats(1, 0.01f, 100), [](float x) { return Mathf::rsqrt(x); }); }
+NWT_BENCHMARK("Mathf/sin") { runUnary(state, randomFloats(1, -10, 10), [](float x) { return Mathf::sin(x); }); }
+NWT_BENCHMARK("Mathf/cos") { runUnary(state, randomFloats(1, -10, 10), [](float x) { return Mathf::cos(x); }); }
+NWT_BENCHMARK("Mathf/tan") { runUnary(state, randomFloats(1, -1.5f, 1.5f), [](float x) { return Mathf::tan(x); }); }
+NWT_BENCHMARK("Mathf/asin") { runUnary(state, randomFloats(1, -1, 1), [](float x) { return Mathf::asin(x); }); }
+NWT_BENCHMARK("Mathf/acos") { runUnary(state, randomFloats(1, -1, 1), [](float x) { return Mathf::acos(x); }); }
+NWT_BENCHMARK("Mathf/atan") { runUnary(state, randomFloats(1, -10, 10), [](float x) { return Mathf::atan(x); }); }
+NWT_BENCHMARK("Mathf/atan2") { runBinary(state, randomFloats(1, -10, 10), randomFloats(2, -10, 10), [](float y, float x) { return Mathf::atan2(y, x); }); }
+NWT_BENCHMARK("Mathf/pow") { runBinary(state, randomFloats(1, 0.1f, 10), randomFloats(2, -2, 2), [](float a, float n) { return Mathf::pow(a, n); }); }
+NWT_BENCHMARK("Mathf/sincos") { runUnary(state, randomFloats(1, -10, 10), [](float x) { SinCos r; Mathf::sincos(x, r.s, r.c); return r; }); }
+NWT_BENCHMARK("Mathf/fastSincos") { runUnary(state, randomFloats(1, -10, 10), [](float x) { SinCos r; Mathf::fastSincos(x, r.s, r.c); return r; }); }
+NWT_BENCHMARK("Mathf/fastSin") { runUnary(state, randomFloats(1, -10, 10), [](float x) { return Mathf::fastSin(x); }); }
+NWT_BENCHMARK("Mathf/fastAtan2") { runBinary(state, randomFloats(1, -10, 10), randomFloats(2, -10, 10), [](float y, float x) { return Mathf::fastAtan2(y, x); }); }
+
+NWT_BENCHMARK("Mathf/fastSincosBatch") {
+	const std::vector<float> x = randomFloats(1, -10, 10);
+	std::vector<float> s(x.size()), c(x.size());
+	runBatch(state, x.size(), [&] { Mathf::fastSincos(x, s, c); });
+}
+
+NWT_BENCHMARK("Mathf/fastAtan2Batch") {
+	const std::vector<float> y = randomFloats(1, -10, 10);
+	const std::vector<float> x = randomFloats(2, -10, 10);
+	std::vector<float> out(x.size());
+	runBatch(state, x.size(), [&] { Mathf::fastAtan2(y, x, out); });
+}
+
+NWT_BENCHMARK("Mathf/rsqrtBatch") {
+	const std::vector<float> x = randomFloats(1, 0.01f, 100);
+	std::vector<float> out(x.size());
+	runBatch(state, x.size(), [&] { Mathf::rsqrt(x, out); });
+}
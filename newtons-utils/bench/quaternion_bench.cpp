@@ -0,0 +1,58 @@
+#include "bench.hpp"
+#include "quaternion.hpp"
+
+using namespace nwt;
+using namespace nwt::bench;
+
+namespace {
+	std::vector<Quaternion> randomRotations(uint64_t seed) {
+		Random random(seed);
+		std::vector<Quaternion> values(batchSize, Quaternion::identity());
+		for (Quaternion& value : values) value = Quaternion::fromEuler(random.range(-3, 3), random.range(-3, 3), random.range(-3, 3));
+		return values;
+	}
+
+	std::vector<Vec3> randomVec3s(uint64_t seed, float range = 10) {
+		Random random(seed);
+		std::vector<Vec3> values(batchSize);
+		for (Vec3& value : values) value = { random.range(-range, range), random.range(-range, range), random.range(-range, range) };
+		return values;
+	}
+}
+
+NWT_BENCHMARK("Quaternion/mul") { runBinary(state, randomRotations(1), randomRotations(2), [](const Quaternion& a, const Quaternion& b) { return a * b; }); }
+NWT_BENCHMARK("Quaternion/mulScalar") { runUnary(state, randomRotations(1), [](const Quaternion& a) { return a * 0.5f; }); }
+NWT_BENCHMARK("Quaternion/add") { runBinary(state, randomRotations(1), randomRotations(2), [](const Quaternion& a, const Quaternion& b) { return a + b; }); }
+NWT_BENCHMARK("Quaternion/dot") { runBinary(state, randomRotations(1), randomRotations(2), [](const Quaternion& a, const Quaternion& b) { return Quaternion::dot(a, b); }); }
+NWT_BENCHMARK("Quaternion/rotateVector") { runBinary(state, randomRotations(1), randomVec3s(2), [](const Quaternion& q, const Vec3& v) { return Quaternion::rotateVector(q, v); }); }
+NWT_BENCHMARK("Quaternion/conjugated") { runUnary(state, randomRotations(1), [](const Quaternion& a) { return a.conjugated(); }); }
+NWT_BENCHMARK("Quaternion/normalized") { runUnary(state, randomRotations(1), [](const Quaternion& a) { return (a * 1.5f).normalized(); }); }
+NWT_BENCHMARK("Quaternion/magnitude") { runUnary(state, randomRotations(1), [](const Quaternion& a) { return a.magnitude(); }); }
+NWT_BENCHMARK("Quaternion/equal") { runBinary(state, randomRotations(1), randomRotations(2), [](const Quaternion& a, const Quaternion& b) { return a == b; }); }
+NWT_BENCHMARK("Quaternion/fromEuler") { runUnary(state, randomVec3s(1, 3), [](const Vec3& e) { return Quaternion::fromEuler(e.x, e.y, e.z); }); }
+NWT_BENCHMARK("Quaternion/fromTo") { runBinary(state, randomVec3s(1), randomVec3s(2), [](const Vec3& a, const Vec3& b) { return Quaternion::fromTo(a, b); }); }
+NWT_BENCHMARK("Quaternion/nlerp") { runBinary(state, randomRotations(1), randomRotations(2), [](const Quaternion& a, const Quaternion& b) { return Quaternion::nlerp(a, b, 0.3f); }); }
+NWT_BENCHMARK("Quaternion/slerp") { runBinary(state, randomRotations(1), randomRotations(2), [](const Quaternion& a, const Quaternion& b) { return Quaternion::slerp(a, b, 0.3f); }); }
+NWT_BENCHMARK("Quaternion/exp") { runUnary(state, randomVec3s(1, 1), [](const Vec3& v) { return Quaternion::exp(v); }); }
+NWT_BENCHMARK("Quaternion/log") { runUnary(state, randomRotations(1), [](const Quaternion& q) { return Quaternion::log(q); }); }
+NWT_BENCHMARK("Quaternion/integrate") { runBinary(state, randomRotations(1), randomVec3s(2, 5), [](const Quaternion& q, const Vec3& w) { return Quaternion::integrate(q, w, 0.016f); }); }
+
+NWT_BENCHMARK("Quaternion/rotateVectors") {
+	const std::vector<Quaternion> rotations = randomRotations(1);
+	const std::vector<Vec3> vectors = randomVec3s(2);
+	std::vector<Vec3> out(vectors.size());
+	runBatch(state, vectors.size(), [&] { rotateVectors(rotations, vectors, out); });
+}
+
+NWT_BENCHMARK("Quaternion/multiplyQuaternions") {
+	const std::vector<Quaternion> a = randomRotations(1);
+	const std::vector<Quaternion> b = randomRotations(2);
+	std::vector<Quaternion> out(a.size(), Quaternion::identity());
+	runBatch(state, a.size(), [&] { multiplyQuaternions(a, b, out); });
+}
+
+NWT_BENCHMARK("Quaternion/integrateOrientations") {
+	std::vector<Quaternion> orientations = randomRotations(1);
+	const std::vector<Vec3> velocities = randomVec3s(2, 5);
+	runBatch(state, orientations.size(), [&] { integrateOrientations(orientations, velocities, 0.016f); });
+}
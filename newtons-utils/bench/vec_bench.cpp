@@ -0,0 +1,96 @@
+#include "bench.hpp"
+#include "vec2.hpp"
+#include "vec3.hpp"
+#include "vec4.hpp"
+
+using namespace nwt;
+using namespace nwt::bench;
+
+namespace {
+	std::vector<float> randomFloats(uint64_t seed) {
+		Random random(seed);
+		std::vector<float> values(batchSize);
+		for (float& value : values) value = random.range(0.1f, 2.0f);
+		return values;
+	}
+
+	std::vector<Vec2> randomVec2s(uint64_t seed) {
+		Random random(seed);
+		std::vector<Vec2> values(batchSize);
+		for (Vec2& value : values) value = { random.range(-10, 10), random.range(-10, 10) };
+		return values;
+	}
+
+	std::vector<Vec3> randomVec3s(uint64_t seed) {
+		Random random(seed);
+		std::vector<Vec3> values(batchSize);
+		for (Vec3& value : values) value = { random.range(-10, 10), random.range(-10, 10), random.range(-10, 10) };
+		return values;
+	}
+
+	std::vector<Vec4> randomVec4s(uint64_t seed) {
+		Random random(seed);
+		std::vector<Vec4> values(batchSize);
+		for (Vec4& value : values) value = { random.range(-10, 10), random.range(-10, 10), random.range(-10, 10), random.range(-10, 10) };
+		return values;
+	}
+}
+
+//
+// Vec2
+//
+
+NWT_BENCHMARK("Vec2/add") { runBinary(state, randomVec2s(1), randomVec2s(2), [](const Vec2& a, const Vec2& b) { return a + b; }); }
+NWT_BENCHMARK("Vec2/sub") { runBinary(state, randomVec2s(1), randomVec2s(2), [](const Vec2& a, const Vec2& b) { return a - b; }); }
+NWT_BENCHMARK("Vec2/mulScalar") { runBinary(state, randomVec2s(1), randomFloats(2), [](const Vec2& a, float b) { return a * b; }); }
+NWT_BENCHMARK("Vec2/divScalar") { runBinary(state, randomVec2s(1), randomFloats(2), [](const Vec2& a, float b) { return a / b; }); }
+NWT_BENCHMARK("Vec2/dot") { runBinary(state, randomVec2s(1), randomVec2s(2), [](const Vec2& a, const Vec2& b) { return Vec2::dot(a, b); }); }
+NWT_BENCHMARK("Vec2/scale") { runBinary(state, randomVec2s(1), randomVec2s(2), [](const Vec2& a, const Vec2& b) { return Vec2::scale(a, b); }); }
+NWT_BENCHMARK("Vec2/lerp") { runBinary(state, randomVec2s(1), randomVec2s(2), [](const Vec2& a, const Vec2& b) { return Vec2::lerp(a, b, 0.3f); }); }
+NWT_BENCHMARK("Vec2/distance") { runBinary(state, randomVec2s(1), randomVec2s(2), [](const Vec2& a, const Vec2& b) { return Vec2::distance(a, b); }); }
+NWT_BENCHMARK("Vec2/angle") { runBinary(state, randomVec2s(1), randomVec2s(2), [](const Vec2& a, const Vec2& b) { return Vec2::angle(a, b); }); }
+NWT_BENCHMARK("Vec2/magnitude") { runUnary(state, randomVec2s(1), [](const Vec2& a) { return a.magnitude(); }); }
+NWT_BENCHMARK("Vec2/normalize") { runUnary(state, randomVec2s(1), [](const Vec2& a) { return Vec2::normalize(a); }); }
+NWT_BENCHMARK("Vec2/equal") { runBinary(state, randomVec2s(1), randomVec2s(2), [](const Vec2& a, const Vec2& b) { return a == b; }); }
+
+//
+// Vec3
+//
+
+NWT_BENCHMARK("Vec3/add") { runBinary(state, randomVec3s(1), randomVec3s(2), [](const Vec3& a, const Vec3& b) { return a + b; }); }
+NWT_BENCHMARK("Vec3/sub") { runBinary(state, randomVec3s(1), randomVec3s(2), [](const Vec3& a, const Vec3& b) { return a - b; }); }
+NWT_BENCHMARK("Vec3/mulScalar") { runBinary(state, randomVec3s(1), randomFloats(2), [](const Vec3& a, float b) { return a * b; }); }
+NWT_BENCHMARK("Vec3/divScalar") { runBinary(state, randomVec3s(1), randomFloats(2), [](const Vec3& a, float b) { return a / b; }); }
+NWT_BENCHMARK("Vec3/dot") { runBinary(state, randomVec3s(1), randomVec3s(2), [](const Vec3& a, const Vec3& b) { return Vec3::dot(a, b); }); }
+NWT_BENCHMARK("Vec3/cross") { runBinary(state, randomVec3s(1), randomVec3s(2), [](const Vec3& a, const Vec3& b) { return Vec3::cross(a, b); }); }
+NWT_BENCHMARK("Vec3/scale") { runBinary(state, randomVec3s(1), randomVec3s(2), [](const Vec3& a, const Vec3& b) { return Vec3::scale(a, b); }); }
+NWT_BENCHMARK("Vec3/lerp") { runBinary(state, randomVec3s(1), randomVec3s(2), [](const Vec3& a, const Vec3& b) { return Vec3::lerp(a, b, 0.3f); }); }
+NWT_BENCHMARK("Vec3/distance") { runBinary(state, randomVec3s(1), randomVec3s(2), [](const Vec3& a, const Vec3& b) { return Vec3::distance(a, b); }); }
+NWT_BENCHMARK("Vec3/angle") { runBinary(state, randomVec3s(1), randomVec3s(2), [](const Vec3& a, const Vec3& b) { return Vec3::angle(a, b); }); }
+NWT_BENCHMARK("Vec3/magnitude") { runUnary(state, randomVec3s(1), [](const Vec3& a) { return a.magnitude(); }); }
+NWT_BENCHMARK("Vec3/sqrMagnitude") { runUnary(state, randomVec3s(1), [](const Vec3& a) { return a.sqrMagnitude(); }); }
+NWT_BENCHMARK("Vec3/normalize") { runUnary(state, randomVec3s(1), [](const Vec3& a) { return Vec3::normalize(a); }); }
+NWT_BENCHMARK("Vec3/equal") { runBinary(state, randomVec3s(1), randomVec3s(2), [](const Vec3& a, const Vec3& b) { return a == b; }); }
+NWT_BENCHMARK("Vec3/toVec2") { runUnary(state, randomVec3s(1), [](const Vec3& a) { return static_cast<Vec2>(a); }); }
+NWT_BENCHMARK("Vec3Packed/fromVec3") { runUnary(state, randomVec3s(1), [](const Vec3& a) { return Vec3Packed(a); }); }
+NWT_BENCHMARK("Vec3Packed/toVec3") {
+	const std::vector<Vec3> vectors = randomVec3s(1);
+	const std::vector<Vec3Packed> packed(vectors.begin(), vectors.end());
+	runUnary(state, packed, [](const Vec3Packed& a) { return static_cast<Vec3>(a); });
+}
+
+//
+// Vec4
+//
+
+NWT_BENCHMARK("Vec4/add") { runBinary(state, randomVec4s(1), randomVec4s(2), [](const Vec4& a, const Vec4& b) { return a + b; }); }
+NWT_BENCHMARK("Vec4/sub") { runBinary(state, randomVec4s(1), randomVec4s(2), [](const Vec4& a, const Vec4& b) { return a - b; }); }
+NWT_BENCHMARK("Vec4/mulScalar") { runBinary(state, randomVec4s(1), randomFloats(2), [](const Vec4& a, float b) { return a * b; }); }
+NWT_BENCHMARK("Vec4/divScalar") { runBinary(state, randomVec4s(1), randomFloats(2), [](const Vec4& a, float b) { return a / b; }); }
+NWT_BENCHMARK("Vec4/dot") { runBinary(state, randomVec4s(1), randomVec4s(2), [](const Vec4& a, const Vec4& b) { return Vec4::dot(a, b); }); }
+NWT_BENCHMARK("Vec4/scale") { runBinary(state, randomVec4s(1), randomVec4s(2), [](const Vec4& a, const Vec4& b) { return Vec4::scale(a, b); }); }
+NWT_BENCHMARK("Vec4/lerp") { runBinary(state, randomVec4s(1), randomVec4s(2), [](const Vec4& a, const Vec4& b) { return Vec4::lerp(a, b, 0.3f); }); }
+NWT_BENCHMARK("Vec4/distance") { runBinary(state, randomVec4s(1), randomVec4s(2), [](const Vec4& a, const Vec4& b) { return Vec4::distance(a, b); }); }
+NWT_BENCHMARK("Vec4/magnitude") { runUnary(state, randomVec4s(1), [](const Vec4& a) { return a.magnitude(); }); }
+NWT_BENCHMARK("Vec4/normalize") { runUnary(state, randomVec4s(1), [](const Vec4& a) { return Vec4::normalize(a); }); }
+NWT_BENCHMARK("Vec4/equal") { runBinary(state, randomVec4s(1), randomVec4s(2), [](const Vec4& a, const Vec4& b) { return a == b; }); }
@@ -1,11 +1,43 @@
 #pragma once
 
+#include <bit>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+#include <intrin.h>
+#endif
 
 namespace nwt{
 class Hash {
 public:
 	static void HashCombine(size_t& lhs, size_t rhs);
+
+	/// <summary>
+	/// Hashes the raw bits of the components with wyhash style multiply mixing, floats are packed two per 64 bit word.
+	/// -0.0 is hashed as +0.0 so components comparing equal hash equal.
+	/// </summary>
+	template<std::floating_point... T>
+	static size_t HashFloats(T... values);
+
+	/// <summary>
+	/// Hashes size bytes with the same mixing as HashFloats, 16 bytes per multiply. Used for content hashes of files.
+	/// </summary>
+	static uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0);
+
+	template<std::floating_point T>
+	static constexpr uint64_t CanonicalBits(T value);
+
+	// 64x64 -> 128 bit multiply folded back to 64 bits
+	static uint64_t Mix(uint64_t a, uint64_t b);
+
+private:
+	static constexpr uint64_t _p0 = 0xa0761d6478bd642full;
+	static constexpr uint64_t _p1 = 0xe7037ed1a0b428dbull;
+	static constexpr uint64_t _p2 = 0x8ebc6af09c88c6e3ull;
+	static constexpr uint64_t _p3 = 0x589965cc75374cc3ull;
 };
 
 inline void Hash::HashCombine(size_t& lhs, size_t rhs) {
@@ -16,4 +48,93 @@ inline void Hash::HashCombine(size_t& lhs, size_t rhs) {
 		lhs ^= rhs + static_cast<size_t>(0x9e3779b9) + (lhs << 6) + (lhs >> 2);
 	}
 }
-}
\ No newline at end of file
+
+template<std::floating_point T>
+inline constexpr uint64_t Hash::CanonicalBits(T value) {
+	// -0.0 == 0.0, so both map to the bits of +0.0
+	const T canonical = value == 0 ? T(0) : value;
+	if constexpr (sizeof(T) == 4) {
+		return std::bit_cast<uint32_t>(canonical);
+	}
+	else {
+		return std::bit_cast<uint64_t>(canonical);
+	}
+}
+
+inline uint64_t Hash::Mix(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+	const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+	return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	uint64_t high;
+	const uint64_t low = _umul128(a, b, &high);
+	return low ^ high;
+#else
+	const uint64_t aLow = a & 0xffffffff, aHigh = a >> 32;
+	const uint64_t bLow = b & 0xffffffff, bHigh = b >> 32;
+	const uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh, highLow = aHigh * bLow, highHigh = aHigh * bHigh;
+	const uint64_t middle = (lowLow >> 32) + (lowHigh & 0xffffffff) + (highLow & 0xffffffff);
+	const uint64_t low = (lowLow & 0xffffffff) | (middle << 32);
+	const uint64_t high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+	return low ^ high;
+#endif
+}
+
+template<std::floating_point... T>
+inline size_t Hash::HashFloats(T... values) {
+	const uint64_t bits[] = { CanonicalBits(values)... };
+	const size_t widths[] = { sizeof(T)... };
+
+	uint64_t state = _p0 ^ sizeof...(T);
+	uint64_t pending = 0;
+	bool hasPending = false;
+	// Words are consumed in pairs, one multiply per 128 bits of input
+	const auto consume = [&](uint64_t word) {
+		if (hasPending) {
+			state = Mix(pending ^ _p1, word ^ state);
+		}
+		else {
+			pending = word;
+		}
+		hasPending = !hasPending;
+	};
+
+	uint64_t word = 0;
+	size_t filled = 0;
+	for (size_t i = 0; i < sizeof...(T); i++) {
+		if (filled + widths[i] > 8) {
+			consume(word);
+			word = 0;
+			filled = 0;
+		}
+		word |= bits[i] << (filled * 8);
+		filled += widths[i];
+	}
+	consume(word);
+
+	if (hasPending) {
+		state = Mix(pending ^ _p1, state ^ _p2);
+	}
+	return static_cast<size_t>(Mix(state ^ _p3, sizeof...(T) ^ _p0));
+}
+
+inline uint64_t Hash::HashBytes(const void* data, size_t size, uint64_t seed) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	const auto read = [](const unsigned char* from, size_t count) {
+		uint64_t word = 0;
+		std::memcpy(&word, from, count);
+		return word;
+	};
+
+	uint64_t state = seed ^ _p0;
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16) {
+		state = Mix(read(bytes + i, 8) ^ _p1, read(bytes + i + 8, 8) ^ state);
+	}
+	const size_t rest = size - i;
+	const uint64_t low = read(bytes + i, rest < 8 ? rest : 8);
+	const uint64_t high = rest > 8 ? read(bytes + i + 8, rest - 8) : 0;
+	state = Mix(low ^ _p1, high ^ state ^ _p2);
+	return Mix(state ^ _p3, size ^ _p0);
+}
+}
@@ -3,81 +3,129 @@
 #include "vec4.hpp"
 #include "hash.hpp"
 #include "quaternion.hpp"
+#include "simd.hpp"
 
 #include <array>
+#include <cstddef>
+#include <span>
+#include <type_traits>
 #include <string>
 
 namespace nwt {
-	struct alignas(16) Mat4x4 {
+	template<typename T>
+	struct alignas(4 * sizeof(T)) Mat4x4T {
 		// float m00, m01, m02, m03; // switching cols with rows here may be a better memory layout,
 		// float m10, m11, m12, m13; // because cols are more frequently accessed.
 		// float m20, m21, m22, m23; //
 		// float m30, m31, m32, m33; //
 
-		float m00, m10, m20, m30;
-		float m01, m11, m21, m31;
-		float m02, m12, m22, m32;
-		float m03, m13, m23, m33;
+		T m00, m10, m20, m30;
+		T m01, m11, m21, m31;
+		T m02, m12, m22, m32;
+		T m03, m13, m23, m33;
 
-		constexpr Mat4x4(const Vec4& col0, const Vec4& col1, const Vec4& col2, const Vec4& col3)
+		constexpr Mat4x4T(const Vec4T<T>& col0, const Vec4T<T>& col1, const Vec4T<T>& col2, const Vec4T<T>& col3)
 			:	m00(col0.x), m10(col0.y), m20(col0.z), m30(col0.w),
 				m01(col1.x), m11(col1.y), m21(col1.z), m31(col1.w),
 				m02(col2.x), m12(col2.y), m22(col2.z), m32(col2.w),
 				m03(col3.x), m13(col3.y), m23(col3.z), m33(col3.w) {}
 
-		constexpr Mat4x4(float m00, float m10, float m20, float m30,
-						 float m01, float m11, float m21, float m31,
-						 float m02, float m12, float m22, float m32,
-						 float m03, float m13, float m23, float m33)
+		constexpr Mat4x4T(T m00, T m10, T m20, T m30,
+						 T m01, T m11, T m21, T m31,
+						 T m02, T m12, T m22, T m32,
+						 T m03, T m13, T m23, T m33)
 						 : m00(m00), m10(m10), m20(m20), m30(m30),
 						   m01(m01), m11(m11), m21(m21), m31(m31),
 						   m02(m02), m12(m12), m22(m22), m32(m32),
 						   m03(m03), m13(m13), m23(m23), m33(m33) {}
 
-		Mat4x4()
+		constexpr Mat4x4T()
 			: m00(0), m10(0), m20(0), m30(0),
 			m01(0), m11(0), m21(0), m31(0),
 			m02(0), m12(0), m22(0), m32(0),
 			m03(0), m13(0), m23(0), m33(0) {}
 
+		template<typename U>
+		explicit constexpr Mat4x4T(const Mat4x4T<U>& other)
+			:	m00(static_cast<T>(other.m00)), m10(static_cast<T>(other.m10)), m20(static_cast<T>(other.m20)), m30(static_cast<T>(other.m30)),
+				m01(static_cast<T>(other.m01)), m11(static_cast<T>(other.m11)), m21(static_cast<T>(other.m21)), m31(static_cast<T>(other.m31)),
+				m02(static_cast<T>(other.m02)), m12(static_cast<T>(other.m12)), m22(static_cast<T>(other.m22)), m32(static_cast<T>(other.m32)),
+				m03(static_cast<T>(other.m03)), m13(static_cast<T>(other.m13)), m23(static_cast<T>(other.m23)), m33(static_cast<T>(other.m33)) {}
+
 		// Mat4x4() {}
 
-		static constexpr Mat4x4 identity();
-		static constexpr Mat4x4 rotate(const Quaternion& q);
-		constexpr Mat4x4 transposed() const;
+		static constexpr Mat4x4T identity();
+		static constexpr Mat4x4T rotate(const QuaternionT<T>& q);
+		constexpr Mat4x4T transposed() const;
+
+		constexpr T determinant() const;
+		/// <summary>
+		/// General inverse, the matrix is assumed to be invertible
+		/// </summary>
+		constexpr Mat4x4T inverse() const;
+		/// <summary>
+		/// Inverse of a matrix whose last row is (0, 0, 0, 1), e.g. any translation, rotation and scale combination
+		/// </summary>
+		constexpr Mat4x4T affineInverse() const;
 
-		constexpr float& getValue(char row, char col);
-		constexpr float getValue(char row, char col) const;
+		constexpr T& getValue(char row, char col);
+		constexpr T getValue(char row, char col) const;
 
-		constexpr Vec4 getRow(char row) const;
-		constexpr Vec4 getCol(char col) const;
+		constexpr Vec4T<T> getRow(char row) const;
+		constexpr Vec4T<T> getCol(char col) const;
 
-		void setRow(char row, float x, float y, float z, float w);
-		void setRow(char row, const Vec4& value);
+		constexpr void setRow(char row, T x, T y, T z, T w);
+		constexpr void setRow(char row, const Vec4T<T>& value);
 
-		void setCol(char col, float x, float y, float z, float w);
-		void setCol(char col, const Vec4& value);
+		constexpr void setCol(char col, T x, T y, T z, T w);
+		constexpr void setCol(char col, const Vec4T<T>& value);
 
-		static constexpr Mat4x4 ortho(float left, float right, float top, float bottom, float near, float far);
-		static Mat4x4 perspective(float fov, float aspect, float near, float far);
+		static constexpr Mat4x4T ortho(T left, T right, T top, T bottom, T near, T far);
+		static constexpr Mat4x4T perspective(T fov, T aspect, T near, T far);
 
-		static Mat4x4 lookAt(const Vec3& pos, const Vec3& target);
+		static constexpr Mat4x4T lookAt(const Vec3T<T>& pos, const Vec3T<T>& target);
 
-		constexpr bool operator==(const Mat4x4& mat) const;
-		constexpr bool operator!=(const Mat4x4& mat) const;
+		constexpr bool operator==(const Mat4x4T& mat) const;
+		constexpr bool operator!=(const Mat4x4T& mat) const;
 
-		constexpr Mat4x4 operator*(const Mat4x4& other) const;
-		constexpr Vec4 operator*(const Vec4& vec) const;
-		constexpr Mat4x4 operator*(float scalar) const;
-		friend constexpr Mat4x4 operator*(float scalar, const Mat4x4& mat);
+		constexpr Mat4x4T operator*(const Mat4x4T& other) const;
+		constexpr Vec4T<T> operator*(const Vec4T<T>& vec) const;
+		constexpr Mat4x4T operator*(T scalar) const;
+		friend constexpr Mat4x4T operator*(T scalar, const Mat4x4T& mat) { return mat * scalar; }
 
-		constexpr float& operator[](char n);
-		constexpr float operator[](char n) const;
+		constexpr T& operator[](char n);
+		constexpr T operator[](char n) const;
 
 		std::string toString() const;
 	};
 
-	inline constexpr Mat4x4 Mat4x4::identity() {
+	using Mat4x4 = Mat4x4T<float>;
+	using Mat4x4d = Mat4x4T<double>;
+
+	/// <summary>
+	/// Transforms every point of in by the affine part of mat (w = 1) and writes it to out.
+	/// out must hold at least in.size() elements and may be the same span as in.
+	/// </summary>
+	void transformPoints(const Mat4x4T<float>& mat, std::span<const Vec3T<float>> in, std::span<Vec3T<float>> out);
+	void transformPoints(const Mat4x4T<double>& mat, std::span<const Vec3T<double>> in, std::span<Vec3T<double>> out);
+	/// <summary>
+	/// Transforms every direction of in by the 3x3 part of mat (w = 0) and writes it to out.
+	/// out must hold at least in.size() elements and may be the same span as in.
+	/// </summary>
+	void transformDirections(const Mat4x4T<float>& mat, std::span<const Vec3T<float>> in, std::span<Vec3T<float>> out);
+	void transformDirections(const Mat4x4T<double>& mat, std::span<const Vec3T<double>> in, std::span<Vec3T<double>> out);
+	/// <summary>
+	/// The same for tightly packed vertex positions, without converting them to Vec3 first.
+	/// </summary>
+	void transformPoints(const Mat4x4T<float>& mat, std::span<const Vec3Packed> in, std::span<Vec3Packed> out);
+	void transformDirections(const Mat4x4T<float>& mat, std::span<const Vec3Packed> in, std::span<Vec3Packed> out);
+
+	// The SIMD kernels load the columns straight from m00, m01, m02 and m03.
+	static_assert(sizeof(Mat4x4) == 16 * sizeof(float), "Mat4x4 must be 16 tightly packed floats");
+	static_assert(sizeof(Mat4x4d) == 16 * sizeof(double), "Mat4x4d must be 16 tightly packed doubles");
+
+	template<typename T>
+	inline constexpr Mat4x4T<T> Mat4x4T<T>::identity() {
 		return {
 			{1,0,0,0},
 			{0,1,0,0},
@@ -86,21 +134,22 @@ namespace nwt {
 		};
 	}
 
-	inline constexpr Mat4x4 Mat4x4::rotate(const Quaternion& q) {
-		float num = q.x * 2;
-		float num2 = q.y * 2;
-		float num3 = q.z * 2;
-		float num4 = q.x * num;
-		float num5 = q.y * num2;
-		float num6 = q.z * num3;
-		float num7 = q.x * num2;
-		float num8 = q.x * num3;
-		float num9 = q.y * num3;
-		float num10 = q.w * num;
-		float num11 = q.w * num2;
-		float num12 = q.w * num3;
-
-		return Mat4x4{
+	template<typename T>
+	inline constexpr Mat4x4T<T> Mat4x4T<T>::rotate(const QuaternionT<T>& q) {
+		T num = q.x * 2;
+		T num2 = q.y * 2;
+		T num3 = q.z * 2;
+		T num4 = q.x * num;
+		T num5 = q.y * num2;
+		T num6 = q.z * num3;
+		T num7 = q.x * num2;
+		T num8 = q.x * num3;
+		T num9 = q.y * num3;
+		T num10 = q.w * num;
+		T num11 = q.w * num2;
+		T num12 = q.w * num3;
+
+		return Mat4x4T<T>{
 			1 - (num5 + num6),
 			num7 + num12,
 			num8 - num11,
@@ -123,8 +172,9 @@ namespace nwt {
 		};
 	}
 
-	inline constexpr Mat4x4 Mat4x4::transposed() const{
-		Mat4x4 result;
+	template<typename T>
+	inline constexpr Mat4x4T<T> Mat4x4T<T>::transposed() const{
+		Mat4x4T<T> result;
 
 		result.setRow(0, getCol(0));
 		result.setRow(1, getCol(1));
@@ -135,15 +185,227 @@ namespace nwt {
 	}
 
 
-	inline constexpr float& Mat4x4::getValue(char row, char col) {
+	template<typename T>
+	inline constexpr T Mat4x4T<T>::determinant() const {
+		T s0 = m00 * m11 - m01 * m10;
+		T s1 = m00 * m12 - m02 * m10;
+		T s2 = m00 * m13 - m03 * m10;
+		T s3 = m01 * m12 - m02 * m11;
+		T s4 = m01 * m13 - m03 * m11;
+		T s5 = m02 * m13 - m03 * m12;
+
+		T c5 = m22 * m33 - m23 * m32;
+		T c4 = m21 * m33 - m23 * m31;
+		T c3 = m21 * m32 - m22 * m31;
+		T c2 = m20 * m33 - m23 * m30;
+		T c1 = m20 * m32 - m22 * m30;
+		T c0 = m20 * m31 - m21 * m30;
+
+		return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+	}
+
+	template<typename T>
+	inline constexpr Mat4x4T<T> Mat4x4T<T>::inverse() const {
+#if defined(NWT_SIMD_SSE)
+		if constexpr (std::is_same_v<T, float>) {
+			if !consteval {
+				// Block wise inversion on the 2x2 sub matrices A B / C D of the column major layout,
+				// the inverse of the transposed layout is the transposed inverse, so it works on columns as well.
+				const __m128 c0 = _mm_load_ps(&m00);
+				const __m128 c1 = _mm_load_ps(&m01);
+				const __m128 c2 = _mm_load_ps(&m02);
+				const __m128 c3 = _mm_load_ps(&m03);
+
+				auto swizzle = [](__m128 v, auto mask) {
+					return _mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(v), decltype(mask)::value));
+				};
+				using s0303 = std::integral_constant<int, _MM_SHUFFLE(3, 0, 3, 0)>;
+				using s1212 = std::integral_constant<int, _MM_SHUFFLE(1, 2, 1, 2)>;
+				using s2301 = std::integral_constant<int, _MM_SHUFFLE(2, 3, 0, 1)>;
+				using s0033 = std::integral_constant<int, _MM_SHUFFLE(0, 0, 3, 3)>;
+				using s2211 = std::integral_constant<int, _MM_SHUFFLE(2, 2, 1, 1)>;
+				using s1032 = std::integral_constant<int, _MM_SHUFFLE(1, 0, 3, 2)>;
+				using s0303r = std::integral_constant<int, _MM_SHUFFLE(0, 3, 0, 3)>;
+				using s3120 = std::integral_constant<int, _MM_SHUFFLE(3, 1, 2, 0)>;
+
+				// 2x2 products A * B, A# * B and A * B# with A# being the adjugate
+				auto mul2 = [&](__m128 a, __m128 b) {
+					return _mm_add_ps(_mm_mul_ps(a, swizzle(b, s0303{})), _mm_mul_ps(swizzle(a, s2301{}), swizzle(b, s1212{})));
+				};
+				auto adjMul2 = [&](__m128 a, __m128 b) {
+					return _mm_sub_ps(_mm_mul_ps(swizzle(a, s0033{}), b), _mm_mul_ps(swizzle(a, s2211{}), swizzle(b, s1032{})));
+				};
+				auto mulAdj2 = [&](__m128 a, __m128 b) {
+					return _mm_sub_ps(_mm_mul_ps(a, swizzle(b, s0303r{})), _mm_mul_ps(swizzle(a, s2301{}), swizzle(b, s1212{})));
+				};
+
+				const __m128 a = _mm_movelh_ps(c0, c1);
+				const __m128 b = _mm_movehl_ps(c1, c0);
+				const __m128 c = _mm_movelh_ps(c2, c3);
+				const __m128 d = _mm_movehl_ps(c3, c2);
+
+				// (|A|, |B|, |C|, |D|)
+				const __m128 detSub = _mm_sub_ps(
+					_mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(3, 1, 3, 1))),
+					_mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(2, 0, 2, 0)))
+				);
+				const __m128 detA = simd::broadcast<0>(detSub);
+				const __m128 detB = simd::broadcast<1>(detSub);
+				const __m128 detC = simd::broadcast<2>(detSub);
+				const __m128 detD = simd::broadcast<3>(detSub);
+
+				const __m128 dc = adjMul2(d, c);
+				const __m128 ab = adjMul2(a, b);
+
+				__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), mul2(b, dc));
+				__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), mul2(c, ab));
+				__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), mulAdj2(d, ab));
+				__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), mulAdj2(a, dc));
+
+				// |M| = |A| |D| + |B| |C| - tr((A# B)(D# C))
+				const T trace = simd::hsum(_mm_mul_ps(ab, swizzle(dc, s3120{})));
+				const __m128 det = _mm_set1_ps(_mm_cvtss_f32(_mm_add_ss(_mm_mul_ss(detA, detD), _mm_mul_ss(detB, detC))) - trace);
+				const __m128 invDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+
+				x = _mm_mul_ps(x, invDet);
+				y = _mm_mul_ps(y, invDet);
+				z = _mm_mul_ps(z, invDet);
+				w = _mm_mul_ps(w, invDet);
+
+				Mat4x4T<T> result;
+				_mm_store_ps(&result.m00, _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+				_mm_store_ps(&result.m01, _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+				_mm_store_ps(&result.m02, _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+				_mm_store_ps(&result.m03, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+				return result;
+			}
+		}
+#endif
+#if defined(NWT_SIMD_AVX2)
+		if constexpr (std::is_same_v<T, double>) {
+			if !consteval {
+				// The cofactor expansion below with each row in one register, the swizzles line up
+				// the elements whose 2x2 minors make up the cofactors of a whole row at once.
+				simd::f64x4 r0 = simd::load(&m00);
+				simd::f64x4 r1 = simd::load(&m01);
+				simd::f64x4 r2 = simd::load(&m02);
+				simd::f64x4 r3 = simd::load(&m03);
+				simd::transpose4(r0, r1, r2, r3);
+
+				// (e1, e0, e0, e0), (e2, e2, e1, e1) and (e3, e3, e3, e2) of a row (e0, e1, e2, e3)
+				auto a = [](simd::f64x4 v) { return _mm256_permute4x64_pd(v, _MM_SHUFFLE(0, 0, 0, 1)); };
+				auto b = [](simd::f64x4 v) { return _mm256_permute4x64_pd(v, _MM_SHUFFLE(1, 1, 2, 2)); };
+				auto d = [](simd::f64x4 v) { return _mm256_permute4x64_pd(v, _MM_SHUFFLE(2, 3, 3, 3)); };
+				auto minors = [](simd::f64x4 x0, simd::f64x4 y0, simd::f64x4 x1, simd::f64x4 y1) {
+					return simd::sub(simd::mul(x0, y1), simd::mul(y0, x1));
+				};
+				// Cofactors of the row r paired with the minors of the two other rows, up to the alternating sign
+				auto cofactors = [&](simd::f64x4 r, simd::f64x4 bd, simd::f64x4 ad, simd::f64x4 ab) {
+					return simd::madd(d(r), ab, simd::sub(simd::mul(a(r), bd), simd::mul(b(r), ad)));
+				};
+
+				const simd::f64x4 s1 = minors(b(r0), d(r0), b(r1), d(r1));
+				const simd::f64x4 s2 = minors(a(r0), d(r0), a(r1), d(r1));
+				const simd::f64x4 s3 = minors(a(r0), b(r0), a(r1), b(r1));
+				const simd::f64x4 c1 = minors(b(r2), d(r2), b(r3), d(r3));
+				const simd::f64x4 c2 = minors(a(r2), d(r2), a(r3), d(r3));
+				const simd::f64x4 c3 = minors(a(r2), b(r2), a(r3), b(r3));
+
+				const simd::f64x4 even = _mm256_setr_pd(1.0, -1.0, 1.0, -1.0);
+				const simd::f64x4 odd = _mm256_setr_pd(-1.0, 1.0, -1.0, 1.0);
+				const simd::f64x4 col0 = simd::mul(even, cofactors(r1, c1, c2, c3));
+				const simd::f64x4 col1 = simd::mul(odd, cofactors(r0, c1, c2, c3));
+				const simd::f64x4 col2 = simd::mul(even, cofactors(r3, s1, s2, s3));
+				const simd::f64x4 col3 = simd::mul(odd, cofactors(r2, s1, s2, s3));
+
+				const simd::f64x4 invDet = simd::splat(T(1) / simd::dot(r0, col0));
+
+				Mat4x4T<T> result;
+				simd::store(&result.m00, simd::mul(col0, invDet));
+				simd::store(&result.m01, simd::mul(col1, invDet));
+				simd::store(&result.m02, simd::mul(col2, invDet));
+				simd::store(&result.m03, simd::mul(col3, invDet));
+				return result;
+			}
+		}
+#endif
+		// Cofactor expansion over the 2x2 minors of the upper and lower two rows
+		T s0 = m00 * m11 - m01 * m10;
+		T s1 = m00 * m12 - m02 * m10;
+		T s2 = m00 * m13 - m03 * m10;
+		T s3 = m01 * m12 - m02 * m11;
+		T s4 = m01 * m13 - m03 * m11;
+		T s5 = m02 * m13 - m03 * m12;
+
+		T c5 = m22 * m33 - m23 * m32;
+		T c4 = m21 * m33 - m23 * m31;
+		T c3 = m21 * m32 - m22 * m31;
+		T c2 = m20 * m33 - m23 * m30;
+		T c1 = m20 * m32 - m22 * m30;
+		T c0 = m20 * m31 - m21 * m30;
+
+		T invDet = T(1) / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+		return {
+			( m11 * c5 - m12 * c4 + m13 * c3) * invDet,
+			(-m10 * c5 + m12 * c2 - m13 * c1) * invDet,
+			( m10 * c4 - m11 * c2 + m13 * c0) * invDet,
+			(-m10 * c3 + m11 * c1 - m12 * c0) * invDet,
+
+			(-m01 * c5 + m02 * c4 - m03 * c3) * invDet,
+			( m00 * c5 - m02 * c2 + m03 * c1) * invDet,
+			(-m00 * c4 + m01 * c2 - m03 * c0) * invDet,
+			( m00 * c3 - m01 * c1 + m02 * c0) * invDet,
+
+			( m31 * s5 - m32 * s4 + m33 * s3) * invDet,
+			(-m30 * s5 + m32 * s2 - m33 * s1) * invDet,
+			( m30 * s4 - m31 * s2 + m33 * s0) * invDet,
+			(-m30 * s3 + m31 * s1 - m32 * s0) * invDet,
+
+			(-m21 * s5 + m22 * s4 - m23 * s3) * invDet,
+			( m20 * s5 - m22 * s2 + m23 * s1) * invDet,
+			(-m20 * s4 + m21 * s2 - m23 * s0) * invDet,
+			( m20 * s3 - m21 * s1 + m22 * s0) * invDet
+		};
+	}
+
+	template<typename T>
+	inline constexpr Mat4x4T<T> Mat4x4T<T>::affineInverse() const {
+		// The rows of the inverted 3x3 part are the cross products of its columns divided by the determinant.
+		Vec3T<T> c0{ m00, m10, m20 };
+		Vec3T<T> c1{ m01, m11, m21 };
+		Vec3T<T> c2{ m02, m12, m22 };
+		Vec3T<T> t{ m03, m13, m23 };
+
+		Vec3T<T> r0 = Vec3T<T>::cross(c1, c2);
+		Vec3T<T> r1 = Vec3T<T>::cross(c2, c0);
+		Vec3T<T> r2 = Vec3T<T>::cross(c0, c1);
+
+		T invDet = T(1) / Vec3T<T>::dot(c0, r0);
+		r0 *= invDet;
+		r1 *= invDet;
+		r2 *= invDet;
+
+		return {
+			r0.x, r1.x, r2.x, 0,
+			r0.y, r1.y, r2.y, 0,
+			r0.z, r1.z, r2.z, 0,
+			-Vec3T<T>::dot(r0, t), -Vec3T<T>::dot(r1, t), -Vec3T<T>::dot(r2, t), 1
+		};
+	}
+
+	template<typename T>
+	inline constexpr T& Mat4x4T<T>::getValue(char row, char col) {
 		return (*this)[row + col * 4];
 	}
 
-	inline constexpr float Mat4x4::getValue(char row, char col) const {
+	template<typename T>
+	inline constexpr T Mat4x4T<T>::getValue(char row, char col) const {
 		return (*this)[row + col * 4];
 	}
 
-	inline constexpr Vec4 Mat4x4::getRow(char row) const {
+	template<typename T>
+	inline constexpr Vec4T<T> Mat4x4T<T>::getRow(char row) const {
 		return{
 			(*this)[row + 0],
 			(*this)[row + 4],
@@ -152,7 +414,8 @@ namespace nwt {
 		};
 	}
 
-	inline constexpr Vec4 Mat4x4::getCol(char col) const {
+	template<typename T>
+	inline constexpr Vec4T<T> Mat4x4T<T>::getCol(char col) const {
 		char c = col * 4;
 		return {
 			(*this)[0 + c],
@@ -162,21 +425,24 @@ namespace nwt {
 		};
 	}
 
-	inline void Mat4x4::setRow(char row, float x, float y, float z, float w){
+	template<typename T>
+	inline constexpr void Mat4x4T<T>::setRow(char row, T x, T y, T z, T w){
 		(*this)[row + 0] = x;
 		(*this)[row + 4] = y;
 		(*this)[row + 8] = z;
 		(*this)[row + 12] = w;
 	}
 
-	inline void Mat4x4::setRow(char row, const Vec4& value){
+	template<typename T>
+	inline constexpr void Mat4x4T<T>::setRow(char row, const Vec4T<T>& value){
 		(*this)[row + 0] = value.x;
 		(*this)[row + 4] = value.y;
 		(*this)[row + 8] = value.z;
 		(*this)[row + 12] = value.w;
 	}
 
-	inline void Mat4x4::setCol(char col, float x, float y, float z, float w){
+	template<typename T>
+	inline constexpr void Mat4x4T<T>::setCol(char col, T x, T y, T z, T w){
 		const char c = col * 4;
 		(*this)[0 + c] = x;
 		(*this)[1 + c] = y;
@@ -184,7 +450,8 @@ namespace nwt {
 		(*this)[3 + c] = w;
 	}
 
-	inline void Mat4x4::setCol(char col, const Vec4& value){
+	template<typename T>
+	inline constexpr void Mat4x4T<T>::setCol(char col, const Vec4T<T>& value){
 		const char c = col * 4;
 		(*this)[0 + c] = value.x;
 		(*this)[1 + c] = value.y;
@@ -192,12 +459,13 @@ namespace nwt {
 		(*this)[3 + c] = value.w;
 	}
 
-	inline constexpr Mat4x4 Mat4x4::ortho(float left, float right, float bottom, float top, float near, float far) {
-		float rml = right - left;
-		float lmr = left - right;
-		float tmb = top - bottom;
-		float bmt = bottom - top;
-		float fmn = far - near;
+	template<typename T>
+	inline constexpr Mat4x4T<T> Mat4x4T<T>::ortho(T left, T right, T bottom, T top, T near, T far) {
+		T rml = right - left;
+		T lmr = left - right;
+		T tmb = top - bottom;
+		T bmt = bottom - top;
+		T fmn = far - near;
 
 		return { 
 			2.0f / rml, 0, 0, 0, 
@@ -207,10 +475,11 @@ namespace nwt {
 		};
 	}
 
-	inline Mat4x4 Mat4x4::perspective(float fov, float aspect, float near, float far) {
-		float tanHalfFOV = Mathf::tan(fov / 2.0f);
+	template<typename T>
+	inline constexpr Mat4x4T<T> Mat4x4T<T>::perspective(T fov, T aspect, T near, T far) {
+		T tanHalfFOV = Mathf::tan(fov / 2.0f);
 		
-		Mat4x4 result;
+		Mat4x4T<T> result;
 
 		result[0] = 1.0f / (aspect * tanHalfFOV);
 		result[5] = 1.0f / (tanHalfFOV);
@@ -227,17 +496,18 @@ namespace nwt {
 
 	}
 
-	inline Mat4x4 Mat4x4::lookAt(const Vec3& pos, const Vec3& target) {
-		Vec3 forward = (target - pos).normalized();
-		Vec3 right = Vec3::cross(Vec3::up(), forward).normalized();
-		Vec3 up = Vec3::cross(forward, right);
+	template<typename T>
+	inline constexpr Mat4x4T<T> Mat4x4T<T>::lookAt(const Vec3T<T>& pos, const Vec3T<T>& target) {
+		Vec3T<T> forward = (target - pos).normalized();
+		Vec3T<T> right = Vec3T<T>::cross(Vec3T<T>::up(), forward).normalized();
+		Vec3T<T> up = Vec3T<T>::cross(forward, right);
 
-		Mat4x4 result;
+		Mat4x4T<T> result;
 
 		result.setRow(0, right.x, right.y, right.z, 0);
 		result.setRow(1, up.x, up.y, up.z, 0);
 		result.setRow(2, forward.x, forward.y, forward.z, 0);
-		result.setCol(3, -Vec3::dot(right, pos), -Vec3::dot(up, pos), -Vec3::dot(forward, pos), 1.0f);
+		result.setCol(3, -Vec3T<T>::dot(right, pos), -Vec3T<T>::dot(up, pos), -Vec3T<T>::dot(forward, pos), 1.0f);
 
 		return result;
 	}
@@ -247,46 +517,113 @@ namespace nwt {
 	// Operators
 	//
 
-	inline constexpr bool Mat4x4::operator==(const Mat4x4& mat) const{
+	template<typename T>
+	inline constexpr bool Mat4x4T<T>::operator==(const Mat4x4T<T>& mat) const{
 		return (Mathf::inEpsilon(m00 - mat.m00) && Mathf::inEpsilon(m10 - mat.m10) && Mathf::inEpsilon(m20 - mat.m20) && Mathf::inEpsilon(m30 - mat.m30) ||
 			Mathf::inEpsilon(m01 - mat.m01) && Mathf::inEpsilon(m11 - mat.m11) && Mathf::inEpsilon(m21 - mat.m21) && Mathf::inEpsilon(m31 - mat.m31) ||
 			Mathf::inEpsilon(m02 - mat.m02) && Mathf::inEpsilon(m12 - mat.m12) && Mathf::inEpsilon(m22 - mat.m22) && Mathf::inEpsilon(m32 - mat.m32) ||
 			Mathf::inEpsilon(m03 - mat.m03) && Mathf::inEpsilon(m13 - mat.m13) && Mathf::inEpsilon(m23 - mat.m23) && Mathf::inEpsilon(m33 - mat.m33));
 	}
 
-	inline constexpr bool Mat4x4::operator!=(const Mat4x4& mat) const{
+	template<typename T>
+	inline constexpr bool Mat4x4T<T>::operator!=(const Mat4x4T<T>& mat) const{
 		return !((*this) == mat);
 	}
 
-	inline constexpr Mat4x4 Mat4x4::operator*(const Mat4x4& other) const {
-		Vec4 r0 = getRow(0);
-		Vec4 r1 = getRow(1);
-		Vec4 r2 = getRow(2);
-		Vec4 r3 = getRow(3);
+	template<typename T>
+	inline constexpr Mat4x4T<T> Mat4x4T<T>::operator*(const Mat4x4T<T>& other) const {
+#if defined(NWT_SIMD_ENABLED)
+		if constexpr (simd::enabled<T>) {
+			if !consteval {
+				Mat4x4T<T> result;
+				const T* a = &m00;
+				const T* b = &other.m00;
+				T* r = &result.m00;
+
+#if defined(NWT_SIMD_AVX2)
+				if constexpr (std::is_same_v<T, float>) {
+					// Two result columns per iteration, each 128 bit lane holds one column.
+					const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 0));
+					const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 4));
+					const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 8));
+					const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 12));
+
+					for (int c = 0; c < 16; c += 8) {
+						const __m256 bc = _mm256_loadu_ps(b + c);
+						__m256 col = _mm256_mul_ps(a0, _mm256_shuffle_ps(bc, bc, 0x00));
+						col = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(bc, bc, 0x55), col);
+						col = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(bc, bc, 0xAA), col);
+						col = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(bc, bc, 0xFF), col);
+						_mm256_storeu_ps(r + c, col);
+					}
+					return result;
+				}
+#endif
+				// One column per register, 4 floats on SSE / NEON and 4 doubles on AVX2.
+				const auto a0 = simd::load(a + 0);
+				const auto a1 = simd::load(a + 4);
+				const auto a2 = simd::load(a + 8);
+				const auto a3 = simd::load(a + 12);
+
+				for (int c = 0; c < 16; c += 4) {
+					const auto bc = simd::load(b + c);
+					auto col = simd::mul(a0, simd::broadcast<0>(bc));
+					col = simd::madd(a1, simd::broadcast<1>(bc), col);
+					col = simd::madd(a2, simd::broadcast<2>(bc), col);
+					col = simd::madd(a3, simd::broadcast<3>(bc), col);
+					simd::store(r + c, col);
+				}
+				return result;
+			}
+		}
+#endif
+		Vec4T<T> r0 = getRow(0);
+		Vec4T<T> r1 = getRow(1);
+		Vec4T<T> r2 = getRow(2);
+		Vec4T<T> r3 = getRow(3);
 
-		Vec4 c0 = other.getCol(0);
-		Vec4 c1 = other.getCol(1);
-		Vec4 c2 = other.getCol(2);
-		Vec4 c3 = other.getCol(3);
+		Vec4T<T> c0 = other.getCol(0);
+		Vec4T<T> c1 = other.getCol(1);
+		Vec4T<T> c2 = other.getCol(2);
+		Vec4T<T> c3 = other.getCol(3);
 
 		return{
-			{Vec4::dot(r0, c0), Vec4::dot(r1, c0), Vec4::dot(r2, c0), Vec4::dot(r3, c0)},
-			{Vec4::dot(r0, c1), Vec4::dot(r1, c1), Vec4::dot(r2, c1), Vec4::dot(r3, c1)},
-			{Vec4::dot(r0, c2), Vec4::dot(r1, c2), Vec4::dot(r2, c2), Vec4::dot(r3, c2)},
-			{Vec4::dot(r0, c3), Vec4::dot(r1, c3), Vec4::dot(r2, c3), Vec4::dot(r3, c3)},
+			{Vec4T<T>::dot(r0, c0), Vec4T<T>::dot(r1, c0), Vec4T<T>::dot(r2, c0), Vec4T<T>::dot(r3, c0)},
+			{Vec4T<T>::dot(r0, c1), Vec4T<T>::dot(r1, c1), Vec4T<T>::dot(r2, c1), Vec4T<T>::dot(r3, c1)},
+			{Vec4T<T>::dot(r0, c2), Vec4T<T>::dot(r1, c2), Vec4T<T>::dot(r2, c2), Vec4T<T>::dot(r3, c2)},
+			{Vec4T<T>::dot(r0, c3), Vec4T<T>::dot(r1, c3), Vec4T<T>::dot(r2, c3), Vec4T<T>::dot(r3, c3)},
 		};
 	}
 
-	inline constexpr Vec4 Mat4x4::operator*(const Vec4& vec) const {
-		Vec4 r0 = getRow(0);
-		Vec4 r1 = getRow(1);
-		Vec4 r2 = getRow(2);
-		Vec4 r3 = getRow(3);
+	template<typename T>
+	inline constexpr Vec4T<T> Mat4x4T<T>::operator*(const Vec4T<T>& vec) const {
+#if defined(NWT_SIMD_ENABLED)
+		if constexpr (simd::enabled<T>) {
+			if !consteval {
+				const T* a = &m00;
+				const auto v = simd::load(&vec.x);
+
+				auto col = simd::mul(simd::load(a + 0), simd::broadcast<0>(v));
+				col = simd::madd(simd::load(a + 4), simd::broadcast<1>(v), col);
+				col = simd::madd(simd::load(a + 8), simd::broadcast<2>(v), col);
+				col = simd::madd(simd::load(a + 12), simd::broadcast<3>(v), col);
+
+				Vec4T<T> result;
+				simd::store(&result.x, col);
+				return result;
+			}
+		}
+#endif
+		Vec4T<T> r0 = getRow(0);
+		Vec4T<T> r1 = getRow(1);
+		Vec4T<T> r2 = getRow(2);
+		Vec4T<T> r3 = getRow(3);
 
-		return { Vec4::dot(r0, vec), Vec4::dot(r1, vec), Vec4::dot(r2, vec), Vec4::dot(r3, vec) };
+		return { Vec4T<T>::dot(r0, vec), Vec4T<T>::dot(r1, vec), Vec4T<T>::dot(r2, vec), Vec4T<T>::dot(r3, vec) };
 	}
 
-	inline constexpr float& Mat4x4::operator[](char n) {
+	template<typename T>
+	inline constexpr T& Mat4x4T<T>::operator[](char n) {
 		switch (n)
 		{
 		case 0:
@@ -326,7 +663,8 @@ namespace nwt {
 		// TODO: Error handling
 	}
 
-	inline constexpr float Mat4x4::operator[](char n) const {
+	template<typename T>
+	inline constexpr T Mat4x4T<T>::operator[](char n) const {
 		switch (n)
 		{
 		case 0:
@@ -367,7 +705,20 @@ namespace nwt {
 	}
 
 
-	inline constexpr Mat4x4 Mat4x4::operator*(float scalar) const{
+	template<typename T>
+	inline constexpr Mat4x4T<T> Mat4x4T<T>::operator*(T scalar) const{
+#if defined(NWT_SIMD_ENABLED)
+		if constexpr (simd::enabled<T>) {
+			if !consteval {
+				Mat4x4T<T> result;
+				const auto s = simd::splat(scalar);
+				for (int c = 0; c < 16; c += 4) {
+					simd::store(&result.m00 + c, simd::mul(simd::load(&m00 + c), s));
+				}
+				return result;
+			}
+		}
+#endif
 		return {
 			m00 * scalar,
 			m10 * scalar,
@@ -391,11 +742,9 @@ namespace nwt {
 		};
 	}
 
-	inline constexpr Mat4x4 operator*(float scalar, const Mat4x4& mat){
-		return mat * scalar;
-	}
 
-	inline std::string Mat4x4::toString() const {
+	template<typename T>
+	inline std::string Mat4x4T<T>::toString() const {
 		return (
 			std::to_string(m00) + ", " + std::to_string(m01) + ", " + std::to_string(m02) + ", " + std::to_string(m03) + "\n" +
 			std::to_string(m10) + ", " + std::to_string(m11) + ", " + std::to_string(m12) + ", " + std::to_string(m13) + "\n" +
@@ -403,32 +752,256 @@ namespace nwt {
 			std::to_string(m30) + ", " + std::to_string(m31) + ", " + std::to_string(m32) + ", " + std::to_string(m33)
 			);
 	}
+	namespace detail {
+		// Vec3 is padded to 16 bytes, so blocks of points are loaded as 4 wide rows and transposed
+		// into x, y and z registers (structure of arrays) before the matrix is applied.
+		// Floats go 8 and 4 per block, doubles 4 per block on AVX2.
+		template<typename T, bool translate>
+		inline void transformVec3s(const Mat4x4T<T>& mat, std::span<const Vec3T<T>> in, std::span<Vec3T<T>> out) {
+			static_assert(sizeof(Vec3T<T>) == 4 * sizeof(T), "Vec3T is expected to be padded to 4 components");
+
+			const size_t count = in.size();
+			size_t i = 0;
+
+			if constexpr (std::is_same_v<T, float>) {
+#if defined(NWT_SIMD_AVX2)
+				{
+					const __m256 m00 = _mm256_set1_ps(mat.m00), m01 = _mm256_set1_ps(mat.m01), m02 = _mm256_set1_ps(mat.m02), m03 = _mm256_set1_ps(mat.m03);
+					const __m256 m10 = _mm256_set1_ps(mat.m10), m11 = _mm256_set1_ps(mat.m11), m12 = _mm256_set1_ps(mat.m12), m13 = _mm256_set1_ps(mat.m13);
+					const __m256 m20 = _mm256_set1_ps(mat.m20), m21 = _mm256_set1_ps(mat.m21), m22 = _mm256_set1_ps(mat.m22), m23 = _mm256_set1_ps(mat.m23);
+					const __m256 zero = _mm256_setzero_ps();
+
+					for (; i + 8 <= count; i += 8) {
+						const T* src = &in[i].x;
+						T* dst = &out[i].x;
+
+						// lane 0 holds the points 0, 2, 4, 6 and lane 1 the points 1, 3, 5, 7,
+						// the transpose back restores the order, so the permutation never shows.
+						__m256 r0 = _mm256_loadu_ps(src + 0);
+						__m256 r1 = _mm256_loadu_ps(src + 8);
+						__m256 r2 = _mm256_loadu_ps(src + 16);
+						__m256 r3 = _mm256_loadu_ps(src + 24);
+
+						__m256 t0 = _mm256_unpacklo_ps(r0, r1);
+						__m256 t1 = _mm256_unpackhi_ps(r0, r1);
+						__m256 t2 = _mm256_unpacklo_ps(r2, r3);
+						__m256 t3 = _mm256_unpackhi_ps(r2, r3);
+
+						const __m256 x = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+						const __m256 y = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+						const __m256 z = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+
+						__m256 ox = _mm256_fmadd_ps(m02, z, _mm256_fmadd_ps(m01, y, translate ? _mm256_fmadd_ps(m00, x, m03) : _mm256_mul_ps(m00, x)));
+						__m256 oy = _mm256_fmadd_ps(m12, z, _mm256_fmadd_ps(m11, y, translate ? _mm256_fmadd_ps(m10, x, m13) : _mm256_mul_ps(m10, x)));
+						__m256 oz = _mm256_fmadd_ps(m22, z, _mm256_fmadd_ps(m21, y, translate ? _mm256_fmadd_ps(m20, x, m23) : _mm256_mul_ps(m20, x)));
+
+						t0 = _mm256_unpacklo_ps(ox, oy);
+						t1 = _mm256_unpackhi_ps(ox, oy);
+						t2 = _mm256_unpacklo_ps(oz, zero);
+						t3 = _mm256_unpackhi_ps(oz, zero);
+
+						_mm256_storeu_ps(dst + 0, _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)));
+						_mm256_storeu_ps(dst + 8, _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)));
+						_mm256_storeu_ps(dst + 16, _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)));
+						_mm256_storeu_ps(dst + 24, _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2)));
+					}
+				}
+#endif
+
+#if defined(NWT_SIMD_ENABLED)
+				{
+					const simd::f32x4 m00 = simd::splat(mat.m00), m01 = simd::splat(mat.m01), m02 = simd::splat(mat.m02), m03 = simd::splat(mat.m03);
+					const simd::f32x4 m10 = simd::splat(mat.m10), m11 = simd::splat(mat.m11), m12 = simd::splat(mat.m12), m13 = simd::splat(mat.m13);
+					const simd::f32x4 m20 = simd::splat(mat.m20), m21 = simd::splat(mat.m21), m22 = simd::splat(mat.m22), m23 = simd::splat(mat.m23);
+
+					for (; i + 4 <= count; i += 4) {
+						const T* src = &in[i].x;
+						T* dst = &out[i].x;
+
+#if defined(NWT_SIMD_SSE)
+						__m128 x = _mm_load_ps(src + 0);
+						__m128 y = _mm_load_ps(src + 4);
+						__m128 z = _mm_load_ps(src + 8);
+						__m128 w = _mm_load_ps(src + 12);
+						_MM_TRANSPOSE4_PS(x, y, z, w);
+#else
+						const float32x4x4_t rows = vld4q_f32(src);
+						const float32x4_t x = rows.val[0], y = rows.val[1], z = rows.val[2];
+#endif
+
+						simd::f32x4 ox = simd::madd(m02, z, simd::madd(m01, y, translate ? simd::madd(m00, x, m03) : simd::mul(m00, x)));
+						simd::f32x4 oy = simd::madd(m12, z, simd::madd(m11, y, translate ? simd::madd(m10, x, m13) : simd::mul(m10, x)));
+						simd::f32x4 oz = simd::madd(m22, z, simd::madd(m21, y, translate ? simd::madd(m20, x, m23) : simd::mul(m20, x)));
+
+#if defined(NWT_SIMD_SSE)
+						__m128 ow = _mm_setzero_ps();
+						_MM_TRANSPOSE4_PS(ox, oy, oz, ow);
+						_mm_store_ps(dst + 0, ox);
+						_mm_store_ps(dst + 4, oy);
+						_mm_store_ps(dst + 8, oz);
+						_mm_store_ps(dst + 12, ow);
+#else
+						vst4q_f32(dst, float32x4x4_t{ { ox, oy, oz, vdupq_n_f32(0.0f) } });
+#endif
+					}
+				}
+#endif
+			}
+#if defined(NWT_SIMD_AVX2)
+			else if constexpr (std::is_same_v<T, double>) {
+				const simd::f64x4 m00 = simd::splat(mat.m00), m01 = simd::splat(mat.m01), m02 = simd::splat(mat.m02), m03 = simd::splat(mat.m03);
+				const simd::f64x4 m10 = simd::splat(mat.m10), m11 = simd::splat(mat.m11), m12 = simd::splat(mat.m12), m13 = simd::splat(mat.m13);
+				const simd::f64x4 m20 = simd::splat(mat.m20), m21 = simd::splat(mat.m21), m22 = simd::splat(mat.m22), m23 = simd::splat(mat.m23);
+
+				for (; i + 4 <= count; i += 4) {
+					const T* src = &in[i].x;
+					T* dst = &out[i].x;
+
+					simd::f64x4 x = simd::load(src + 0);
+					simd::f64x4 y = simd::load(src + 4);
+					simd::f64x4 z = simd::load(src + 8);
+					simd::f64x4 w = simd::load(src + 12);
+					simd::transpose4(x, y, z, w);
+
+					simd::f64x4 ox = simd::madd(m02, z, simd::madd(m01, y, translate ? simd::madd(m00, x, m03) : simd::mul(m00, x)));
+					simd::f64x4 oy = simd::madd(m12, z, simd::madd(m11, y, translate ? simd::madd(m10, x, m13) : simd::mul(m10, x)));
+					simd::f64x4 oz = simd::madd(m22, z, simd::madd(m21, y, translate ? simd::madd(m20, x, m23) : simd::mul(m20, x)));
+					simd::f64x4 ow = _mm256_setzero_pd();
+					simd::transpose4(ox, oy, oz, ow);
+
+					simd::store(dst + 0, ox);
+					simd::store(dst + 4, oy);
+					simd::store(dst + 8, oz);
+					simd::store(dst + 12, ow);
+				}
+			}
+#endif
+
+			for (; i < count; i++) {
+				const Vec3T<T> v = in[i];
+				out[i] = {
+					mat.m00 * v.x + mat.m01 * v.y + mat.m02 * v.z + (translate ? mat.m03 : T(0)),
+					mat.m10 * v.x + mat.m11 * v.y + mat.m12 * v.z + (translate ? mat.m13 : T(0)),
+					mat.m20 * v.x + mat.m21 * v.y + mat.m22 * v.z + (translate ? mat.m23 : T(0))
+				};
+			}
+		}
+
+		// Vec3Packed is 12 bytes, so 4 points fill 3 registers that deinterleave3 splits into x, y and z.
+		template<bool translate>
+		inline void transformPackedVec3s(const Mat4x4T<float>& mat, std::span<const Vec3Packed> in, std::span<Vec3Packed> out) {
+			const size_t count = in.size();
+			size_t i = 0;
+
+#if defined(NWT_SIMD_AVX2)
+			{
+				const simd::f32x8 m00 = simd::splat8(mat.m00), m01 = simd::splat8(mat.m01), m02 = simd::splat8(mat.m02), m03 = simd::splat8(mat.m03);
+				const simd::f32x8 m10 = simd::splat8(mat.m10), m11 = simd::splat8(mat.m11), m12 = simd::splat8(mat.m12), m13 = simd::splat8(mat.m13);
+				const simd::f32x8 m20 = simd::splat8(mat.m20), m21 = simd::splat8(mat.m21), m22 = simd::splat8(mat.m22), m23 = simd::splat8(mat.m23);
+
+				for (; i + 8 <= count; i += 8) {
+					const float* src = &in[i].x;
+					float* dst = &out[i].x;
+
+					// The points 0 to 3 go to the low and 4 to 7 to the high lane
+					const auto load = [src](size_t offset) { return _mm256_set_m128(_mm_loadu_ps(src + 12 + offset), _mm_loadu_ps(src + offset)); };
+					simd::f32x8 x, y, z;
+					simd::deinterleave3(load(0), load(4), load(8), x, y, z);
+
+					const simd::f32x8 ox = simd::madd(m02, z, simd::madd(m01, y, translate ? simd::madd(m00, x, m03) : simd::mul(m00, x)));
+					const simd::f32x8 oy = simd::madd(m12, z, simd::madd(m11, y, translate ? simd::madd(m10, x, m13) : simd::mul(m10, x)));
+					const simd::f32x8 oz = simd::madd(m22, z, simd::madd(m21, y, translate ? simd::madd(m20, x, m23) : simd::mul(m20, x)));
+
+					simd::f32x8 rows[3];
+					simd::interleave3(ox, oy, oz, rows[0], rows[1], rows[2]);
+					for (size_t row = 0; row < 3; row++) {
+						_mm_storeu_ps(dst + 4 * row, _mm256_castps256_ps128(rows[row]));
+						_mm_storeu_ps(dst + 12 + 4 * row, _mm256_extractf128_ps(rows[row], 1));
+					}
+				}
+			}
+#endif
+
+#if defined(NWT_SIMD_ENABLED)
+			{
+				const simd::f32x4 m00 = simd::splat(mat.m00), m01 = simd::splat(mat.m01), m02 = simd::splat(mat.m02), m03 = simd::splat(mat.m03);
+				const simd::f32x4 m10 = simd::splat(mat.m10), m11 = simd::splat(mat.m11), m12 = simd::splat(mat.m12), m13 = simd::splat(mat.m13);
+				const simd::f32x4 m20 = simd::splat(mat.m20), m21 = simd::splat(mat.m21), m22 = simd::splat(mat.m22), m23 = simd::splat(mat.m23);
+
+				for (; i + 4 <= count; i += 4) {
+					const float* src = &in[i].x;
+					float* dst = &out[i].x;
+
+#if defined(NWT_SIMD_SSE)
+					simd::f32x4 x, y, z;
+					simd::deinterleave3(simd::loadu(src), simd::loadu(src + 4), simd::loadu(src + 8), x, y, z);
+#else
+					const float32x4x3_t rows = vld3q_f32(src);
+					const float32x4_t x = rows.val[0], y = rows.val[1], z = rows.val[2];
+#endif
+
+					const simd::f32x4 ox = simd::madd(m02, z, simd::madd(m01, y, translate ? simd::madd(m00, x, m03) : simd::mul(m00, x)));
+					const simd::f32x4 oy = simd::madd(m12, z, simd::madd(m11, y, translate ? simd::madd(m10, x, m13) : simd::mul(m10, x)));
+					const simd::f32x4 oz = simd::madd(m22, z, simd::madd(m21, y, translate ? simd::madd(m20, x, m23) : simd::mul(m20, x)));
+
+#if defined(NWT_SIMD_SSE)
+					simd::f32x4 a, b, c;
+					simd::interleave3(ox, oy, oz, a, b, c);
+					simd::storeu(dst, a);
+					simd::storeu(dst + 4, b);
+					simd::storeu(dst + 8, c);
+#else
+					vst3q_f32(dst, float32x4x3_t{ { ox, oy, oz } });
+#endif
+				}
+			}
+#endif
+
+			for (; i < count; i++) {
+				const Vec3Packed v = in[i];
+				out[i] = Vec3Packed{
+					mat.m00 * v.x + mat.m01 * v.y + mat.m02 * v.z + (translate ? mat.m03 : 0.0f),
+					mat.m10 * v.x + mat.m11 * v.y + mat.m12 * v.z + (translate ? mat.m13 : 0.0f),
+					mat.m20 * v.x + mat.m21 * v.y + mat.m22 * v.z + (translate ? mat.m23 : 0.0f)
+				};
+			}
+		}
+	} // namespace detail
+
+	inline void transformPoints(const Mat4x4T<float>& mat, std::span<const Vec3T<float>> in, std::span<Vec3T<float>> out) {
+		detail::transformVec3s<float, true>(mat, in, out);
+	}
+
+	inline void transformPoints(const Mat4x4T<double>& mat, std::span<const Vec3T<double>> in, std::span<Vec3T<double>> out) {
+		detail::transformVec3s<double, true>(mat, in, out);
+	}
+
+	inline void transformDirections(const Mat4x4T<float>& mat, std::span<const Vec3T<float>> in, std::span<Vec3T<float>> out) {
+		detail::transformVec3s<float, false>(mat, in, out);
+	}
+
+	inline void transformDirections(const Mat4x4T<double>& mat, std::span<const Vec3T<double>> in, std::span<Vec3T<double>> out) {
+		detail::transformVec3s<double, false>(mat, in, out);
+	}
+
+	inline void transformPoints(const Mat4x4T<float>& mat, std::span<const Vec3Packed> in, std::span<Vec3Packed> out) {
+		detail::transformPackedVec3s<true>(mat, in, out);
+	}
+
+	inline void transformDirections(const Mat4x4T<float>& mat, std::span<const Vec3Packed> in, std::span<Vec3Packed> out) {
+		detail::transformPackedVec3s<false>(mat, in, out);
+	}
 } // namespace nwt
 
 namespace std {
-	template<>
-	struct hash<nwt::Mat4x4> {
-		size_t operator()(nwt::Mat4x4 const& mat) const {
-			size_t combinedHash = hash<float>()(mat.m00);
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(mat.m10));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(mat.m20));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(mat.m30));
-
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(mat.m01));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(mat.m11));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(mat.m21));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(mat.m31));
-
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(mat.m02));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(mat.m12));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(mat.m22));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(mat.m32));
-
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(mat.m03));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(mat.m13));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(mat.m23));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(mat.m33));
-			return combinedHash;
+	template<typename T>
+	struct hash<nwt::Mat4x4T<T>> {
+		size_t operator()(nwt::Mat4x4T<T> const& mat) const {
+			return nwt::Hash::HashFloats(
+				mat.m00, mat.m10, mat.m20, mat.m30,
+				mat.m01, mat.m11, mat.m21, mat.m31,
+				mat.m02, mat.m12, mat.m22, mat.m32,
+				mat.m03, mat.m13, mat.m23, mat.m33);
 		}
 	};
 }
\ No newline at end of file
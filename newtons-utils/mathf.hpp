@@ -1,9 +1,23 @@
 #pragma once
 
 #include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include "simd.hpp"
 
 
 namespace nwt {
+	namespace detail {
+		// Constant evaluation fallbacks for the std math functions, evaluated in double precision.
+		// Not meant for runtime use, the loops are only cheap for the compiler.
+		constexpr double constexprSqrt(double x);
+		constexpr void constexprSincos(double x, double& s, double& c);
+		constexpr double constexprAtan(double x);
+		constexpr double constexprAtan2(double y, double x);
+	}
+
 	class Mathf {
 	public:
 		Mathf() = delete;
@@ -12,26 +26,74 @@ namespace nwt {
 		static constexpr float RadToDeg = 57.29578f;
 		static constexpr float DegToRad = 0.017453292f;
 	public:
-		static float sqrt(float value);
+		static constexpr float sqrt(float value);
 		static constexpr float lerp(float a, float b, float t);
 		static constexpr float min(float a, float b);
 		static constexpr float max(float a, float b);
 		static constexpr float abs(float value);
 		static float pow(float a, float n);
-		static float clamp(float x, float min, float max);
-		static float clamp01(float x);
-		static float sin(float x);
-		static float cos(float x);
-		static float tan(float x);
-		static float asin(float x);
-		static float acos(float x);
-		static float atan(float x);
+		static constexpr float clamp(float x, float min, float max);
+		static constexpr float clamp01(float x);
+		static constexpr float sin(float x);
+		static constexpr float cos(float x);
+		static constexpr float tan(float x);
+		static constexpr float asin(float x);
+		static constexpr float acos(float x);
+		static constexpr float atan(float x);
+		static constexpr float atan2(float y, float x);
+		static constexpr void sincos(float x, float& s, float& c);
+
+		/// <summary>
+		/// Polynomial sin and cos after reduction into [-PI/4, PI/4], max error 2 ulp and below 1e-7
+		/// absolute near the zeros for |x| <= 8192, the reduction loses precision above that.
+		/// </summary>
+		static void fastSincos(float x, float& s, float& c);
+		static float fastSin(float x);
+		static float fastCos(float x);
+		/// <summary>
+		/// Polynomial atan2, max error 3 ulp over all quadrants, returns 0 at the origin.
+		/// </summary>
+		static float fastAtan2(float y, float x);
+		/// <summary>
+		/// 1 / sqrt(x) from the hardware estimate and one Newton-Raphson step, relative error below 3e-7.
+		/// </summary>
+		static float rsqrt(float x);
+
+		// Batched versions evaluating 8 (AVX2) or 4 lanes at a time, the outputs must hold at least as many elements as the inputs.
+		static void fastSincos(std::span<const float> x, std::span<float> s, std::span<float> c);
+		static void fastAtan2(std::span<const float> y, std::span<const float> x, std::span<float> out);
+		static void rsqrt(std::span<const float> x, std::span<float> out);
 
 		static constexpr bool inEpsilon(float x);
+
+		// Overloads for the other floating point precisions, the float versions above stay preferred for
+		// float and integer arguments.
+		template<std::floating_point T> static constexpr T sqrt(T value);
+		template<std::floating_point T> static constexpr T lerp(T a, T b, T t);
+		template<std::floating_point T> static constexpr T min(T a, T b);
+		template<std::floating_point T> static constexpr T max(T a, T b);
+		template<std::floating_point T> static constexpr T abs(T value);
+		template<std::floating_point T> static T pow(T a, T n);
+		template<std::floating_point T> static constexpr T clamp(T x, T min, T max);
+		template<std::floating_point T> static constexpr T clamp01(T x);
+		template<std::floating_point T> static constexpr T sin(T x);
+		template<std::floating_point T> static constexpr T cos(T x);
+		template<std::floating_point T> static constexpr T tan(T x);
+		template<std::floating_point T> static constexpr T asin(T x);
+		template<std::floating_point T> static constexpr T acos(T x);
+		template<std::floating_point T> static constexpr T atan(T x);
+		template<std::floating_point T> static constexpr T atan2(T y, T x);
+		template<std::floating_point T> static constexpr void sincos(T x, T& s, T& c);
+
+		template<std::floating_point T> static constexpr bool inEpsilon(T x);
 	};
 
-	inline float Mathf::sqrt(float value) {
-		return std::sqrt(value);
+	inline constexpr float Mathf::sqrt(float value) {
+		if consteval {
+			return static_cast<float>(detail::constexprSqrt(value));
+		} else {
+			return std::sqrt(value);
+		}
 	}
 
 	inline constexpr float Mathf::lerp(float a, float b, float t) {
@@ -54,41 +116,437 @@ namespace nwt {
 		return std::powf(a, n);
 	}
 
-	inline float Mathf::clamp(float x, float min, float max){
+	inline constexpr float Mathf::clamp(float x, float min, float max){
 		return x > max ? max : (x < min ? min : x);
 	}
 
-	inline float Mathf::clamp01(float x){
+	inline constexpr float Mathf::clamp01(float x){
 		return x > 1 ? 1 : (x < 0 ? 0 : x);
 	}
 
-	inline float Mathf::sin(float x){
-		return std::sinf(x);
+	inline constexpr float Mathf::sin(float x){
+		if consteval {
+			double s, c;
+			detail::constexprSincos(x, s, c);
+			return static_cast<float>(s);
+		} else {
+			return std::sinf(x);
+		}
 	}
 
-	inline float Mathf::cos(float x){
-		return std::cosf(x);
+	inline constexpr float Mathf::cos(float x){
+		if consteval {
+			double s, c;
+			detail::constexprSincos(x, s, c);
+			return static_cast<float>(c);
+		} else {
+			return std::cosf(x);
+		}
 	}
 
-	inline float Mathf::tan(float x) {
-		return std::tanf(x);
+	inline constexpr float Mathf::tan(float x) {
+		if consteval {
+			double s, c;
+			detail::constexprSincos(x, s, c);
+			return static_cast<float>(s / c);
+		} else {
+			return std::tanf(x);
+		}
 	}
 
-	inline float Mathf::asin(float x){
-		return std::asinf(x);
+	inline constexpr float Mathf::asin(float x){
+		if consteval {
+			return static_cast<float>(detail::constexprAtan2(x, detail::constexprSqrt((1.0 - x) * (1.0 + x))));
+		} else {
+			return std::asinf(x);
+		}
 	}
 
-	inline float Mathf::acos(float x){
-		return std::acosf(x);
+	inline constexpr float Mathf::acos(float x){
+		if consteval {
+			return static_cast<float>(detail::constexprAtan2(detail::constexprSqrt((1.0 - x) * (1.0 + x)), x));
+		} else {
+			return std::acosf(x);
+		}
 	}
 	
-	inline float Mathf::atan(float x) {
-		return std::atanf(x);
+	inline constexpr float Mathf::atan(float x) {
+		if consteval {
+			return static_cast<float>(detail::constexprAtan(x));
+		} else {
+			return std::atanf(x);
+		}
+	}
+
+	inline constexpr float Mathf::atan2(float y, float x) {
+		if consteval {
+			return static_cast<float>(detail::constexprAtan2(y, x));
+		} else {
+			return std::atan2f(y, x);
+		}
+	}
+
+	// Written as one pair so the compiler can merge them into a single sincosf call
+	inline constexpr void Mathf::sincos(float x, float& s, float& c) {
+		if consteval {
+			double sd, cd;
+			detail::constexprSincos(x, sd, cd);
+			s = static_cast<float>(sd);
+			c = static_cast<float>(cd);
+		} else {
+			s = std::sinf(x);
+			c = std::cosf(x);
+		}
+	}
+
+	//
+	// Approximations
+	//
+
+	inline void Mathf::fastSincos(float x, float& s, float& c) {
+		// q = nearest multiple of PI/2, the remainder r in [-PI/4, PI/4] is computed with PI/2 split into three parts
+		const int q = static_cast<int>(x * 0.63661977f + (x < 0 ? -0.5f : 0.5f));
+		const float fq = static_cast<float>(q);
+		float r = x - fq * 1.5703125f;
+		r = r - fq * 4.837512969970703125e-4f;
+		r = r - fq * 7.54978995489188216e-8f;
+		const float z = r * r;
+
+		const float ps = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * r + r;
+		const float pc = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - 0.5f * z + 1.0f;
+
+		switch (q & 3) {
+		case 0: s = ps; c = pc; break;
+		case 1: s = pc; c = -ps; break;
+		case 2: s = -ps; c = -pc; break;
+		default: s = -pc; c = ps; break;
+		}
+	}
+
+	inline float Mathf::fastSin(float x) {
+		float s, c;
+		fastSincos(x, s, c);
+		return s;
+	}
+
+	inline float Mathf::fastCos(float x) {
+		float s, c;
+		fastSincos(x, s, c);
+		return c;
+	}
+
+	inline float Mathf::fastAtan2(float y, float x) {
+		const float ax = abs(x);
+		const float ay = abs(y);
+		const float hi = max(ax, ay);
+		if (hi == 0)
+			return 0;
+
+		// t in [0, 1], above tan(PI/8) use atan(t) = PI/4 + atan((t - 1) / (t + 1))
+		const float t = min(ax, ay) / hi;
+		const bool reduce = t > 0.41421356f;
+		const float u = reduce ? (t - 1.0f) / (t + 1.0f) : t;
+		const float z = u * u;
+
+		float result = (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * u + u;
+		if (reduce)
+			result += 0.78539816f;
+
+		if (ay > ax)
+			result = 1.5707964f - result;
+		if (x < 0)
+			result = PI - result;
+		return y < 0 ? -result : result;
+	}
+
+	inline float Mathf::rsqrt(float x) {
+#if defined(NWT_SIMD_SSE)
+		const float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+		return y * (1.5f - 0.5f * x * y * y);
+#elif defined(NWT_SIMD_NEON)
+		float y = vrsqrtes_f32(x);
+		y = y * vrsqrtss_f32(x * y, y);
+		return y * vrsqrtss_f32(x * y, y);
+#else
+		return 1.0f / std::sqrt(x);
+#endif
+	}
+
+	inline void Mathf::fastSincos(std::span<const float> x, std::span<float> s, std::span<float> c) {
+		const size_t count = x.size();
+		size_t i = 0;
+
+#if defined(NWT_SIMD_AVX2)
+		for (; i + 8 <= count; i += 8) {
+			simd::f32x8 vs, vc;
+			simd::sincos(simd::load8(&x[i]), vs, vc);
+			simd::store(&s[i], vs);
+			simd::store(&c[i], vc);
+		}
+#endif
+#if defined(NWT_SIMD_ENABLED)
+		for (; i + 4 <= count; i += 4) {
+			simd::f32x4 vs, vc;
+			simd::sincos(simd::loadu(&x[i]), vs, vc);
+			simd::storeu(&s[i], vs);
+			simd::storeu(&c[i], vc);
+		}
+#endif
+		for (; i < count; i++) {
+			fastSincos(x[i], s[i], c[i]);
+		}
+	}
+
+	inline void Mathf::fastAtan2(std::span<const float> y, std::span<const float> x, std::span<float> out) {
+		const size_t count = y.size();
+		size_t i = 0;
+
+#if defined(NWT_SIMD_AVX2)
+		for (; i + 8 <= count; i += 8) {
+			simd::store(&out[i], simd::atan2(simd::load8(&y[i]), simd::load8(&x[i])));
+		}
+#endif
+#if defined(NWT_SIMD_ENABLED)
+		for (; i + 4 <= count; i += 4) {
+			simd::storeu(&out[i], simd::atan2(simd::loadu(&y[i]), simd::loadu(&x[i])));
+		}
+#endif
+		for (; i < count; i++) {
+			out[i] = fastAtan2(y[i], x[i]);
+		}
 	}
 
+	inline void Mathf::rsqrt(std::span<const float> x, std::span<float> out) {
+		const size_t count = x.size();
+		size_t i = 0;
+
+#if defined(NWT_SIMD_AVX2)
+		for (; i + 8 <= count; i += 8) {
+			simd::store(&out[i], simd::rsqrt(simd::load8(&x[i])));
+		}
+#endif
+#if defined(NWT_SIMD_ENABLED)
+		for (; i + 4 <= count; i += 4) {
+			simd::storeu(&out[i], simd::rsqrt(simd::loadu(&x[i])));
+		}
+#endif
+		for (; i < count; i++) {
+			out[i] = rsqrt(x[i]);
+		}
+	}
 
 	inline constexpr bool Mathf::inEpsilon(float x){
 		return x > -epsilon && x < epsilon;
 	}
 
+	//
+	// Generic precision
+	//
+
+	template<std::floating_point T>
+	inline constexpr T Mathf::sqrt(T value) {
+		if consteval {
+			return static_cast<T>(detail::constexprSqrt(static_cast<double>(value)));
+		} else {
+			return std::sqrt(value);
+		}
+	}
+
+	template<std::floating_point T>
+	inline constexpr T Mathf::lerp(T a, T b, T t) {
+		return a + (b - a) * t;
+	}
+
+	template<std::floating_point T>
+	inline constexpr T Mathf::min(T a, T b) {
+		return a < b ? a : b;
+	}
+
+	template<std::floating_point T>
+	inline constexpr T Mathf::max(T a, T b) {
+		return a > b ? a : b;
+	}
+
+	template<std::floating_point T>
+	inline constexpr T Mathf::abs(T value) {
+		return value < 0 ? -value : value;
+	}
+
+	template<std::floating_point T>
+	inline T Mathf::pow(T a, T n) {
+		return std::pow(a, n);
+	}
+
+	template<std::floating_point T>
+	inline constexpr T Mathf::clamp(T x, T min, T max) {
+		return x > max ? max : (x < min ? min : x);
+	}
+
+	template<std::floating_point T>
+	inline constexpr T Mathf::clamp01(T x) {
+		return x > 1 ? 1 : (x < 0 ? 0 : x);
+	}
+
+	template<std::floating_point T>
+	inline constexpr T Mathf::sin(T x) {
+		if consteval {
+			double s, c;
+			detail::constexprSincos(static_cast<double>(x), s, c);
+			return static_cast<T>(s);
+		} else {
+			return std::sin(x);
+		}
+	}
+
+	template<std::floating_point T>
+	inline constexpr T Mathf::cos(T x) {
+		if consteval {
+			double s, c;
+			detail::constexprSincos(static_cast<double>(x), s, c);
+			return static_cast<T>(c);
+		} else {
+			return std::cos(x);
+		}
+	}
+
+	template<std::floating_point T>
+	inline constexpr T Mathf::tan(T x) {
+		if consteval {
+			double s, c;
+			detail::constexprSincos(static_cast<double>(x), s, c);
+			return static_cast<T>(s / c);
+		} else {
+			return std::tan(x);
+		}
+	}
+
+	template<std::floating_point T>
+	inline constexpr T Mathf::asin(T x) {
+		if consteval {
+			return static_cast<T>(detail::constexprAtan2(static_cast<double>(x), detail::constexprSqrt((1.0 - x) * (1.0 + x))));
+		} else {
+			return std::asin(x);
+		}
+	}
+
+	template<std::floating_point T>
+	inline constexpr T Mathf::acos(T x) {
+		if consteval {
+			return static_cast<T>(detail::constexprAtan2(detail::constexprSqrt((1.0 - x) * (1.0 + x)), static_cast<double>(x)));
+		} else {
+			return std::acos(x);
+		}
+	}
+
+	template<std::floating_point T>
+	inline constexpr T Mathf::atan(T x) {
+		if consteval {
+			return static_cast<T>(detail::constexprAtan(static_cast<double>(x)));
+		} else {
+			return std::atan(x);
+		}
+	}
+
+	template<std::floating_point T>
+	inline constexpr T Mathf::atan2(T y, T x) {
+		if consteval {
+			return static_cast<T>(detail::constexprAtan2(static_cast<double>(y), static_cast<double>(x)));
+		} else {
+			return std::atan2(y, x);
+		}
+	}
+
+	template<std::floating_point T>
+	inline constexpr void Mathf::sincos(T x, T& s, T& c) {
+		if consteval {
+			double sd, cd;
+			detail::constexprSincos(static_cast<double>(x), sd, cd);
+			s = static_cast<T>(sd);
+			c = static_cast<T>(cd);
+		} else {
+			s = std::sin(x);
+			c = std::cos(x);
+		}
+	}
+
+	template<std::floating_point T>
+	inline constexpr bool Mathf::inEpsilon(T x) {
+		return x > -epsilon && x < epsilon;
+	}
+
+	//
+	// Constant evaluation
+	//
+
+	namespace detail {
+		constexpr double constexprSqrt(double x) {
+			if (!(x > 0) || x == std::numeric_limits<double>::infinity())
+				return x == 0 || x == std::numeric_limits<double>::infinity() ? x : std::numeric_limits<double>::quiet_NaN();
+
+			// Newton's method from above decreases monotonically, stop once it doesn't anymore
+			double guess = x > 1 ? x : 1;
+			while (true) {
+				const double next = 0.5 * (guess + x / guess);
+				if (next >= guess)
+					return guess;
+				guess = next;
+			}
+		}
+
+		constexpr void constexprSincos(double x, double& s, double& c) {
+			// Reduce into [-PI/4, PI/4] around the nearest multiple of PI/2 (split in two parts), then Taylor series
+			const long long q = static_cast<long long>(x * 0.63661977236758134 + (x < 0 ? -0.5 : 0.5));
+			const double r = (x - q * 1.5707963267948966) - q * 6.123233995736766e-17;
+			const double r2 = r * r;
+
+			double sinSum = r, cosSum = 1;
+			double sinTerm = r, cosTerm = 1;
+			for (int n = 1; n < 12; n++) {
+				sinTerm *= -r2 / ((2 * n) * (2 * n + 1));
+				cosTerm *= -r2 / ((2 * n - 1) * (2 * n));
+				sinSum += sinTerm;
+				cosSum += cosTerm;
+			}
+
+			switch (q & 3) {
+			case 0: s = sinSum; c = cosSum; break;
+			case 1: s = cosSum; c = -sinSum; break;
+			case 2: s = -sinSum; c = -cosSum; break;
+			default: s = -cosSum; c = sinSum; break;
+			}
+		}
+
+		constexpr double constexprAtan(double x) {
+			if (x != x)
+				return x;
+			if (x < 0)
+				return -constexprAtan(-x);
+			// atan(x) = PI/2 - atan(1/x) and atan(x) = PI/6 + atan((x * sqrt(3) - 1) / (x + sqrt(3))) bring x below tan(PI/12)
+			if (x > 1)
+				return 1.5707963267948966 - constexprAtan(1 / x);
+			if (x > 0.2679491924311227)
+				return 0.5235987755982988 + constexprAtan((x * 1.7320508075688772 - 1) / (x + 1.7320508075688772));
+
+			const double x2 = x * x;
+			double sum = x, term = x;
+			for (int n = 1; n < 20; n++) {
+				term *= -x2;
+				sum += term / (2 * n + 1);
+			}
+			return sum;
+		}
+
+		constexpr double constexprAtan2(double y, double x) {
+			constexpr double pi = 3.141592653589793;
+			if (x > 0)
+				return constexprAtan(y / x);
+			if (x < 0)
+				return y < 0 ? constexprAtan(y / x) - pi : constexprAtan(y / x) + pi;
+			if (y > 0)
+				return pi / 2;
+			if (y < 0)
+				return -pi / 2;
+			return 0;
+		}
+	} // namespace detail
 } // namespace nwt
\ No newline at end of file
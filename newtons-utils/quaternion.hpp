@@ -1,91 +1,149 @@
 #pragma once
 
 #include "vec3.hpp"
+#include "simd.hpp"
 
+#include <cstddef>
+#include <span>
 #include <string>
+#include <type_traits>
 
 namespace nwt {
 	/// <summary>
 	/// The Quaternion is assumed to be a unit Quaternion
 	/// </summary>
-	struct alignas(16) Quaternion {
-		float w, x, y, z;
+	template<typename T>
+	struct alignas(4 * sizeof(T)) QuaternionT {
+		T w, x, y, z;
 
-		constexpr Quaternion(float w, float x, float y, float z)
+		constexpr QuaternionT(T w, T x, T y, T z)
 			: w(w), x(x), y(y), z(z) {}
-		constexpr Quaternion(float w, const Vec3& im)
+		constexpr QuaternionT(T w, const Vec3T<T>& im)
 			: w(w), x(im.x), y(im.y), z(im.z) {}
 
-		static constexpr Quaternion identity();
-		bool isNormalized() const;
-		Quaternion normalized() const;
-
-		float magnitude() const;
-
-		static constexpr Quaternion conjugate(const Quaternion& q);
-		constexpr Quaternion conjugated() const;
-
-		static constexpr Vec3 rotateVector(const Quaternion& q, const Vec3& v);
-		static Quaternion fromEuler(float x, float y, float z);
-		static Quaternion fromTo(const Vec3& from, const Vec3& to);
-
-		constexpr bool operator==(const Quaternion& q) const;
-		constexpr bool operator!=(const Quaternion& q) const;
-
-		constexpr Quaternion operator*(const Quaternion& q) const;
-		constexpr Quaternion operator*(float scalar) const;
-		friend constexpr Quaternion operator*(float scalar, const Quaternion& v);
-		constexpr Quaternion operator/(float scalar) const;
+		template<typename U>
+		explicit constexpr QuaternionT(const QuaternionT<U>& other)
+			: w(static_cast<T>(other.w)), x(static_cast<T>(other.x)), y(static_cast<T>(other.y)), z(static_cast<T>(other.z)) {}
+
+		static constexpr QuaternionT identity();
+		constexpr bool isNormalized() const;
+		constexpr QuaternionT normalized() const;
+
+		constexpr T magnitude() const;
+
+		static constexpr QuaternionT conjugate(const QuaternionT& q);
+		constexpr QuaternionT conjugated() const;
+
+		static constexpr Vec3T<T> rotateVector(const QuaternionT& q, const Vec3T<T>& v);
+		static constexpr QuaternionT fromEuler(T x, T y, T z);
+		static constexpr QuaternionT fromTo(const Vec3T<T>& from, const Vec3T<T>& to);
+
+		static constexpr T dot(const QuaternionT& a, const QuaternionT& b);
+		/// <summary>
+		/// Normalized linear interpolation along the shorter arc, cheaper than slerp but not constant speed.
+		/// </summary>
+		static constexpr QuaternionT nlerp(const QuaternionT& a, const QuaternionT& b, T t);
+		/// <summary>
+		/// Spherical linear interpolation along the shorter arc, falls back to nlerp for nearly equal rotations.
+		/// </summary>
+		static constexpr QuaternionT slerp(const QuaternionT& a, const QuaternionT& b, T t);
+		/// <summary>
+		/// Exponential map of the pure quaternion (0, v), the result rotates by 2 * |v| around v.
+		/// </summary>
+		static constexpr QuaternionT exp(const Vec3T<T>& v);
+		/// <summary>
+		/// Inverse of exp, returns the rotation axis scaled by half the rotation angle.
+		/// </summary>
+		static constexpr Vec3T<T> log(const QuaternionT& q);
+		/// <summary>
+		/// Advances q by the world space angular velocity (radians per second) over dt seconds.
+		/// </summary>
+		static constexpr QuaternionT integrate(const QuaternionT& q, const Vec3T<T>& angularVelocity, T dt);
+
+		constexpr bool operator==(const QuaternionT& q) const;
+		constexpr bool operator!=(const QuaternionT& q) const;
+
+		constexpr QuaternionT operator+(const QuaternionT& q) const;
+		constexpr QuaternionT operator-(const QuaternionT& q) const;
+		constexpr QuaternionT operator-() const;
+		constexpr QuaternionT operator*(const QuaternionT& q) const;
+		constexpr QuaternionT operator*(T scalar) const;
+		friend constexpr QuaternionT operator*(T scalar, const QuaternionT& v) { return v * scalar; }
+		constexpr QuaternionT operator/(T scalar) const;
 
 		std::string toString() const;
 	};
 
-	inline constexpr Quaternion Quaternion::identity() {
+	using Quaternion = QuaternionT<float>;
+	using Quaterniond = QuaternionT<double>;
+
+	/// <summary>
+	/// Rotates every in[i] by q[i] and writes it to out[i], out may be the same span as in.
+	/// </summary>
+	void rotateVectors(std::span<const QuaternionT<float>> q, std::span<const Vec3T<float>> in, std::span<Vec3T<float>> out);
+	void rotateVectors(std::span<const QuaternionT<double>> q, std::span<const Vec3T<double>> in, std::span<Vec3T<double>> out);
+	/// <summary>
+	/// Writes a[i] * b[i] to out[i], out may be the same span as a or b.
+	/// </summary>
+	void multiplyQuaternions(std::span<const QuaternionT<float>> a, std::span<const QuaternionT<float>> b, std::span<QuaternionT<float>> out);
+	void multiplyQuaternions(std::span<const QuaternionT<double>> a, std::span<const QuaternionT<double>> b, std::span<QuaternionT<double>> out);
+	/// <summary>
+	/// Integrates every orientation q[i] in place by angularVelocity[i] over dt, see QuaternionT::integrate.
+	/// The vectorized float path uses the fast sin/cos and rsqrt approximations of Mathf, doubles stay exact.
+	/// </summary>
+	void integrateOrientations(std::span<QuaternionT<float>> q, std::span<const Vec3T<float>> angularVelocity, float dt);
+	void integrateOrientations(std::span<QuaternionT<double>> q, std::span<const Vec3T<double>> angularVelocity, double dt);
+
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::identity() {
 		return { 1, 0, 0, 0 };
 	}
 
-	inline bool Quaternion::isNormalized() const {
+	template<typename T>
+	inline constexpr bool QuaternionT<T>::isNormalized() const {
 		return Mathf::inEpsilon(Mathf::sqrt(x * x + y * y + z * z + w * w) - 1.0f);
 	}
 
-	inline Quaternion Quaternion::normalized() const {
-		float magnitude = this->magnitude();
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::normalized() const {
+		T magnitude = this->magnitude();
 
-		return Quaternion{ x / magnitude, y / magnitude, z / magnitude, w / magnitude };
+		return QuaternionT<T>{ w / magnitude, x / magnitude, y / magnitude, z / magnitude };
 	}
 
-	inline float Quaternion::magnitude() const {
+	template<typename T>
+	inline constexpr T QuaternionT<T>::magnitude() const {
 		return Mathf::sqrt(x * x + y * y + z * z + w * w);
 	}
 
 	
 
-	inline constexpr Quaternion Quaternion::conjugate(const Quaternion& q) {
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::conjugate(const QuaternionT<T>& q) {
 		return { q.w, -q.x, -q.y, -q.z };
 	}
 
-	inline constexpr Quaternion Quaternion::conjugated() const{
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::conjugated() const{
 		return { w, -x, -y, -z };
 	}
 
-	inline constexpr Vec3 Quaternion::rotateVector(const nwt::Quaternion& q, const Vec3& v) {
-		Vec3 i{ q.x, q.y, q.z };
+	template<typename T>
+	inline constexpr Vec3T<T> QuaternionT<T>::rotateVector(const nwt::QuaternionT<T>& q, const Vec3T<T>& v) {
+		Vec3T<T> i{ q.x, q.y, q.z };
 
 		return 2.0f * (q.x * v.x + q.y * v.y + q.z * v.z) * i +
 			(q.w * q.w - i.sqrMagnitude()) * v +
-			2.0f * q.w * Vec3(i.y * v.z - i.z * v.y, i.z * v.x - i.x * v.z, i.x * v.y - i.y * v.x);
+			2.0f * q.w * Vec3T<T>(i.y * v.z - i.z * v.y, i.z * v.x - i.x * v.z, i.x * v.y - i.y * v.x);
 	}
 
 	// 3-2-1 (Z-Y-X)
-	inline Quaternion Quaternion::fromEuler(float x, float y, float z){
-		float cx = Mathf::cos(x * 0.5f);
-		float sx = Mathf::sin(x * 0.5f);
-		
-		float cy = Mathf::cos(y * 0.5f);
-		float sy = Mathf::sin(y * 0.5f);
-		
-		float cz = Mathf::cos(z * 0.5f);
-		float sz = Mathf::sin(z * 0.5f);
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::fromEuler(T x, T y, T z){
+		T cx, sx, cy, sy, cz, sz;
+		Mathf::sincos(x * T(0.5), sx, cx);
+		Mathf::sincos(y * T(0.5), sy, cy);
+		Mathf::sincos(z * T(0.5), sz, cz);
 
 		return{
 			cx * cy * cz + sx * sy * sz,
@@ -95,64 +153,376 @@ namespace nwt {
 		};
 	}
 
-	inline Quaternion Quaternion::fromTo(const Vec3& from, const Vec3& to) {
-		Vec3 dir = Vec3::cross(from, to);
-		float real = Mathf::sqrt(from.sqrMagnitude() * to.sqrMagnitude() * Vec3::dot(from, to));
-		return Quaternion{real, dir}.normalized();
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::fromTo(const Vec3T<T>& from, const Vec3T<T>& to) {
+		Vec3T<T> dir = Vec3T<T>::cross(from, to);
+		T real = Mathf::sqrt(from.sqrMagnitude() * to.sqrMagnitude() * Vec3T<T>::dot(from, to));
+		return QuaternionT<T>{real, dir}.normalized();
+	}
+
+	template<typename T>
+	inline constexpr T QuaternionT<T>::dot(const QuaternionT<T>& a, const QuaternionT<T>& b) {
+		return a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::nlerp(const QuaternionT<T>& a, const QuaternionT<T>& b, T t) {
+		// q and -q are the same rotation, flip b to take the shorter arc
+		const QuaternionT<T> target = dot(a, b) < 0 ? -b : b;
+		return (a * (1 - t) + target * t).normalized();
+	}
+
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::slerp(const QuaternionT<T>& a, const QuaternionT<T>& b, T t) {
+		T cosTheta = dot(a, b);
+		QuaternionT<T> target = b;
+		if (cosTheta < 0) {
+			cosTheta = -cosTheta;
+			target = -b;
+		}
+
+		// sin(theta) goes to zero, the arc is short enough to be linear
+		if (cosTheta > T(0.9995))
+			return nlerp(a, target, t);
+
+		const T theta = Mathf::acos(cosTheta);
+		const T invSinTheta = 1 / Mathf::sqrt(1 - cosTheta * cosTheta);
+		return a * (Mathf::sin((1 - t) * theta) * invSinTheta) + target * (Mathf::sin(t * theta) * invSinTheta);
+	}
+
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::exp(const Vec3T<T>& v) {
+		const T angle = v.magnitude();
+		T s, c;
+		Mathf::sincos(angle, s, c);
+		// sin(angle) / angle tends to 1
+		const T scale = angle > T(1e-6) ? s / angle : 1;
+		return { c, v * scale };
+	}
+
+	template<typename T>
+	inline constexpr Vec3T<T> QuaternionT<T>::log(const QuaternionT<T>& q) {
+		const Vec3T<T> im{ q.x, q.y, q.z };
+		const T sinAngle = im.magnitude();
+		if (sinAngle < T(1e-6))
+			return im;
+		return im * (Mathf::atan2(sinAngle, q.w) / sinAngle);
+	}
+
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::integrate(const QuaternionT<T>& q, const Vec3T<T>& angularVelocity, T dt) {
+		return (exp(angularVelocity * (dt * T(0.5))) * q).normalized();
 	}
 
 	//
 	// Operators
 	//
 
-	inline constexpr bool Quaternion::operator==(const Quaternion& q) const{
+	template<typename T>
+	inline constexpr bool QuaternionT<T>::operator==(const QuaternionT<T>& q) const{
 		return Mathf::inEpsilon(w - q.w) && Mathf::inEpsilon(x - q.x) && Mathf::inEpsilon(y - q.y) && Mathf::inEpsilon(z - q.z);
 	}
 
-	inline constexpr bool Quaternion::operator!=(const Quaternion& q) const{
+	template<typename T>
+	inline constexpr bool QuaternionT<T>::operator!=(const QuaternionT<T>& q) const{
 		return !((*this) == q);
 	}
 
-	inline constexpr Quaternion Quaternion::operator*(const Quaternion& q) const {
-		Vec3 v1 = { x, y, z };
-		Vec3 v2 = { q.x, q.y, q.z };
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::operator+(const QuaternionT<T>& q) const {
+		return { w + q.w, x + q.x, y + q.y, z + q.z };
+	}
+
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::operator-(const QuaternionT<T>& q) const {
+		return { w - q.w, x - q.x, y - q.y, z - q.z };
+	}
+
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::operator-() const {
+		return { -w, -x, -y, -z };
+	}
+
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::operator*(const QuaternionT<T>& q) const {
+		Vec3T<T> v1 = { x, y, z };
+		Vec3T<T> v2 = { q.x, q.y, q.z };
 		
-		float r = w * q.w - Vec3::dot(v1, v2);
-		Vec3 i = (w * v2) + (q.w * v1) + Vec3::cross(v1, v2);
+		T r = w * q.w - Vec3T<T>::dot(v1, v2);
+		Vec3T<T> i = (w * v2) + (q.w * v1) + Vec3T<T>::cross(v1, v2);
 
 		return { r, i };
 	}
 
-	inline constexpr Quaternion Quaternion::operator*(float scalar) const
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::operator*(T scalar) const
 	{
 		return { w * scalar, x * scalar, y * scalar, z * scalar };
 	}
 
-	inline constexpr Quaternion operator*(float scalar, const Quaternion& q)
-	{
-		return q * scalar;
-	}
 
-	inline constexpr Quaternion Quaternion::operator/(float scalar) const {
+	template<typename T>
+	inline constexpr QuaternionT<T> QuaternionT<T>::operator/(T scalar) const {
 		return { w / scalar, x / scalar, y / scalar, z / scalar };
 	}
 
 
-	inline std::string Quaternion::toString() const {
+	template<typename T>
+	inline std::string QuaternionT<T>::toString() const {
 		return ("(" + std::to_string(w) + "," + std::to_string(x) + "," + std::to_string(y) + "," + std::to_string(z) + ")");
 	}
 
+	namespace detail {
+		// The batched kernels load 4 or 8 quaternions (and padded Vec3s) as rows and transpose them into
+		// w, x, y and z registers, every lane then runs the scalar formula. Doubles go 4 wide on AVX2.
+#if defined(NWT_SIMD_ENABLED)
+		template<typename V>
+		inline void mulLanes(V aw, V ax, V ay, V az, V bw, V bx, V by, V bz, V& rw, V& rx, V& ry, V& rz) {
+			using namespace simd;
+			rw = sub(mul(aw, bw), madd(ax, bx, madd(ay, by, mul(az, bz))));
+			rx = add(madd(aw, bx, mul(bw, ax)), sub(mul(ay, bz), mul(az, by)));
+			ry = add(madd(aw, by, mul(bw, ay)), sub(mul(az, bx), mul(ax, bz)));
+			rz = add(madd(aw, bz, mul(bw, az)), sub(mul(ax, by), mul(ay, bx)));
+		}
+
+		template<typename V, size_t width, typename T>
+		inline void mulBlock(const T* a, const T* b, T* out) {
+			using namespace simd;
+			V aw = loadAs<V>(a), ax = loadAs<V>(a + width), ay = loadAs<V>(a + 2 * width), az = loadAs<V>(a + 3 * width);
+			V bw = loadAs<V>(b), bx = loadAs<V>(b + width), by = loadAs<V>(b + 2 * width), bz = loadAs<V>(b + 3 * width);
+			transpose4(aw, ax, ay, az);
+			transpose4(bw, bx, by, bz);
+
+			V rw, rx, ry, rz;
+			mulLanes(aw, ax, ay, az, bw, bx, by, bz, rw, rx, ry, rz);
+
+			transpose4(rw, rx, ry, rz);
+			store(out, rw);
+			store(out + width, rx);
+			store(out + 2 * width, ry);
+			store(out + 3 * width, rz);
+		}
+
+		template<typename V, size_t width, typename T>
+		inline void rotateBlock(const T* q, const T* v, T* out) {
+			using namespace simd;
+			V qw = loadAs<V>(q), qx = loadAs<V>(q + width), qy = loadAs<V>(q + 2 * width), qz = loadAs<V>(q + 3 * width);
+			V vx = loadAs<V>(v), vy = loadAs<V>(v + width), vz = loadAs<V>(v + 2 * width), vw = loadAs<V>(v + 3 * width);
+			transpose4(qw, qx, qy, qz);
+			transpose4(vx, vy, vz, vw);
+
+			// 2 * dot(i, v) * i + (w^2 - |i|^2) * v + 2 * w * cross(i, v)
+			const V two = splatAs<V>(T(2));
+			const V d = mul(two, madd(qx, vx, madd(qy, vy, mul(qz, vz))));
+			const V s = sub(mul(qw, qw), madd(qx, qx, madd(qy, qy, mul(qz, qz))));
+			const V w2 = mul(two, qw);
+
+			V rx = madd(d, qx, madd(s, vx, mul(w2, sub(mul(qy, vz), mul(qz, vy)))));
+			V ry = madd(d, qy, madd(s, vy, mul(w2, sub(mul(qz, vx), mul(qx, vz)))));
+			V rz = madd(d, qz, madd(s, vz, mul(w2, sub(mul(qx, vy), mul(qy, vx)))));
+			V rw = splatAs<V>(T(0));
+
+			transpose4(rx, ry, rz, rw);
+			store(out, rx);
+			store(out + width, ry);
+			store(out + 2 * width, rz);
+			store(out + 3 * width, rw);
+		}
+
+		template<typename V, size_t width>
+		inline void integrateBlock(float* q, const float* angularVelocity, float dt) {
+			using namespace simd;
+			V qw = loadAs<V>(q), qx = loadAs<V>(q + width), qy = loadAs<V>(q + 2 * width), qz = loadAs<V>(q + 3 * width);
+			V vx = loadAs<V>(angularVelocity), vy = loadAs<V>(angularVelocity + width), vz = loadAs<V>(angularVelocity + 2 * width), vw = loadAs<V>(angularVelocity + 3 * width);
+			transpose4(qw, qx, qy, qz);
+			transpose4(vx, vy, vz, vw);
+
+			// exp(angularVelocity * dt / 2) * q
+			const V halfDt = splatAs<V>(dt * 0.5f);
+			vx = mul(vx, halfDt);
+			vy = mul(vy, halfDt);
+			vz = mul(vz, halfDt);
+			const V angle = sqrt(madd(vx, vx, madd(vy, vy, mul(vz, vz))));
+			V s, c;
+			sincos(angle, s, c);
+			const V scale = select(greater(angle, splatAs<V>(1e-6f)), div(s, angle), splatAs<V>(1.0f));
+
+			V rw, rx, ry, rz;
+			mulLanes(c, mul(vx, scale), mul(vy, scale), mul(vz, scale), qw, qx, qy, qz, rw, rx, ry, rz);
+
+			const V invLength = rsqrt(madd(rw, rw, madd(rx, rx, madd(ry, ry, mul(rz, rz)))));
+			rw = mul(rw, invLength);
+			rx = mul(rx, invLength);
+			ry = mul(ry, invLength);
+			rz = mul(rz, invLength);
+
+			transpose4(rw, rx, ry, rz);
+			store(q, rw);
+			store(q + width, rx);
+			store(q + 2 * width, ry);
+			store(q + 3 * width, rz);
+		}
+
+#if defined(NWT_SIMD_AVX2)
+		// Same as integrateBlock but exact, the sin and cos of the 4 angles come from Mathf::sincos
+		// and the result is normalized with a full square root and division.
+		inline void integrateBlock(double* q, const double* angularVelocity, double dt) {
+			using namespace simd;
+			f64x4 qw = load(q), qx = load(q + 4), qy = load(q + 8), qz = load(q + 12);
+			f64x4 vx = load(angularVelocity), vy = load(angularVelocity + 4), vz = load(angularVelocity + 8), vw = load(angularVelocity + 12);
+			transpose4(qw, qx, qy, qz);
+			transpose4(vx, vy, vz, vw);
+
+			const f64x4 halfDt = splat(dt * 0.5);
+			vx = mul(vx, halfDt);
+			vy = mul(vy, halfDt);
+			vz = mul(vz, halfDt);
+
+			alignas(32) double angles[4], sines[4], cosines[4];
+			store(angles, sqrt(madd(vx, vx, madd(vy, vy, mul(vz, vz)))));
+			for (size_t lane = 0; lane < 4; lane++) {
+				Mathf::sincos(angles[lane], sines[lane], cosines[lane]);
+				sines[lane] = angles[lane] > 1e-6 ? sines[lane] / angles[lane] : 1.0;
+			}
+			const f64x4 scale = load(sines);
+
+			f64x4 rw, rx, ry, rz;
+			mulLanes(load(cosines), mul(vx, scale), mul(vy, scale), mul(vz, scale), qw, qx, qy, qz, rw, rx, ry, rz);
+
+			const f64x4 length = sqrt(madd(rw, rw, madd(rx, rx, madd(ry, ry, mul(rz, rz)))));
+			rw = div(rw, length);
+			rx = div(rx, length);
+			ry = div(ry, length);
+			rz = div(rz, length);
+
+			transpose4(rw, rx, ry, rz);
+			store(q, rw);
+			store(q + 4, rx);
+			store(q + 8, ry);
+			store(q + 12, rz);
+		}
+#endif
+#endif
+
+		template<typename T>
+		inline void multiplyQuaternions(std::span<const QuaternionT<T>> a, std::span<const QuaternionT<T>> b, std::span<QuaternionT<T>> out) {
+			const size_t count = a.size();
+			size_t i = 0;
+
+#if defined(NWT_SIMD_ENABLED)
+			if constexpr (std::is_same_v<T, float>) {
+#if defined(NWT_SIMD_AVX2)
+				for (; i + 8 <= count; i += 8) {
+					mulBlock<simd::f32x8, 8>(&a[i].w, &b[i].w, &out[i].w);
+				}
+#endif
+				for (; i + 4 <= count; i += 4) {
+					mulBlock<simd::f32x4, 4>(&a[i].w, &b[i].w, &out[i].w);
+				}
+			}
+#if defined(NWT_SIMD_AVX2)
+			else if constexpr (std::is_same_v<T, double>) {
+				for (; i + 4 <= count; i += 4) {
+					mulBlock<simd::f64x4, 4>(&a[i].w, &b[i].w, &out[i].w);
+				}
+			}
+#endif
+#endif
+			for (; i < count; i++) {
+				out[i] = a[i] * b[i];
+			}
+		}
+
+		template<typename T>
+		inline void rotateVectors(std::span<const QuaternionT<T>> q, std::span<const Vec3T<T>> in, std::span<Vec3T<T>> out) {
+			const size_t count = q.size();
+			size_t i = 0;
+
+#if defined(NWT_SIMD_ENABLED)
+			if constexpr (std::is_same_v<T, float>) {
+#if defined(NWT_SIMD_AVX2)
+				for (; i + 8 <= count; i += 8) {
+					rotateBlock<simd::f32x8, 8>(&q[i].w, &in[i].x, &out[i].x);
+				}
+#endif
+				for (; i + 4 <= count; i += 4) {
+					rotateBlock<simd::f32x4, 4>(&q[i].w, &in[i].x, &out[i].x);
+				}
+			}
+#if defined(NWT_SIMD_AVX2)
+			else if constexpr (std::is_same_v<T, double>) {
+				for (; i + 4 <= count; i += 4) {
+					rotateBlock<simd::f64x4, 4>(&q[i].w, &in[i].x, &out[i].x);
+				}
+			}
+#endif
+#endif
+			for (; i < count; i++) {
+				out[i] = QuaternionT<T>::rotateVector(q[i], in[i]);
+			}
+		}
+
+		template<typename T>
+		inline void integrateOrientations(std::span<QuaternionT<T>> q, std::span<const Vec3T<T>> angularVelocity, T dt) {
+			const size_t count = q.size();
+			size_t i = 0;
+
+#if defined(NWT_SIMD_ENABLED)
+			if constexpr (std::is_same_v<T, float>) {
+#if defined(NWT_SIMD_AVX2)
+				for (; i + 8 <= count; i += 8) {
+					integrateBlock<simd::f32x8, 8>(&q[i].w, &angularVelocity[i].x, dt);
+				}
+#endif
+				for (; i + 4 <= count; i += 4) {
+					integrateBlock<simd::f32x4, 4>(&q[i].w, &angularVelocity[i].x, dt);
+				}
+			}
+#if defined(NWT_SIMD_AVX2)
+			else if constexpr (std::is_same_v<T, double>) {
+				for (; i + 4 <= count; i += 4) {
+					integrateBlock(&q[i].w, &angularVelocity[i].x, dt);
+				}
+			}
+#endif
+#endif
+			for (; i < count; i++) {
+				q[i] = QuaternionT<T>::integrate(q[i], angularVelocity[i], dt);
+			}
+		}
+	} // namespace detail
+
+	inline void rotateVectors(std::span<const QuaternionT<float>> q, std::span<const Vec3T<float>> in, std::span<Vec3T<float>> out) {
+		detail::rotateVectors<float>(q, in, out);
+	}
+
+	inline void rotateVectors(std::span<const QuaternionT<double>> q, std::span<const Vec3T<double>> in, std::span<Vec3T<double>> out) {
+		detail::rotateVectors<double>(q, in, out);
+	}
+
+	inline void multiplyQuaternions(std::span<const QuaternionT<float>> a, std::span<const QuaternionT<float>> b, std::span<QuaternionT<float>> out) {
+		detail::multiplyQuaternions<float>(a, b, out);
+	}
+
+	inline void multiplyQuaternions(std::span<const QuaternionT<double>> a, std::span<const QuaternionT<double>> b, std::span<QuaternionT<double>> out) {
+		detail::multiplyQuaternions<double>(a, b, out);
+	}
+
+	inline void integrateOrientations(std::span<QuaternionT<float>> q, std::span<const Vec3T<float>> angularVelocity, float dt) {
+		detail::integrateOrientations<float>(q, angularVelocity, dt);
+	}
+
+	inline void integrateOrientations(std::span<QuaternionT<double>> q, std::span<const Vec3T<double>> angularVelocity, double dt) {
+		detail::integrateOrientations<double>(q, angularVelocity, dt);
+	}
+
 } // namespace nwt
 
 namespace std {
-	template<>
-	struct hash<nwt::Quaternion> {
-		size_t operator()(nwt::Quaternion const& q) const {
-			size_t combinedHash = hash<float>()(q.w);
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(q.x));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(q.y));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(q.z));
-			return combinedHash;
+	template<typename T>
+	struct hash<nwt::QuaternionT<T>> {
+		size_t operator()(nwt::QuaternionT<T> const& q) const {
+			return nwt::Hash::HashFloats(q.w, q.x, q.y, q.z);
 		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,374 @@
+#pragma once
+
+// Compile time selection of the SIMD backend used by the math kernels.
+// The instruction set is chosen by the compiler flags (see NEWTONS_UTILS_SIMD in CMakeLists.txt),
+// defining NWT_SIMD_DISABLE forces the scalar fallback everywhere.
+
+#if !defined(NWT_SIMD_DISABLE)
+	#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+		#define NWT_SIMD_AVX2 1
+	#endif
+
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define NWT_SIMD_SSE 1
+		#include <immintrin.h>
+	#elif defined(__ARM_NEON) || defined(_M_ARM64)
+		#define NWT_SIMD_NEON 1
+		#include <arm_neon.h>
+	#endif
+#endif
+
+#if defined(NWT_SIMD_SSE) || defined(NWT_SIMD_NEON)
+	#define NWT_SIMD_ENABLED 1
+#endif
+
+namespace nwt::simd {
+	// Whether the math types of precision T have a vectorized path, 4 doubles need AVX2.
+	template<typename T>
+	inline constexpr bool enabled = false;
+
+#if defined(NWT_SIMD_ENABLED)
+	template<>
+	inline constexpr bool enabled<float> = true;
+#endif
+
+#if defined(NWT_SIMD_AVX2)
+	template<>
+	inline constexpr bool enabled<double> = true;
+
+	using f64x4 = __m256d;
+
+	inline f64x4 load(const double* p) { return _mm256_load_pd(p); }
+	inline void store(double* p, f64x4 v) { _mm256_store_pd(p, v); }
+	inline f64x4 splat(double v) { return _mm256_set1_pd(v); }
+
+	inline f64x4 add(f64x4 a, f64x4 b) { return _mm256_add_pd(a, b); }
+	inline f64x4 sub(f64x4 a, f64x4 b) { return _mm256_sub_pd(a, b); }
+	inline f64x4 mul(f64x4 a, f64x4 b) { return _mm256_mul_pd(a, b); }
+	inline f64x4 div(f64x4 a, f64x4 b) { return _mm256_div_pd(a, b); }
+	inline f64x4 neg(f64x4 a) { return _mm256_xor_pd(a, _mm256_set1_pd(-0.0)); }
+	inline f64x4 sqrt(f64x4 a) { return _mm256_sqrt_pd(a); }
+
+	// a * b + c
+	inline f64x4 madd(f64x4 a, f64x4 b, f64x4 c) { return _mm256_fmadd_pd(a, b, c); }
+
+	template<int lane>
+	inline f64x4 broadcast(f64x4 v) { return _mm256_permute4x64_pd(v, _MM_SHUFFLE(lane, lane, lane, lane)); }
+
+	inline double hsum(f64x4 v) {
+		__m128d sums = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+		return _mm_cvtsd_f64(_mm_add_sd(sums, _mm_unpackhi_pd(sums, sums)));
+	}
+
+	inline double dot(f64x4 a, f64x4 b) { return hsum(_mm256_mul_pd(a, b)); }
+
+	// Transposes the 4x4 block held in rows r0 to r3, the 128 bit halves are swapped across the rows after the unpacks.
+	inline void transpose4(f64x4& r0, f64x4& r1, f64x4& r2, f64x4& r3) {
+		const f64x4 t0 = _mm256_unpacklo_pd(r0, r1);
+		const f64x4 t1 = _mm256_unpackhi_pd(r0, r1);
+		const f64x4 t2 = _mm256_unpacklo_pd(r2, r3);
+		const f64x4 t3 = _mm256_unpackhi_pd(r2, r3);
+		r0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+		r1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+		r2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+		r3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+	}
+
+	using f32x8 = __m256;
+	using m32x8 = __m256;
+
+	inline f32x8 load8(const float* p) { return _mm256_loadu_ps(p); }
+	inline void store(float* p, f32x8 v) { _mm256_storeu_ps(p, v); }
+	inline f32x8 splat8(float v) { return _mm256_set1_ps(v); }
+
+	inline f32x8 add(f32x8 a, f32x8 b) { return _mm256_add_ps(a, b); }
+	inline f32x8 sub(f32x8 a, f32x8 b) { return _mm256_sub_ps(a, b); }
+	inline f32x8 mul(f32x8 a, f32x8 b) { return _mm256_mul_ps(a, b); }
+	inline f32x8 div(f32x8 a, f32x8 b) { return _mm256_div_ps(a, b); }
+	inline f32x8 neg(f32x8 a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+	inline f32x8 abs(f32x8 a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+	inline f32x8 min(f32x8 a, f32x8 b) { return _mm256_min_ps(a, b); }
+	inline f32x8 max(f32x8 a, f32x8 b) { return _mm256_max_ps(a, b); }
+	inline f32x8 madd(f32x8 a, f32x8 b, f32x8 c) { return _mm256_fmadd_ps(a, b, c); }
+	inline f32x8 sqrt(f32x8 a) { return _mm256_sqrt_ps(a); }
+
+	inline f32x8 round(f32x8 a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+	inline f32x8 floor(f32x8 a) { return _mm256_floor_ps(a); }
+
+	inline m32x8 less(f32x8 a, f32x8 b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	inline m32x8 greater(f32x8 a, f32x8 b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	// mask ? a : b per lane
+	inline f32x8 select(m32x8 mask, f32x8 a, f32x8 b) { return _mm256_blendv_ps(b, a, mask); }
+
+	// Estimate (12 bits) refined by one Newton-Raphson step, about 22 bits.
+	inline f32x8 rsqrt(f32x8 a) {
+		const f32x8 y = _mm256_rsqrt_ps(a);
+		return _mm256_mul_ps(y, _mm256_fnmadd_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), a), _mm256_mul_ps(y, y), _mm256_set1_ps(1.5f)));
+	}
+
+	// Transposes the 4x4 blocks of both 128 bit lanes, rows loaded from 8 consecutive 4 float elements
+	// end up with the even elements in the low and the odd ones in the high lane. Transposing back restores the order.
+	inline void transpose4(f32x8& r0, f32x8& r1, f32x8& r2, f32x8& r3) {
+		const f32x8 t0 = _mm256_unpacklo_ps(r0, r1);
+		const f32x8 t1 = _mm256_unpacklo_ps(r2, r3);
+		const f32x8 t2 = _mm256_unpackhi_ps(r0, r1);
+		const f32x8 t3 = _mm256_unpackhi_ps(r2, r3);
+		r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+		r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+		r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+		r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+	}
+
+	// The f32x4 deinterleave3 and interleave3 on both 128 bit lanes, each lane holds 4 triples.
+	inline void deinterleave3(f32x8 a, f32x8 b, f32x8 c, f32x8& x, f32x8& y, f32x8& z) {
+		x = _mm256_shuffle_ps(a, _mm256_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 3, 2)), _MM_SHUFFLE(3, 0, 3, 0));
+		y = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+		z = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm256_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+	}
+
+	inline void interleave3(f32x8 x, f32x8 y, f32x8 z, f32x8& a, f32x8& b, f32x8& c) {
+		a = _mm256_shuffle_ps(_mm256_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm256_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+		b = _mm256_shuffle_ps(_mm256_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+		c = _mm256_shuffle_ps(_mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+	}
+#endif
+
+#if defined(NWT_SIMD_SSE)
+	using f32x4 = __m128;
+
+	inline f32x4 load(const float* p) { return _mm_load_ps(p); }
+	inline void store(float* p, f32x4 v) { _mm_store_ps(p, v); }
+	inline f32x4 loadu(const float* p) { return _mm_loadu_ps(p); }
+	inline void storeu(float* p, f32x4 v) { _mm_storeu_ps(p, v); }
+	inline f32x4 splat(float v) { return _mm_set1_ps(v); }
+
+	inline f32x4 add(f32x4 a, f32x4 b) { return _mm_add_ps(a, b); }
+	inline f32x4 sub(f32x4 a, f32x4 b) { return _mm_sub_ps(a, b); }
+	inline f32x4 mul(f32x4 a, f32x4 b) { return _mm_mul_ps(a, b); }
+	inline f32x4 neg(f32x4 a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+
+	// a * b + c
+	inline f32x4 madd(f32x4 a, f32x4 b, f32x4 c) {
+	#if defined(__FMA__)
+		return _mm_fmadd_ps(a, b, c);
+	#else
+		return _mm_add_ps(_mm_mul_ps(a, b), c);
+	#endif
+	}
+
+	template<int lane>
+	inline f32x4 broadcast(f32x4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(lane, lane, lane, lane)); }
+
+	inline float hsum(f32x4 v) {
+		f32x4 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+		f32x4 sums = _mm_add_ps(v, shuf);
+		shuf = _mm_movehl_ps(shuf, sums);
+		return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+	}
+
+	inline float dot(f32x4 a, f32x4 b) {
+	#if defined(__SSE4_1__)
+		return _mm_cvtss_f32(_mm_dp_ps(a, b, 0xF1));
+	#else
+		return hsum(_mm_mul_ps(a, b));
+	#endif
+	}
+
+	using m32x4 = __m128;
+
+	inline f32x4 div(f32x4 a, f32x4 b) { return _mm_div_ps(a, b); }
+	inline f32x4 abs(f32x4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+	inline f32x4 min(f32x4 a, f32x4 b) { return _mm_min_ps(a, b); }
+	inline f32x4 max(f32x4 a, f32x4 b) { return _mm_max_ps(a, b); }
+	inline f32x4 sqrt(f32x4 a) { return _mm_sqrt_ps(a); }
+
+	// Round to nearest (the default MXCSR mode), only valid for |a| < 2^31.
+	inline f32x4 round(f32x4 a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+	inline f32x4 floor(f32x4 a) {
+	#if defined(__SSE4_1__)
+		return _mm_floor_ps(a);
+	#else
+		const f32x4 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+		return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+	#endif
+	}
+
+	inline m32x4 less(f32x4 a, f32x4 b) { return _mm_cmplt_ps(a, b); }
+	inline m32x4 greater(f32x4 a, f32x4 b) { return _mm_cmpgt_ps(a, b); }
+	// mask ? a : b per lane
+	inline f32x4 select(m32x4 mask, f32x4 a, f32x4 b) {
+	#if defined(__SSE4_1__)
+		return _mm_blendv_ps(b, a, mask);
+	#else
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	#endif
+	}
+
+	// Estimate (12 bits) refined by one Newton-Raphson step, about 22 bits.
+	inline f32x4 rsqrt(f32x4 a) {
+		const f32x4 y = _mm_rsqrt_ps(a);
+		return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), a), _mm_mul_ps(y, y))));
+	}
+
+	inline void transpose4(f32x4& r0, f32x4& r1, f32x4& r2, f32x4& r3) { _MM_TRANSPOSE4_PS(r0, r1, r2, r3); }
+
+	// Splits 4 tightly packed x, y, z triples, loaded as (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3), into x, y and z.
+	inline void deinterleave3(f32x4 a, f32x4 b, f32x4 c, f32x4& x, f32x4& y, f32x4& z) {
+		x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 3, 2)), _MM_SHUFFLE(3, 0, 3, 0));
+		y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+		z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+	}
+
+	// Inverse of deinterleave3
+	inline void interleave3(f32x4 x, f32x4 y, f32x4 z, f32x4& a, f32x4& b, f32x4& c) {
+		a = _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+		b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+		c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+	}
+#elif defined(NWT_SIMD_NEON)
+	using f32x4 = float32x4_t;
+
+	inline f32x4 load(const float* p) { return vld1q_f32(p); }
+	inline void store(float* p, f32x4 v) { vst1q_f32(p, v); }
+	inline f32x4 loadu(const float* p) { return vld1q_f32(p); }
+	inline void storeu(float* p, f32x4 v) { vst1q_f32(p, v); }
+	inline f32x4 splat(float v) { return vdupq_n_f32(v); }
+
+	inline f32x4 add(f32x4 a, f32x4 b) { return vaddq_f32(a, b); }
+	inline f32x4 sub(f32x4 a, f32x4 b) { return vsubq_f32(a, b); }
+	inline f32x4 mul(f32x4 a, f32x4 b) { return vmulq_f32(a, b); }
+	inline f32x4 neg(f32x4 a) { return vnegq_f32(a); }
+
+	// a * b + c
+	inline f32x4 madd(f32x4 a, f32x4 b, f32x4 c) { return vfmaq_f32(c, a, b); }
+
+	template<int lane>
+	inline f32x4 broadcast(f32x4 v) { return vdupq_laneq_f32(v, lane); }
+
+	inline float hsum(f32x4 v) { return vaddvq_f32(v); }
+	inline float dot(f32x4 a, f32x4 b) { return vaddvq_f32(vmulq_f32(a, b)); }
+
+	using m32x4 = uint32x4_t;
+
+	inline f32x4 div(f32x4 a, f32x4 b) { return vdivq_f32(a, b); }
+	inline f32x4 abs(f32x4 a) { return vabsq_f32(a); }
+	inline f32x4 min(f32x4 a, f32x4 b) { return vminq_f32(a, b); }
+	inline f32x4 max(f32x4 a, f32x4 b) { return vmaxq_f32(a, b); }
+	inline f32x4 sqrt(f32x4 a) { return vsqrtq_f32(a); }
+
+	inline f32x4 round(f32x4 a) { return vrndnq_f32(a); }
+	inline f32x4 floor(f32x4 a) { return vrndmq_f32(a); }
+
+	inline m32x4 less(f32x4 a, f32x4 b) { return vcltq_f32(a, b); }
+	inline m32x4 greater(f32x4 a, f32x4 b) { return vcgtq_f32(a, b); }
+	// mask ? a : b per lane
+	inline f32x4 select(m32x4 mask, f32x4 a, f32x4 b) { return vbslq_f32(mask, a, b); }
+
+	// The NEON estimate only has 8 bits, two Newton-Raphson steps bring it to about 22 bits.
+	inline f32x4 rsqrt(f32x4 a) {
+		f32x4 y = vrsqrteq_f32(a);
+		y = vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(a, y), y));
+		return vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(a, y), y));
+	}
+
+	inline void transpose4(f32x4& r0, f32x4& r1, f32x4& r2, f32x4& r3) {
+		const float32x4x2_t t01 = vtrnq_f32(r0, r1);
+		const float32x4x2_t t23 = vtrnq_f32(r2, r3);
+		r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+		r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+		r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+		r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+	}
+#endif
+
+#if defined(NWT_SIMD_ENABLED)
+	//
+	// Transcendentals, written once for f32x4 and f32x8.
+	// Same reductions and polynomials as Mathf::fastSincos and Mathf::fastAtan2.
+	//
+
+	template<typename V> V splatAs(float v);
+	template<> inline f32x4 splatAs<f32x4>(float v) { return splat(v); }
+	// Unaligned load, lets the generic kernels load 4 or 8 lanes with the same code
+	template<typename V> V loadAs(const float* p);
+	template<> inline f32x4 loadAs<f32x4>(const float* p) { return loadu(p); }
+#if defined(NWT_SIMD_AVX2)
+	template<> inline f32x8 splatAs<f32x8>(float v) { return splat8(v); }
+	template<> inline f32x8 loadAs<f32x8>(const float* p) { return load8(p); }
+
+	// Doubles only come 4 wide, from the 32 byte aligned Vec3d and Quaterniond
+	template<typename V> V splatAs(double v);
+	template<> inline f64x4 splatAs<f64x4>(double v) { return splat(v); }
+	template<typename V> V loadAs(const double* p);
+	template<> inline f64x4 loadAs<f64x4>(const double* p) { return load(p); }
+#endif
+
+	template<typename V>
+	inline void sincos(V x, V& s, V& c) {
+		// q = nearest multiple of PI/2, the remainder r in [-PI/4, PI/4] is computed with PI/2 split into three parts
+		const V q = round(mul(x, splatAs<V>(0.63661977f)));
+		V r = madd(q, splatAs<V>(-1.5703125f), x);
+		r = madd(q, splatAs<V>(-4.837512969970703125e-4f), r);
+		r = madd(q, splatAs<V>(-7.54978995489188216e-8f), r);
+		const V z = mul(r, r);
+
+		V ps = madd(splatAs<V>(-1.9515295891e-4f), z, splatAs<V>(8.3321608736e-3f));
+		ps = madd(ps, z, splatAs<V>(-1.6666654611e-1f));
+		ps = madd(mul(ps, z), r, r);
+
+		V pc = madd(splatAs<V>(2.443315711809948e-5f), z, splatAs<V>(-1.388731625493765e-3f));
+		pc = madd(pc, z, splatAs<V>(4.166664568298827e-2f));
+		pc = madd(mul(pc, z), z, madd(splatAs<V>(-0.5f), z, splatAs<V>(1.0f)));
+
+		// quadrant = q mod 4, the odd quadrants swap sin and cos
+		const V quadrant = sub(q, mul(splatAs<V>(4.0f), floor(mul(q, splatAs<V>(0.25f)))));
+		const V q1 = add(quadrant, splatAs<V>(1.0f));
+		const auto swap = greater(sub(quadrant, mul(splatAs<V>(2.0f), floor(mul(quadrant, splatAs<V>(0.5f))))), splatAs<V>(0.5f));
+		const auto sinNegative = greater(quadrant, splatAs<V>(1.5f));
+		const auto cosNegative = greater(sub(q1, mul(splatAs<V>(4.0f), floor(mul(q1, splatAs<V>(0.25f))))), splatAs<V>(1.5f));
+
+		const V sinValue = select(swap, pc, ps);
+		const V cosValue = select(swap, ps, pc);
+		s = select(sinNegative, neg(sinValue), sinValue);
+		c = select(cosNegative, neg(cosValue), cosValue);
+	}
+
+	template<typename V>
+	inline V sin(V x) {
+		V s, c;
+		sincos(x, s, c);
+		return s;
+	}
+
+	template<typename V>
+	inline V cos(V x) {
+		V s, c;
+		sincos(x, s, c);
+		return c;
+	}
+
+	template<typename V>
+	inline V atan2(V y, V x) {
+		const V ax = abs(x);
+		const V ay = abs(y);
+		const V hi = max(ax, ay);
+		// the origin maps to 0 instead of dividing 0 by 0
+		const V t = select(greater(hi, splatAs<V>(0.0f)), div(min(ax, ay), hi), splatAs<V>(0.0f));
+
+		// t in [0, 1], above tan(PI/8) use atan(t) = PI/4 + atan((t - 1) / (t + 1))
+		const auto reduce = greater(t, splatAs<V>(0.41421356f));
+		const V u = select(reduce, div(sub(t, splatAs<V>(1.0f)), add(t, splatAs<V>(1.0f))), t);
+		const V z = mul(u, u);
+
+		V p = madd(splatAs<V>(8.05374449538e-2f), z, splatAs<V>(-1.38776856032e-1f));
+		p = madd(p, z, splatAs<V>(1.99777106478e-1f));
+		p = madd(p, z, splatAs<V>(-3.33329491539e-1f));
+		p = madd(mul(p, z), u, u);
+		V result = select(reduce, add(p, splatAs<V>(0.78539816f)), p);
+
+		result = select(greater(ay, ax), sub(splatAs<V>(1.5707964f), result), result);
+		result = select(less(x, splatAs<V>(0.0f)), sub(splatAs<V>(3.1415927f), result), result);
+		return select(less(y, splatAs<V>(0.0f)), neg(result), result);
+	}
+#endif
+} // namespace nwt::simd
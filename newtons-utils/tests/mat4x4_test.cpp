@@ -1,6 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include "mat4x4.hpp"
 
+#include <vector>
+
 using namespace nwt;
 
 TEST_CASE( "Mat4x4 identity check", "[mat4x4]" ){
@@ -36,3 +38,185 @@ TEST_CASE( "Mat4x4 x Vec4 multiplication calculation", "[mat4x4]" ){
     REQUIRE(mat2 * vec == Vec4(772, 144.5f, 310.1f, 435.525f));
 }
 
+
+TEST_CASE( "Mat4x4 multiplication matches constant evaluation", "[mat4x4]" ){
+    constexpr Mat4x4 lhs(2, 50, 10, 2, 1.5f, 2, 60, 2, 6, 6, 7, 2, 8, 48, 0.1f, 0);
+    constexpr Mat4x4 rhs(8, 6, 84, 1, 94, 8.5f, 12, 54, 1.1f, 5, 23, 2, 0, 15, 1, 0.25);
+    constexpr Vec4 vec(2.5f, 8, 0, 4.1f);
+
+    constexpr Mat4x4 folded = lhs * rhs;
+    constexpr Vec4 foldedVec = lhs * vec;
+
+    Mat4x4 runtimeLhs = lhs;
+    Mat4x4 result = runtimeLhs * rhs;
+
+    for (char col = 0; col < 4; col++) {
+        REQUIRE(result.getCol(col) == folded.getCol(col));
+    }
+    REQUIRE(runtimeLhs * vec == foldedVec);
+}
+
+TEST_CASE( "Mat4x4 inverse calculation", "[mat4x4]" ){
+    Mat4x4 mat(2, 50, 10, 2, 1.5f, 2, 60, 2, 6, 6, 7, 2, 8, 48, 0.1f, 0);
+    Mat4x4 inverse = mat.inverse();
+
+    REQUIRE(Mathf::inEpsilon(Mat4x4::identity().determinant() - 1));
+    REQUIRE(Mathf::inEpsilon(mat.determinant() * inverse.determinant() - 1));
+
+    Mat4x4 product = mat * inverse;
+    for (char col = 0; col < 4; col++) {
+        REQUIRE(product.getCol(col) == Mat4x4::identity().getCol(col));
+    }
+
+    constexpr Mat4x4 folded = Mat4x4(2, 50, 10, 2, 1.5f, 2, 60, 2, 6, 6, 7, 2, 8, 48, 0.1f, 0).inverse();
+    for (char col = 0; col < 4; col++) {
+        REQUIRE(inverse.getCol(col) == folded.getCol(col));
+    }
+}
+
+TEST_CASE( "Mat4x4 affine inverse calculation", "[mat4x4]" ){
+    Mat4x4 mat = Mat4x4::rotate({Mathf::cos(78.1f * Mathf::DegToRad), Mathf::sin(78.1f * Mathf::DegToRad) * Vec3(1,0.5f,1).normalized()}) * 2.0f;
+    mat.setRow(3, 0, 0, 0, 1);
+    mat.setCol(3, 1, -0.5f, 0.25f, 1);
+
+    Mat4x4 affine = mat.affineInverse();
+    Mat4x4 general = mat.inverse();
+    Mat4x4 product = affine * mat;
+
+    for (char col = 0; col < 4; col++) {
+        REQUIRE(affine.getCol(col) == general.getCol(col));
+        REQUIRE(product.getCol(col) == Mat4x4::identity().getCol(col));
+    }
+}
+
+TEST_CASE( "Mat4x4 batched point and direction transformation", "[mat4x4]" ){
+    Mat4x4 mat = Mat4x4::rotate({Mathf::cos(78.1f * Mathf::DegToRad), Mathf::sin(78.1f * Mathf::DegToRad) * Vec3(1,0.5f,1).normalized()}) * 2.0f;
+    mat.setRow(3, 0, 0, 0, 1);
+    mat.setCol(3, 1, -0.5f, 0.25f, 1);
+
+    // 19 covers the 8 and 4 wide blocks as well as the scalar tail
+    std::vector<Vec3> points;
+    for (int i = 0; i < 19; i++) {
+        points.emplace_back(0.1f * i, 1.0f - 0.05f * i, -0.2f * i);
+    }
+
+    std::vector<Vec3> transformed(points.size());
+    std::vector<Vec3> directions(points.size());
+    transformPoints(mat, points, transformed);
+    transformDirections(mat, points, directions);
+
+    for (size_t i = 0; i < points.size(); i++) {
+        const Vec3& p = points[i];
+        REQUIRE(transformed[i] == static_cast<Vec3>(mat * Vec4(p.x, p.y, p.z, 1)));
+        REQUIRE(directions[i] == static_cast<Vec3>(mat * Vec4(p.x, p.y, p.z, 0)));
+    }
+
+    transformPoints(mat, points, points);
+    for (size_t i = 0; i < points.size(); i++) {
+        REQUIRE(points[i] == transformed[i]);
+    }
+}
+
+TEST_CASE( "Mat4x4 batched transformation of packed points", "[mat4x4]" ){
+    Mat4x4 mat = Mat4x4::rotate({Mathf::cos(40.3f * Mathf::DegToRad), Mathf::sin(40.3f * Mathf::DegToRad) * Vec3(0.3f, -1, 0.6f).normalized()}) * 1.5f;
+    mat.setRow(3, 0, 0, 0, 1);
+    mat.setCol(3, -2, 0.75f, 0.5f, 1);
+
+    // 19 covers the 8 and 4 wide blocks as well as the scalar tail
+    std::vector<Vec3Packed> points;
+    for (int i = 0; i < 19; i++) {
+        points.emplace_back(0.1f * i - 1.0f, 0.3f * i, 2.0f - 0.15f * i);
+    }
+
+    std::vector<Vec3Packed> transformed(points.size());
+    std::vector<Vec3Packed> directions(points.size());
+    transformPoints(mat, points, transformed);
+    transformDirections(mat, points, directions);
+
+    for (size_t i = 0; i < points.size(); i++) {
+        const Vec3 p = points[i];
+        REQUIRE(transformed[i] == Vec3Packed(static_cast<Vec3>(mat * Vec4(p.x, p.y, p.z, 1))));
+        REQUIRE(directions[i] == Vec3Packed(static_cast<Vec3>(mat * Vec4(p.x, p.y, p.z, 0))));
+    }
+
+    transformPoints(mat, points, points);
+    for (size_t i = 0; i < points.size(); i++) {
+        REQUIRE(points[i] == transformed[i]);
+    }
+}
+
+TEST_CASE( "Mat4x4d matches Mat4x4", "[mat4x4]" ){
+    Mat4x4 mat = Mat4x4::rotate({Mathf::cos(31.5f * Mathf::DegToRad), Mathf::sin(31.5f * Mathf::DegToRad) * Vec3(0.2f, 1, 0.4f).normalized()});
+    mat.setCol(3, 1, -0.5f, 0.25f, 1);
+    Mat4x4d matd(mat);
+
+    Mat4x4 product = mat * mat;
+    Mat4x4d productd = matd * matd;
+    Mat4x4d inversed = matd.inverse() * matd;
+    Vec4d vec = matd * Vec4d(1.0, 2.0, 3.0, 1.0);
+
+    for (char col = 0; col < 4; col++) {
+        REQUIRE(static_cast<Vec4>(productd.getCol(col)) == product.getCol(col));
+        REQUIRE(inversed.getCol(col) == Mat4x4d::identity().getCol(col));
+    }
+    REQUIRE(static_cast<Vec4>(vec) == mat * Vec4(1, 2, 3, 1));
+
+    // 7 covers the 4 wide block as well as the scalar tail
+    std::vector<Vec3d> points;
+    for (int i = 0; i < 7; i++) {
+        points.emplace_back(1.0 - 0.3 * i, 2.0 + 0.5 * i, 0.25 * i - 3.0);
+    }
+    std::vector<Vec3d> transformed(points.size());
+    std::vector<Vec3d> directions(points.size());
+    transformPoints(matd, points, transformed);
+    transformDirections(matd, points, directions);
+    for (size_t i = 0; i < points.size(); i++) {
+        const Vec3d& p = points[i];
+        REQUIRE(transformed[i] == static_cast<Vec3d>(matd * Vec4d(p.x, p.y, p.z, 1.0)));
+        REQUIRE(directions[i] == static_cast<Vec3d>(matd * Vec4d(p.x, p.y, p.z, 0.0)));
+    }
+}
+
+TEST_CASE( "Mat4x4d inverse matches constant evaluation", "[mat4x4]" ){
+    Mat4x4d mat(2, 50, 10, 2, 1.5, 2, 60, 2, 6, 6, 7, 2, 8, 48, 0.1, 0);
+    Mat4x4d inverse = mat.inverse();
+    constexpr Mat4x4d folded = Mat4x4d(2, 50, 10, 2, 1.5, 2, 60, 2, 6, 6, 7, 2, 8, 48, 0.1, 0).inverse();
+
+    Mat4x4d product = mat * inverse;
+    for (char col = 0; col < 4; col++) {
+        REQUIRE(inverse.getCol(col) == folded.getCol(col));
+        REQUIRE(product.getCol(col) == Mat4x4d::identity().getCol(col));
+    }
+}
+
+TEST_CASE( "Mat4x4d multiplication matches constant evaluation", "[mat4x4]" ){
+    constexpr Mat4x4d a(
+        1, 2, 3, 4,
+        5, 6, 7, 8,
+        9, 10, 11, 12,
+        13, 14, 15, 16);
+    constexpr Mat4x4d b = a.transposed();
+    constexpr Mat4x4d expected = a * b;
+
+    Mat4x4d runtimeA = a;
+    Mat4x4d result = runtimeA * b;
+    for (char col = 0; col < 4; col++) {
+        REQUIRE(result.getCol(col) == expected.getCol(col));
+    }
+}
+
+TEST_CASE( "Mat4x4 camera matrices fold at compile time", "[mat4x4]" ){
+    constexpr Mat4x4 proj = Mat4x4::perspective(60.0f * Mathf::DegToRad, 16.0f / 9.0f, 0.01f, 100.0f);
+    constexpr Mat4x4 view = Mat4x4::lookAt(Vec3(0.0f, 2.0f, -5.0f), Vec3(0.0f, 0.0f, 0.0f));
+    constexpr Quaternion rotation = Quaternion::fromEuler(0.0f, 90.0f * Mathf::DegToRad, -90.0f * Mathf::DegToRad);
+
+    float fov = 60.0f * Mathf::DegToRad;
+    Vec3 eye(0.0f, 2.0f, -5.0f);
+    Mat4x4 runtimeProj = Mat4x4::perspective(fov, 16.0f / 9.0f, 0.01f, 100.0f);
+    Mat4x4 runtimeView = Mat4x4::lookAt(eye, Vec3(0.0f, 0.0f, 0.0f));
+    for (char col = 0; col < 4; col++) {
+        REQUIRE(proj.getCol(col) == runtimeProj.getCol(col));
+        REQUIRE(view.getCol(col) == runtimeView.getCol(col));
+    }
+    REQUIRE(rotation == Quaternion::fromEuler(0.0f, fov * 1.5f, -fov * 1.5f));
+}
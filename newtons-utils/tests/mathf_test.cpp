@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+#include "mathf.hpp"
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+using namespace nwt;
+
+TEST_CASE( "Mathf sincos matches sin and cos", "[mathf]" ){
+    for (float x = -10.0f; x <= 10.0f; x += 0.37f) {
+        float s, c;
+        Mathf::sincos(x, s, c);
+        REQUIRE(s == Mathf::sin(x));
+        REQUIRE(c == Mathf::cos(x));
+    }
+}
+
+TEST_CASE( "Mathf fast approximations stay within their error bounds", "[mathf]" ){
+    for (float x = -100.0f; x <= 100.0f; x += 0.013f) {
+        float s, c;
+        Mathf::fastSincos(x, s, c);
+        REQUIRE(Mathf::inEpsilon(s - Mathf::sin(x)));
+        REQUIRE(Mathf::inEpsilon(c - Mathf::cos(x)));
+        REQUIRE(Mathf::fastSin(x) == s);
+        REQUIRE(Mathf::fastCos(x) == c);
+    }
+
+    for (float y = -2.0f; y <= 2.0f; y += 0.17f) {
+        for (float x = -2.0f; x <= 2.0f; x += 0.23f) {
+            REQUIRE(Mathf::inEpsilon(Mathf::fastAtan2(y, x) - Mathf::atan2(y, x)));
+        }
+    }
+    REQUIRE(Mathf::fastAtan2(0, 0) == 0);
+
+    for (float x = 0.001f; x < 1000.0f; x *= 1.7f) {
+        REQUIRE(Mathf::abs(Mathf::rsqrt(x) * Mathf::sqrt(x) - 1) < 3e-7f);
+    }
+}
+
+TEST_CASE( "Mathf batched approximations match the scalar versions", "[mathf]" ){
+    // 27 covers the 8 and 4 wide blocks as well as the scalar tail
+    std::vector<float> x, y;
+    for (int i = 0; i < 27; i++) {
+        x.push_back(-7.0f + 0.53f * i);
+        y.push_back(3.0f - 0.29f * i);
+    }
+
+    std::vector<float> s(x.size()), c(x.size()), angles(x.size()), inverse(x.size());
+    Mathf::fastSincos(x, s, c);
+    Mathf::fastAtan2(y, x, angles);
+    Mathf::rsqrt(std::vector<float>(c.size(), 2.0f), inverse);
+
+    for (size_t i = 0; i < x.size(); i++) {
+        REQUIRE(Mathf::inEpsilon(s[i] - Mathf::fastSin(x[i])));
+        REQUIRE(Mathf::inEpsilon(c[i] - Mathf::fastCos(x[i])));
+        REQUIRE(Mathf::inEpsilon(angles[i] - Mathf::fastAtan2(y[i], x[i])));
+        REQUIRE(Mathf::inEpsilon(inverse[i] - Mathf::rsqrt(2.0f)));
+    }
+}
+
+TEST_CASE( "Mathf constant evaluation matches the runtime functions", "[mathf]" ){
+    static constexpr float angles[] = { -7.5f, -3.0f, -1.2f, -0.1f, 0.0f, 0.4f, 1.5707964f, 2.5f, 6.0f, 100.0f };
+    static constexpr float values[] = { -1.0f, -0.75f, -0.2f, 0.0f, 0.3f, 0.9f, 1.0f };
+
+    // The compile time versions are computed in double, both round to within a couple of ulp
+    constexpr auto relativeEqual = [](float a, float b) { return Mathf::abs(a - b) <= 4e-7f * Mathf::max(1.0f, Mathf::abs(b)); };
+
+    STATIC_REQUIRE(Mathf::sqrt(4.0f) == 2.0f);
+    STATIC_REQUIRE(Mathf::sin(0.0f) == 0.0f);
+    STATIC_REQUIRE(Mathf::cos(0.0f) == 1.0f);
+
+    for (size_t i = 0; i < std::size(angles); i++) {
+        const float x = angles[i];
+        float s, c;
+        Mathf::sincos(x, s, c);
+        REQUIRE(relativeEqual(s, Mathf::sin(x)));
+        REQUIRE(relativeEqual(c, Mathf::cos(x)));
+        REQUIRE(relativeEqual(Mathf::atan(x), std::atan(x)));
+        REQUIRE(relativeEqual(Mathf::sqrt(Mathf::abs(x)), std::sqrt(Mathf::abs(x))));
+    }
+
+    constexpr auto constSines = [] {
+        std::array<float, std::size(angles)> result{};
+        for (size_t i = 0; i < std::size(angles); i++) result[i] = Mathf::sin(angles[i]);
+        return result;
+    }();
+    constexpr auto constCosines = [] {
+        std::array<float, std::size(angles)> result{};
+        for (size_t i = 0; i < std::size(angles); i++) result[i] = Mathf::cos(angles[i]);
+        return result;
+    }();
+    constexpr auto constTangents = [] {
+        std::array<float, std::size(angles)> result{};
+        for (size_t i = 0; i < std::size(angles); i++) result[i] = Mathf::tan(angles[i]);
+        return result;
+    }();
+    for (size_t i = 0; i < std::size(angles); i++) {
+        REQUIRE(relativeEqual(constSines[i], std::sin(angles[i])));
+        REQUIRE(relativeEqual(constCosines[i], std::cos(angles[i])));
+        REQUIRE(relativeEqual(constTangents[i], std::tan(angles[i])));
+    }
+
+    constexpr auto constInverse = [] {
+        std::array<float, 3 * std::size(values)> result{};
+        for (size_t i = 0; i < std::size(values); i++) {
+            result[3 * i] = Mathf::asin(values[i]);
+            result[3 * i + 1] = Mathf::acos(values[i]);
+            result[3 * i + 2] = Mathf::atan2(values[i], -0.5f);
+        }
+        return result;
+    }();
+    for (size_t i = 0; i < std::size(values); i++) {
+        REQUIRE(relativeEqual(constInverse[3 * i], std::asin(values[i])));
+        REQUIRE(relativeEqual(constInverse[3 * i + 1], std::acos(values[i])));
+        REQUIRE(relativeEqual(constInverse[3 * i + 2], std::atan2(values[i], -0.5f)));
+    }
+}
@@ -1,6 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include "quaternion.hpp"
 
+#include <vector>
+
 using namespace nwt;
 
 TEST_CASE( "Quaternion identity check", "[quaternion]" ){
@@ -29,4 +31,100 @@ TEST_CASE( "Quaternion rotate vector calculation", "[quaternion]" ){
 TEST_CASE( "Quaternion form euler calculation", "[quaternion]" ){
     REQUIRE(Quaternion::fromEuler(0, 0, 0) == Quaternion(1, 0, 0, 0));
     REQUIRE(Quaternion::fromEuler(45 * Mathf::DegToRad, 20  * Mathf::DegToRad, 30  * Mathf::DegToRad) == Quaternion(0.8960407f, 0.3225058f, 0.2525045f, 0.1712969f));
-}
\ No newline at end of file
+}
+TEST_CASE( "Quaternion normalized keeps the component order", "[quaternion]" ){
+    REQUIRE(Quaternion(2, 0, 0, 0).normalized() == Quaternion(1, 0, 0, 0));
+    REQUIRE(Quaternion(0, 0, 3, 4).normalized() == Quaternion(0, 0, 0.6f, 0.8f));
+}
+
+TEST_CASE( "Quaternion slerp and nlerp calculation", "[quaternion]" ){
+    Quaternion a = Quaternion::fromEuler(0, 0, 0);
+    Quaternion b = Quaternion::fromEuler(0, 90 * Mathf::DegToRad, 0);
+
+    REQUIRE(Quaternion::slerp(a, b, 0) == a);
+    REQUIRE(Quaternion::slerp(a, b, 1) == b);
+    REQUIRE(Quaternion::slerp(a, b, 0.5f) == Quaternion::fromEuler(0, 45 * Mathf::DegToRad, 0));
+    REQUIRE(Quaternion::slerp(a, b, 0.25f) == Quaternion::fromEuler(0, 22.5f * Mathf::DegToRad, 0));
+    // -b is the same rotation, the interpolation still takes the shorter arc
+    REQUIRE(Quaternion::slerp(a, -b, 0.5f) == Quaternion::fromEuler(0, 45 * Mathf::DegToRad, 0));
+
+    REQUIRE(Quaternion::nlerp(a, b, 0.5f) == Quaternion::fromEuler(0, 45 * Mathf::DegToRad, 0));
+    REQUIRE(Quaternion::nlerp(a, b, 0.25f).isNormalized());
+    REQUIRE(Quaternion::slerp(b, b, 0.3f) == b);
+}
+
+TEST_CASE( "Quaternion exp and log calculation", "[quaternion]" ){
+    Quaternion q = Quaternion::fromEuler(30 * Mathf::DegToRad, -20 * Mathf::DegToRad, 70 * Mathf::DegToRad);
+
+    REQUIRE(Quaternion::exp(Quaternion::log(q)) == q);
+    REQUIRE(Quaternion::exp({0, 0, 0}) == Quaternion::identity());
+    REQUIRE(Quaternion::log(Quaternion::identity()) == Vec3(0, 0, 0));
+    REQUIRE(Quaternion::exp(Vec3(0, 45 * Mathf::DegToRad, 0)) == Quaternion::fromEuler(0, 90 * Mathf::DegToRad, 0));
+}
+
+TEST_CASE( "Quaternion angular velocity integration", "[quaternion]" ){
+    Quaternion q = Quaternion::identity();
+    // 90 degrees per second around y, integrated over one second in 100 steps
+    for (int i = 0; i < 100; i++) {
+        q = Quaternion::integrate(q, {0, 90 * Mathf::DegToRad, 0}, 0.01f);
+    }
+    REQUIRE(q == Quaternion::fromEuler(0, 90 * Mathf::DegToRad, 0));
+}
+
+TEST_CASE( "Quaternion batched kernels match the scalar versions", "[quaternion]" ){
+    // 15 covers the 8 and 4 wide blocks as well as the scalar tail
+    std::vector<Quaternion> a, b;
+    std::vector<Vec3> vectors, velocities;
+    for (int i = 0; i < 15; i++) {
+        a.push_back(Quaternion::fromEuler(0.3f * i, -0.2f * i, 0.1f * i + 0.5f));
+        b.push_back(Quaternion::fromEuler(-0.1f * i, 0.4f, 0.25f * i));
+        vectors.emplace_back(1.0f - 0.1f * i, 0.05f * i, 0.5f);
+        velocities.emplace_back(0.5f * i, -1.0f, 0.25f * i);
+    }
+
+    std::vector<Quaternion> products(a.size(), Quaternion::identity());
+    std::vector<Vec3> rotated(a.size());
+    multiplyQuaternions(a, b, products);
+    rotateVectors(a, vectors, rotated);
+
+    std::vector<Quaternion> integrated = a;
+    integrateOrientations(integrated, velocities, 0.016f);
+
+    for (size_t i = 0; i < a.size(); i++) {
+        REQUIRE(products[i] == a[i] * b[i]);
+        REQUIRE(rotated[i] == Quaternion::rotateVector(a[i], vectors[i]));
+        REQUIRE(integrated[i] == Quaternion::integrate(a[i], velocities[i], 0.016f));
+    }
+
+    rotateVectors(a, vectors, vectors);
+    for (size_t i = 0; i < a.size(); i++) {
+        REQUIRE(vectors[i] == rotated[i]);
+    }
+}
+
+TEST_CASE( "Quaterniond batched kernels match the scalar versions", "[quaternion]" ){
+    // 7 covers the 4 wide block as well as the scalar tail
+    std::vector<Quaterniond> a, b;
+    std::vector<Vec3d> vectors, velocities;
+    for (int i = 0; i < 7; i++) {
+        a.push_back(Quaterniond::fromEuler(0.3 * i, -0.2 * i, 0.1 * i + 0.5));
+        b.push_back(Quaterniond::fromEuler(-0.1 * i, 0.4, 0.25 * i));
+        vectors.emplace_back(1.0 - 0.1 * i, 0.05 * i, 0.5);
+        // The first velocity is zero, sin(angle) / angle falls back to 1
+        velocities.emplace_back(0.5 * i, -0.2 * i, 0.25 * i);
+    }
+
+    std::vector<Quaterniond> products(a.size(), Quaterniond::identity());
+    std::vector<Vec3d> rotated(a.size());
+    multiplyQuaternions(a, b, products);
+    rotateVectors(a, vectors, rotated);
+
+    std::vector<Quaterniond> integrated = a;
+    integrateOrientations(integrated, velocities, 0.016);
+
+    for (size_t i = 0; i < a.size(); i++) {
+        REQUIRE(products[i] == a[i] * b[i]);
+        REQUIRE(rotated[i] == Quaterniond::rotateVector(a[i], vectors[i]));
+        REQUIRE(integrated[i] == Quaterniond::integrate(a[i], velocities[i], 0.016));
+    }
+}
@@ -1,6 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include "vec3.hpp"
 
+#include <unordered_set>
+
 using namespace nwt;
 
 TEST_CASE( "Vec3 direction checks", "[vec3]" ) {
@@ -81,4 +83,55 @@ TEST_CASE( "Vec3 normalized calculation", "[vec3]" ){
     REQUIRE(Vec3(1, 0, 0).normalized() == Vec3(1, 0, 0));
     REQUIRE(Vec3(-2, 1, -2).normalized() == Vec3(-2, 1, -2) / 3.0f);
     // REQUIRE(Vec3::normalize(Vec3()) == Vec3());
-}
\ No newline at end of file
+}
+TEST_CASE( "Vec3Packed conversion", "[vec3]" ){
+    REQUIRE(sizeof(Vec3Packed) == 12);
+
+    Vec3Packed packed = Vec3(1.5f, -2, 8.25f);
+    REQUIRE(packed == Vec3Packed(1.5f, -2, 8.25f));
+
+    Vec3 unpacked = packed;
+    REQUIRE(unpacked == Vec3(1.5f, -2, 8.25f));
+    REQUIRE(std::hash<Vec3Packed>()(packed) == std::hash<Vec3>()(unpacked));
+}
+
+TEST_CASE( "Vec3d double precision", "[vec3]" ) {
+    Vec3d a(1.0, 2.0, 3.0);
+    Vec3d b(-4.0, 0.5, 2.0);
+
+    REQUIRE(a + b == Vec3d(-3.0, 2.5, 5.0));
+    REQUIRE(Vec3d::cross(Vec3d::right(), Vec3d::up()) == Vec3d::forward());
+    REQUIRE(Vec3d::dot(a, b) == 3.0);
+    REQUIRE(2.0 * a == Vec3d(2.0, 4.0, 6.0));
+
+    // values that are not representable as float survive the round trip through double only
+    Vec3d precise(1.0 + 1e-12, 0.0, 0.0);
+    REQUIRE(precise.x != 1.0);
+    REQUIRE(static_cast<Vec3d>(static_cast<Vec3>(precise)).x == 1.0);
+    REQUIRE(static_cast<Vec3>(a) == Vec3(1, 2, 3));
+    REQUIRE(std::hash<Vec3d>()(a) == std::hash<Vec3d>()(Vec3d(1.0, 2.0, 3.0)));
+}
+
+TEST_CASE( "Vec3 hash", "[vec3]" ) {
+    std::hash<Vec3> hash;
+
+    REQUIRE(hash(Vec3(1, 2, 3)) == hash(Vec3(1, 2, 3)));
+    // -0.0 compares equal to 0.0, so it has to hash equal as well
+    REQUIRE(hash(Vec3(-0.0f, 0, -0.0f)) == hash(Vec3(0, 0, 0)));
+    REQUIRE(hash(Vec3Packed(1, -0.0f, 3)) == hash(Vec3(1, 0, 3)));
+
+    REQUIRE(hash(Vec3(1, 2, 3)) != hash(Vec3(3, 2, 1)));
+    REQUIRE(hash(Vec3(1, 0, 0)) != hash(Vec3(0, 1, 0)));
+    REQUIRE(std::hash<Vec3d>()(Vec3d(1, 2, 3)) != std::hash<Vec3d>()(Vec3d(1, 2, 3.0000001)));
+
+    // neighbouring grid positions must not collide, the old std::hash<float> chain did on libstdc++
+    std::unordered_set<size_t> hashes;
+    for (int x = 0; x < 32; x++) {
+        for (int y = 0; y < 32; y++) {
+            for (int z = 0; z < 32; z++) {
+                hashes.insert(hash(Vec3(x * 0.5f, y * 0.5f, z * 0.5f)));
+            }
+        }
+    }
+    REQUIRE(hashes.size() == 32 * 32 * 32);
+}
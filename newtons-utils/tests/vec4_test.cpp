@@ -55,4 +55,26 @@ TEST_CASE( "Vec4 normalized calculation", "[vec4]" ){
     REQUIRE(Vec4(1, 0, 0, 0).normalized() == Vec4(1, 0, 0, 0));
     REQUIRE(Vec4(-2, 1, -2, -1).normalized() == Vec4(-2, 1, -2, -1) / Mathf::sqrt(10.0f));
     // REQUIRE(Vec3::normalize(Vec3()) == Vec3());
-}
\ No newline at end of file
+}
+TEST_CASE( "Vec4 arithmetic matches constant evaluation", "[vec4]" ){
+    constexpr Vec4 a(1.5f, -2, 8.25f, 3);
+    constexpr Vec4 b(-4, 0.5f, 2, 10);
+
+    constexpr Vec4 sum = a + b;
+    constexpr Vec4 difference = a - b;
+    constexpr Vec4 scaled = a * 2.5f;
+    constexpr float dot = Vec4::dot(a, b);
+
+    Vec4 runtimeA = a;
+    REQUIRE(runtimeA + b == sum);
+    REQUIRE(runtimeA - b == difference);
+    REQUIRE(runtimeA * 2.5f == scaled);
+    REQUIRE(-runtimeA == Vec4(-1.5f, 2, -8.25f, -3));
+    REQUIRE(Vec4::dot(runtimeA, b) == dot);
+
+    runtimeA += b;
+    REQUIRE(runtimeA == sum);
+    runtimeA -= b;
+    runtimeA *= 2.5f;
+    REQUIRE(runtimeA == scaled);
+}
@@ -7,122 +7,143 @@
 
 namespace nwt
 {
-	struct alignas(8) Vec2
+	template<typename T>
+	struct alignas(2 * sizeof(T)) Vec2T
 	{
-		float x, y;
-		constexpr Vec2(float x, float y)
+		T x, y;
+		constexpr Vec2T(T x, T y)
 			: x(x), y(y) {}
-		constexpr Vec2()
+		constexpr Vec2T()
 			: x(0), y(0) {}
 
-		static constexpr Vec2 up();
-		static constexpr Vec2 down();
-		static constexpr Vec2 left();
-		static constexpr Vec2 right();
+		template<typename U>
+		explicit constexpr Vec2T(const Vec2T<U>& other)
+			: x(static_cast<T>(other.x)), y(static_cast<T>(other.y)) {}
 
-		static constexpr Vec2 scale(const Vec2& a, const Vec2& b);
-		static constexpr float dot(const Vec2& a, const Vec2& b);
-		static float distance(const Vec2& a, const Vec2& b);
-		static constexpr Vec2 lerp(const Vec2& a, const Vec2& b, float t);
-		static float angle(const Vec2& a, const Vec2& b);
+		static constexpr Vec2T up();
+		static constexpr Vec2T down();
+		static constexpr Vec2T left();
+		static constexpr Vec2T right();
 
-		constexpr float sqrMagnitude() const;
-		float magnitude() const;
-		static Vec2 normalize(const Vec2& vec);
-		Vec2 normalized();
+		static constexpr Vec2T scale(const Vec2T& a, const Vec2T& b);
+		static constexpr T dot(const Vec2T& a, const Vec2T& b);
+		static constexpr T distance(const Vec2T& a, const Vec2T& b);
+		static constexpr Vec2T lerp(const Vec2T& a, const Vec2T& b, T t);
+		static constexpr T angle(const Vec2T& a, const Vec2T& b);
+
+		constexpr T sqrMagnitude() const;
+		constexpr T magnitude() const;
+		static constexpr Vec2T normalize(const Vec2T& vec);
+		constexpr Vec2T normalized();
 
 		//static Vec2 rotate(const Vec2& v, float angle);
 
-		constexpr bool operator==(const Vec2& other) const;
-		constexpr bool operator!=(const Vec2& other) const;
+		constexpr bool operator==(const Vec2T& other) const;
+		constexpr bool operator!=(const Vec2T& other) const;
 
-		constexpr Vec2 operator+(const Vec2& other) const;
-		constexpr Vec2 operator-(const Vec2& other) const;
-		constexpr Vec2 operator-() const;
-		constexpr Vec2 operator*(float scalar) const;
-		friend constexpr Vec2 operator*(float scalar, const Vec2& v);
-		constexpr Vec2 operator/(float scalar) const;
+		constexpr Vec2T operator+(const Vec2T& other) const;
+		constexpr Vec2T operator-(const Vec2T& other) const;
+		constexpr Vec2T operator-() const;
+		constexpr Vec2T operator*(T scalar) const;
+		friend constexpr Vec2T operator*(T scalar, const Vec2T& v) { return v * scalar; }
+		constexpr Vec2T operator/(T scalar) const;
 
-		constexpr Vec2& operator+=(const Vec2& other);
-		constexpr Vec2& operator-=(const Vec2& other);
-		constexpr Vec2& operator*=(float other);
-		constexpr Vec2& operator/=(float other);
+		constexpr Vec2T& operator+=(const Vec2T& other);
+		constexpr Vec2T& operator-=(const Vec2T& other);
+		constexpr Vec2T& operator*=(T other);
+		constexpr Vec2T& operator/=(T other);
 
 		std::string toString() const;
 	};
 
+	using Vec2 = Vec2T<float>;
+	using Vec2d = Vec2T<double>;
+
 	//
 	// Static functions
 	//
 
-	inline constexpr Vec2 Vec2::up()
+	template<typename T>
+	inline constexpr Vec2T<T> Vec2T<T>::up()
 	{
-		return Vec2(0, 1);
+		return Vec2T<T>(0, 1);
 	}
 
-	inline constexpr Vec2 Vec2::down()
+	template<typename T>
+	inline constexpr Vec2T<T> Vec2T<T>::down()
 	{
-		return Vec2(0, -1);
+		return Vec2T<T>(0, -1);
 	}
 
-	inline constexpr Vec2 Vec2::left()
+	template<typename T>
+	inline constexpr Vec2T<T> Vec2T<T>::left()
 	{
-		return Vec2(-1, 0);
+		return Vec2T<T>(-1, 0);
 	}
 
-	inline constexpr Vec2 Vec2::right()
+	template<typename T>
+	inline constexpr Vec2T<T> Vec2T<T>::right()
 	{
-		return Vec2(1, 0);
+		return Vec2T<T>(1, 0);
 	}
 
-	inline constexpr Vec2 Vec2::scale(const Vec2& a, const Vec2& b)
+	template<typename T>
+	inline constexpr Vec2T<T> Vec2T<T>::scale(const Vec2T<T>& a, const Vec2T<T>& b)
 	{
-		return Vec2(a.x * b.x, a.y * b.y);
+		return Vec2T<T>(a.x * b.x, a.y * b.y);
 	}
 
-	inline constexpr float Vec2::dot(const Vec2& a, const Vec2& b)
+	template<typename T>
+	inline constexpr T Vec2T<T>::dot(const Vec2T<T>& a, const Vec2T<T>& b)
 	{
 		return a.x * b.x + a.y * b.y;
 	}
 
-	inline float Vec2::distance(const Vec2& a, const Vec2& b)
+	template<typename T>
+	inline constexpr T Vec2T<T>::distance(const Vec2T<T>& a, const Vec2T<T>& b)
 	{
 		return (b - a).magnitude();
 	}
 
-	inline constexpr Vec2 Vec2::lerp(const Vec2& a, const Vec2& b, float t)
+	template<typename T>
+	inline constexpr Vec2T<T> Vec2T<T>::lerp(const Vec2T<T>& a, const Vec2T<T>& b, T t)
 	{
 		return a + (b - a) * t;
 	}
 
-	inline float Vec2::angle(const Vec2& a, const Vec2& b){
-		return Mathf::acos(Mathf::clamp(Vec2::dot(a, b) / (a.magnitude() * b.magnitude()), -1, 1));
+	template<typename T>
+	inline constexpr T Vec2T<T>::angle(const Vec2T<T>& a, const Vec2T<T>& b){
+		return Mathf::acos(Mathf::clamp(Vec2T<T>::dot(a, b) / (a.magnitude() * b.magnitude()), T(-1), T(1)));
 	}
 
 	//
 	// Member functions
 	//
 
-	inline constexpr float Vec2::sqrMagnitude() const
+	template<typename T>
+	inline constexpr T Vec2T<T>::sqrMagnitude() const
 	{
 		return x * x + y * y;
 	}
 
-	inline float Vec2::magnitude() const
+	template<typename T>
+	inline constexpr T Vec2T<T>::magnitude() const
 	{
 		return Mathf::sqrt(x * x + y * y);
 	}
 
-	inline Vec2 Vec2::normalize(const Vec2& vec)
+	template<typename T>
+	inline constexpr Vec2T<T> Vec2T<T>::normalize(const Vec2T<T>& vec)
 	{
 		// TODO: Avoid division by zero in Debug mode
-		float magnitude = vec.magnitude();
+		T magnitude = vec.magnitude();
 		return vec / magnitude;
 	}
 
-	inline Vec2 Vec2::normalized()
+	template<typename T>
+	inline constexpr Vec2T<T> Vec2T<T>::normalized()
 	{
-		float magnitude = this->magnitude();
+		T magnitude = this->magnitude();
 
 		return { x / magnitude, y / magnitude };
 	}
@@ -136,87 +157,93 @@ namespace nwt
 	// Operators
 	//
 
-	inline constexpr bool Vec2::operator==(const Vec2& other) const
+	template<typename T>
+	inline constexpr bool Vec2T<T>::operator==(const Vec2T<T>& other) const
 	{
 		return Mathf::inEpsilon(x - other.x) && Mathf::inEpsilon(y - other.y);
 	}
 
-	inline constexpr bool Vec2::operator!=(const Vec2& other) const
+	template<typename T>
+	inline constexpr bool Vec2T<T>::operator!=(const Vec2T<T>& other) const
 	{
 		return !(*this == other);
 	}
 
-	inline constexpr Vec2 Vec2::operator+(const Vec2& other) const
+	template<typename T>
+	inline constexpr Vec2T<T> Vec2T<T>::operator+(const Vec2T<T>& other) const
 	{
-		return Vec2(x + other.x, y + other.y);
+		return Vec2T<T>(x + other.x, y + other.y);
 	}
 
-	inline constexpr Vec2 Vec2::operator-(const Vec2& other) const
+	template<typename T>
+	inline constexpr Vec2T<T> Vec2T<T>::operator-(const Vec2T<T>& other) const
 	{
-		return Vec2(x - other.x, y - other.y);
+		return Vec2T<T>(x - other.x, y - other.y);
 	}
 
-	inline constexpr Vec2 Vec2::operator-() const
+	template<typename T>
+	inline constexpr Vec2T<T> Vec2T<T>::operator-() const
 	{
-		return Vec2(-x, -y);
+		return Vec2T<T>(-x, -y);
 	}
 
-	inline constexpr Vec2 Vec2::operator*(float scalar) const
+	template<typename T>
+	inline constexpr Vec2T<T> Vec2T<T>::operator*(T scalar) const
 	{
-		return Vec2(x * scalar, y * scalar);
+		return Vec2T<T>(x * scalar, y * scalar);
 	}
 
-	inline constexpr Vec2 operator*(float scalar, const Vec2& other)
-	{
-		return other * scalar;
-	}
 
-	inline constexpr Vec2 Vec2::operator/(float scalar) const
+	template<typename T>
+	inline constexpr Vec2T<T> Vec2T<T>::operator/(T scalar) const
 	{
-		return Vec2(x / scalar, y / scalar);
+		return Vec2T<T>(x / scalar, y / scalar);
 	}
 
-	inline constexpr Vec2& Vec2::operator+=(const Vec2& other)
+	template<typename T>
+	inline constexpr Vec2T<T>& Vec2T<T>::operator+=(const Vec2T<T>& other)
 	{
 		x += other.x;
 		y += other.y;
 		return *this;
 	}
 
-	inline constexpr Vec2& Vec2::operator-=(const Vec2& other)
+	template<typename T>
+	inline constexpr Vec2T<T>& Vec2T<T>::operator-=(const Vec2T<T>& other)
 	{
 		x -= other.x;
 		y -= other.y;
 		return *this;
 	}
 
-	inline constexpr Vec2& Vec2::operator*=(float scalar)
+	template<typename T>
+	inline constexpr Vec2T<T>& Vec2T<T>::operator*=(T scalar)
 	{
 		x *= scalar;
 		y *= scalar;
 		return *this;
 	}
 
-	inline constexpr Vec2& Vec2::operator/=(float scalar)
+	template<typename T>
+	inline constexpr Vec2T<T>& Vec2T<T>::operator/=(T scalar)
 	{
 		x /= scalar;
 		y /= scalar;
 		return *this;
 	}
 
-	inline std::string Vec2::toString() const{
+	template<typename T>
+	inline std::string Vec2T<T>::toString() const{
 		return ("(" + std::to_string(x) + "," + std::to_string(y) + ")");
 	}
 
 } // namespace nwt
 
 namespace std {
-	template<>
-	struct hash<nwt::Vec2> {
-		size_t operator()(nwt::Vec2 const& vec) const {
-			size_t combinedHash = hash<float>()(vec.x);
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(vec.y));
-			return combinedHash;
+	template<typename T>
+	struct hash<nwt::Vec2T<T>> {
+		size_t operator()(nwt::Vec2T<T> const& vec) const {
+			return nwt::Hash::HashFloats(vec.x, vec.y);
 		}
 	};
 }
\ No newline at end of file
@@ -7,118 +7,138 @@
 
 namespace nwt
 {
-	struct alignas(16) Vec3
+	template<typename T>
+	struct alignas(4 * sizeof(T)) Vec3T
 	{
-		float x, y, z;
-		constexpr Vec3(float x, float y, float z)
+		T x, y, z;
+		constexpr Vec3T(T x, T y, T z)
 			: x(x), y(y), z(z) {}
-		constexpr Vec3()
+		constexpr Vec3T()
 			: x(0), y(0), z(0) {}
 
-		static constexpr Vec3 up();
-		static constexpr Vec3 down();
-		static constexpr Vec3 left();
-		static constexpr Vec3 right();
-		static constexpr Vec3 forward();
-		static constexpr Vec3 backward();
-
-		static constexpr Vec3 scale(const Vec3& a, const Vec3& b);
-		static constexpr float dot(const Vec3& a, const Vec3& b);
-		static constexpr Vec3 cross(const Vec3& a, const Vec3& b);
-		static float distance(const Vec3& a, const Vec3& b);
-		static constexpr Vec3 lerp(const Vec3& a, const Vec3& b, float t);
-		static float angle(const Vec3& a, const Vec3& b);
-
-		float constexpr sqrMagnitude() const;
-		float magnitude() const;
-		static Vec3 normalize(const Vec3& vec);
-		Vec3 normalized();
-
-		constexpr bool operator==(const Vec3& other) const;
-		constexpr bool operator!=(const Vec3& other) const;
-
-		constexpr Vec3 operator+(const Vec3& other) const;
-		constexpr Vec3 operator-(const Vec3& other) const;
-		constexpr Vec3 operator-() const;
-		constexpr Vec3 operator*(float scalar) const;
-		friend constexpr Vec3 operator*(float scalar, const Vec3& v);
-		constexpr Vec3 operator/(float scalar) const;
-
-		constexpr Vec3& operator+=(const Vec3& other);
-		constexpr Vec3& operator-=(const Vec3& other);
-		constexpr Vec3& operator*=(float other);
-		constexpr Vec3& operator/=(float other);
-
-		explicit constexpr operator Vec2() const;
+		template<typename U>
+		explicit constexpr Vec3T(const Vec3T<U>& other)
+			: x(static_cast<T>(other.x)), y(static_cast<T>(other.y)), z(static_cast<T>(other.z)) {}
+
+		static constexpr Vec3T up();
+		static constexpr Vec3T down();
+		static constexpr Vec3T left();
+		static constexpr Vec3T right();
+		static constexpr Vec3T forward();
+		static constexpr Vec3T backward();
+
+		static constexpr Vec3T scale(const Vec3T& a, const Vec3T& b);
+		static constexpr T dot(const Vec3T& a, const Vec3T& b);
+		static constexpr Vec3T cross(const Vec3T& a, const Vec3T& b);
+		static constexpr T distance(const Vec3T& a, const Vec3T& b);
+		static constexpr Vec3T lerp(const Vec3T& a, const Vec3T& b, T t);
+		static constexpr T angle(const Vec3T& a, const Vec3T& b);
+
+		T constexpr sqrMagnitude() const;
+		constexpr T magnitude() const;
+		static constexpr Vec3T normalize(const Vec3T& vec);
+		constexpr Vec3T normalized();
+
+		constexpr bool operator==(const Vec3T& other) const;
+		constexpr bool operator!=(const Vec3T& other) const;
+
+		constexpr Vec3T operator+(const Vec3T& other) const;
+		constexpr Vec3T operator-(const Vec3T& other) const;
+		constexpr Vec3T operator-() const;
+		constexpr Vec3T operator*(T scalar) const;
+		friend constexpr Vec3T operator*(T scalar, const Vec3T& v) { return v * scalar; }
+		constexpr Vec3T operator/(T scalar) const;
+
+		constexpr Vec3T& operator+=(const Vec3T& other);
+		constexpr Vec3T& operator-=(const Vec3T& other);
+		constexpr Vec3T& operator*=(T other);
+		constexpr Vec3T& operator/=(T other);
+
+		explicit constexpr operator Vec2T<T>() const;
 
 		std::string toString() const;
 	};
 
+	using Vec3 = Vec3T<float>;
+	using Vec3d = Vec3T<double>;
+
 	//
 	// Static functions
 	//
 
-	inline constexpr Vec3 Vec3::up()
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::up()
 	{
-		return Vec3(0, 1, 0);
+		return Vec3T<T>(0, 1, 0);
 	}
 
-	inline constexpr Vec3 Vec3::down()
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::down()
 	{
-		return Vec3(0, -1, 0);
+		return Vec3T<T>(0, -1, 0);
 	}
 
-	inline constexpr Vec3 Vec3::left()
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::left()
 	{
-		return Vec3(-1, 0, 0);
+		return Vec3T<T>(-1, 0, 0);
 	}
 
-	inline constexpr Vec3 Vec3::right()
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::right()
 	{
-		return Vec3(1, 0, 0);
+		return Vec3T<T>(1, 0, 0);
 	}
 
-	inline constexpr Vec3 Vec3::forward()
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::forward()
 	{
-		return Vec3(0, 0, 1);
+		return Vec3T<T>(0, 0, 1);
 	}
 
-	inline constexpr Vec3 Vec3::backward()
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::backward()
 	{
-		return Vec3(0, 0, -1);
+		return Vec3T<T>(0, 0, -1);
 	}
 
-	inline constexpr Vec3 Vec3::scale(const Vec3& a, const Vec3& b)
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::scale(const Vec3T<T>& a, const Vec3T<T>& b)
 	{
-		return Vec3(a.x * b.x, a.y * b.y, a.z * b.z);
+		return Vec3T<T>(a.x * b.x, a.y * b.y, a.z * b.z);
 	}
 
-	inline constexpr float Vec3::dot(const Vec3& a, const Vec3& b)
+	template<typename T>
+	inline constexpr T Vec3T<T>::dot(const Vec3T<T>& a, const Vec3T<T>& b)
 	{
 		return a.x * b.x + a.y * b.y + a.z * b.z;
 	}
 
-	inline constexpr Vec3 Vec3::cross(const Vec3& lhs, const Vec3& rhs)
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::cross(const Vec3T<T>& lhs, const Vec3T<T>& rhs)
 	{
-		return Vec3(
+		return Vec3T<T>(
 			lhs.y * rhs.z - lhs.z * rhs.y,
 			lhs.z * rhs.x - lhs.x * rhs.z,
 			lhs.x * rhs.y - lhs.y * rhs.x
 		);
 	}
 
-	inline float Vec3::distance(const Vec3& a, const Vec3& b)
+	template<typename T>
+	inline constexpr T Vec3T<T>::distance(const Vec3T<T>& a, const Vec3T<T>& b)
 	{
 		return (b - a).magnitude();
 	}
 
-	inline constexpr Vec3 Vec3::lerp(const Vec3& a, const Vec3& b, float t)
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::lerp(const Vec3T<T>& a, const Vec3T<T>& b, T t)
 	{
 		return a + (b - a) * t;
 	}
 
-	inline float Vec3::angle(const Vec3& a, const Vec3& b){
-		return Mathf::acos(Mathf::clamp(Vec3::dot(a, b) / (a.magnitude() * b.magnitude()), -1, 1));
+	template<typename T>
+	inline constexpr T Vec3T<T>::angle(const Vec3T<T>& a, const Vec3T<T>& b){
+		return Mathf::acos(Mathf::clamp(Vec3T<T>::dot(a, b) / (a.magnitude() * b.magnitude()), T(-1), T(1)));
 	}
 
 
@@ -126,26 +146,30 @@ namespace nwt
 	// Member functions
 	//
 
-	inline constexpr float Vec3::sqrMagnitude() const
+	template<typename T>
+	inline constexpr T Vec3T<T>::sqrMagnitude() const
 	{
 		return x * x + y * y + z * z;
 	}
 
-	inline float Vec3::magnitude() const
+	template<typename T>
+	inline constexpr T Vec3T<T>::magnitude() const
 	{
 		return Mathf::sqrt(x * x + y * y + z * z);
 	}
 
-	inline Vec3 Vec3::normalize(const Vec3& vec)
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::normalize(const Vec3T<T>& vec)
 	{
 		// TODO: Avoid division by zero in Debug mode
-		float magnitude = vec.magnitude();
+		T magnitude = vec.magnitude();
 		return vec / magnitude;
 	}
 
-	inline Vec3 Vec3::normalized()
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::normalized()
 	{
-		float magnitude = this->magnitude();
+		T magnitude = this->magnitude();
 
 		return { x / magnitude, y / magnitude, z / magnitude };
 	}
@@ -154,47 +178,51 @@ namespace nwt
 	// Operators
 	//
 
-	inline constexpr bool Vec3::operator==(const Vec3& other) const
+	template<typename T>
+	inline constexpr bool Vec3T<T>::operator==(const Vec3T<T>& other) const
 	{
 		return Mathf::inEpsilon(x -other.x) && Mathf::inEpsilon(y - other.y) && Mathf::inEpsilon(z - other.z); 
 	}
 
-	inline constexpr bool Vec3::operator!=(const Vec3& other) const
+	template<typename T>
+	inline constexpr bool Vec3T<T>::operator!=(const Vec3T<T>& other) const
 	{
 		return !(*this == other);
 	}
 
-	inline constexpr Vec3 Vec3::operator+(const Vec3& other) const
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::operator+(const Vec3T<T>& other) const
 	{
-		return Vec3(x + other.x, y + other.y, z + other.z);
+		return Vec3T<T>(x + other.x, y + other.y, z + other.z);
 	}
 
-	inline constexpr Vec3 Vec3::operator-(const Vec3& other) const
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::operator-(const Vec3T<T>& other) const
 	{
-		return Vec3(x - other.x, y - other.y, z - other.z);
+		return Vec3T<T>(x - other.x, y - other.y, z - other.z);
 	}
 
-	inline constexpr Vec3 Vec3::operator-() const
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::operator-() const
 	{
-		return Vec3(-x, -y, -z);
+		return Vec3T<T>(-x, -y, -z);
 	}
 
-	inline constexpr Vec3 Vec3::operator*(float scalar) const
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::operator*(T scalar) const
 	{
-		return Vec3(x * scalar, y * scalar, z * scalar);
+		return Vec3T<T>(x * scalar, y * scalar, z * scalar);
 	}
 
-	inline constexpr Vec3 operator*(float scalar, const Vec3& v)
-	{
-		return v * scalar;
-	}
 
-	inline constexpr Vec3 Vec3::operator/(float scalar) const
+	template<typename T>
+	inline constexpr Vec3T<T> Vec3T<T>::operator/(T scalar) const
 	{
-		return Vec3(x / scalar, y / scalar, z / scalar);
+		return Vec3T<T>(x / scalar, y / scalar, z / scalar);
 	}
 
-	inline constexpr Vec3& Vec3::operator+=(const Vec3& other)
+	template<typename T>
+	inline constexpr Vec3T<T>& Vec3T<T>::operator+=(const Vec3T<T>& other)
 	{
 		x += other.x;
 		y += other.y;
@@ -202,7 +230,8 @@ namespace nwt
 		return *this;
 	}
 
-	inline constexpr Vec3& Vec3::operator-=(const Vec3& other)
+	template<typename T>
+	inline constexpr Vec3T<T>& Vec3T<T>::operator-=(const Vec3T<T>& other)
 	{
 		x -= other.x;
 		y -= other.y;
@@ -210,7 +239,8 @@ namespace nwt
 		return *this;
 	}
 
-	inline constexpr Vec3& Vec3::operator*=(float scalar)
+	template<typename T>
+	inline constexpr Vec3T<T>& Vec3T<T>::operator*=(T scalar)
 	{
 		x *= scalar;
 		y *= scalar;
@@ -218,7 +248,8 @@ namespace nwt
 		return *this;
 	}
 
-	inline constexpr Vec3& Vec3::operator/=(float scalar)
+	template<typename T>
+	inline constexpr Vec3T<T>& Vec3T<T>::operator/=(T scalar)
 	{
 		x /= scalar;
 		y /= scalar;
@@ -226,23 +257,78 @@ namespace nwt
 		return *this;
 	}
 
-	inline constexpr Vec3::operator Vec2() const {
+	template<typename T>
+	inline constexpr Vec3T<T>::operator Vec2T<T>() const {
 		return {x, y};
 	}
 
-	inline std::string Vec3::toString() const{
+	template<typename T>
+	inline std::string Vec3T<T>::toString() const{
+		return ("(" + std::to_string(x) + "," + std::to_string(y) + "," + std::to_string(z) + ")");
+	}
+
+	/// <summary>
+	/// Tightly packed storage for Vec3T (12 bytes for float), used for vertex and mesh data.
+	/// Convert to Vec3T for any calculation.
+	/// </summary>
+	template<typename T>
+	struct Vec3PackedT
+	{
+		T x, y, z;
+		constexpr Vec3PackedT(T x, T y, T z)
+			: x(x), y(y), z(z) {}
+		constexpr Vec3PackedT()
+			: x(0), y(0), z(0) {}
+		constexpr Vec3PackedT(const Vec3T<T>& vec)
+			: x(vec.x), y(vec.y), z(vec.z) {}
+
+		constexpr operator Vec3T<T>() const;
+
+		constexpr bool operator==(const Vec3PackedT& other) const;
+		constexpr bool operator!=(const Vec3PackedT& other) const;
+
+		std::string toString() const;
+	};
+
+	using Vec3Packed = Vec3PackedT<float>;
+
+	static_assert(sizeof(Vec3Packed) == 3 * sizeof(float), "Vec3Packed must not be padded");
+
+	template<typename T>
+	inline constexpr Vec3PackedT<T>::operator Vec3T<T>() const {
+		return { x, y, z };
+	}
+
+	template<typename T>
+	inline constexpr bool Vec3PackedT<T>::operator==(const Vec3PackedT<T>& other) const
+	{
+		return Mathf::inEpsilon(x - other.x) && Mathf::inEpsilon(y - other.y) && Mathf::inEpsilon(z - other.z);
+	}
+
+	template<typename T>
+	inline constexpr bool Vec3PackedT<T>::operator!=(const Vec3PackedT<T>& other) const
+	{
+		return !(*this == other);
+	}
+
+	template<typename T>
+	inline std::string Vec3PackedT<T>::toString() const{
 		return ("(" + std::to_string(x) + "," + std::to_string(y) + "," + std::to_string(z) + ")");
 	}
 } // namespace nwt
 
 namespace std {
-	template<>
-	struct hash<nwt::Vec3> {
-		size_t operator()(nwt::Vec3 const& vec) const {
-			size_t combinedHash = hash<float>()(vec.x);
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(vec.y));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(vec.z));
-			return combinedHash;
+	template<typename T>
+	struct hash<nwt::Vec3T<T>> {
+		size_t operator()(nwt::Vec3T<T> const& vec) const {
+			return nwt::Hash::HashFloats(vec.x, vec.y, vec.z);
+		}
+	};
+
+	template<typename T>
+	struct hash<nwt::Vec3PackedT<T>> {
+		size_t operator()(nwt::Vec3PackedT<T> const& vec) const {
+			return hash<nwt::Vec3T<T>>()(vec);
 		}
 	};
 }
\ No newline at end of file
@@ -3,70 +3,99 @@
 #include "mathf.hpp"
 #include "vec3.hpp"
 #include "hash.hpp"
+#include "simd.hpp"
 
 #include <iostream>
 #include <string>
 
 namespace nwt
 {
-	struct alignas(16) Vec4
+	template<typename T>
+	struct alignas(4 * sizeof(T)) Vec4T
 	{
-		float x, y, z, w;
-		constexpr Vec4(float x, float y, float z, float w)
+		T x, y, z, w;
+		constexpr Vec4T(T x, T y, T z, T w)
 			: x(x), y(y), z(z), w(w) {}
-		constexpr Vec4()
+		constexpr Vec4T()
 			: x(0), y(0), z(0), w(0) {}
 
-		static constexpr Vec4 scale(const Vec4& a, const Vec4& b);
-		static constexpr float dot(const Vec4& a, const Vec4& b);
-		static float distance(const Vec4& a, const Vec4& b);
-		static constexpr Vec4 lerp(const Vec4& a, const Vec4& b, float t);
+		template<typename U>
+		explicit constexpr Vec4T(const Vec4T<U>& other)
+			: x(static_cast<T>(other.x)), y(static_cast<T>(other.y)), z(static_cast<T>(other.z)), w(static_cast<T>(other.w)) {}
 
-		float constexpr sqrMagnitude() const;
-		float magnitude() const;
-		static Vec4 normalize(const Vec4& vec);
-		Vec4 normalized();
+		static constexpr Vec4T scale(const Vec4T& a, const Vec4T& b);
+		static constexpr T dot(const Vec4T& a, const Vec4T& b);
+		static constexpr T distance(const Vec4T& a, const Vec4T& b);
+		static constexpr Vec4T lerp(const Vec4T& a, const Vec4T& b, T t);
 
-		constexpr bool operator==(const Vec4& other) const;
-		constexpr bool operator!=(const Vec4& other) const;
+		T constexpr sqrMagnitude() const;
+		constexpr T magnitude() const;
+		static constexpr Vec4T normalize(const Vec4T& vec);
+		constexpr Vec4T normalized();
 
-		constexpr Vec4 operator+(const Vec4& other) const;
-		constexpr Vec4 operator-(const Vec4& other) const;
-		constexpr Vec4 operator-() const;
-		constexpr Vec4 operator*(float scalar) const;
-		friend constexpr Vec4 operator*(float scalar, const Vec4& v);
-		constexpr Vec4 operator/(float scalar) const;
+		constexpr bool operator==(const Vec4T& other) const;
+		constexpr bool operator!=(const Vec4T& other) const;
 
-		constexpr Vec4& operator+=(const Vec4& other);
-		constexpr Vec4& operator-=(const Vec4& other);
-		constexpr Vec4& operator*=(float other);
-		constexpr Vec4& operator/=(float other);
+		constexpr Vec4T operator+(const Vec4T& other) const;
+		constexpr Vec4T operator-(const Vec4T& other) const;
+		constexpr Vec4T operator-() const;
+		constexpr Vec4T operator*(T scalar) const;
+		friend constexpr Vec4T operator*(T scalar, const Vec4T& v) { return v * scalar; }
+		constexpr Vec4T operator/(T scalar) const;
 
-		explicit constexpr operator Vec3() const;
+		constexpr Vec4T& operator+=(const Vec4T& other);
+		constexpr Vec4T& operator-=(const Vec4T& other);
+		constexpr Vec4T& operator*=(T other);
+		constexpr Vec4T& operator/=(T other);
+
+		explicit constexpr operator Vec3T<T>() const;
 
 		std::string toString() const;
 	};
 
+	using Vec4 = Vec4T<float>;
+	using Vec4d = Vec4T<double>;
+
 	//
 	// Static functions
 	//
 
-	inline constexpr Vec4 Vec4::scale(const Vec4& a, const Vec4& b)
+	template<typename T>
+	inline constexpr Vec4T<T> Vec4T<T>::scale(const Vec4T<T>& a, const Vec4T<T>& b)
 	{
-		return Vec4(a.x * b.x, a.y * b.y, a.z * b.z, a.w *b.w);
+#if defined(NWT_SIMD_ENABLED)
+		if constexpr (simd::enabled<T>) {
+			if !consteval {
+				Vec4T<T> result;
+				simd::store(&result.x, simd::mul(simd::load(&a.x), simd::load(&b.x)));
+				return result;
+			}
+		}
+#endif
+		return Vec4T<T>(a.x * b.x, a.y * b.y, a.z * b.z, a.w *b.w);
 	}
 
-	inline constexpr float Vec4::dot(const Vec4& a, const Vec4& b)
+	template<typename T>
+	inline constexpr T Vec4T<T>::dot(const Vec4T<T>& a, const Vec4T<T>& b)
 	{
+#if defined(NWT_SIMD_ENABLED)
+		if constexpr (simd::enabled<T>) {
+			if !consteval {
+				return simd::dot(simd::load(&a.x), simd::load(&b.x));
+			}
+		}
+#endif
 		return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
 	}
 
-	inline float Vec4::distance(const Vec4& a, const Vec4& b)
+	template<typename T>
+	inline constexpr T Vec4T<T>::distance(const Vec4T<T>& a, const Vec4T<T>& b)
 	{
 		return (b - a).magnitude();
 	}
 
-	inline constexpr Vec4 Vec4::lerp(const Vec4& a, const Vec4& b, float t)
+	template<typename T>
+	inline constexpr Vec4T<T> Vec4T<T>::lerp(const Vec4T<T>& a, const Vec4T<T>& b, T t)
 	{
 		return a + (b - a) * t;
 	}
@@ -75,26 +104,30 @@ namespace nwt
 	// Member functions
 	//
 
-	inline constexpr float Vec4::sqrMagnitude() const
+	template<typename T>
+	inline constexpr T Vec4T<T>::sqrMagnitude() const
 	{
 		return x * x + y * y + z * z + w * w;
 	}
 
-	inline float Vec4::magnitude() const
+	template<typename T>
+	inline constexpr T Vec4T<T>::magnitude() const
 	{
 		return Mathf::sqrt(x * x + y * y + z * z + w * w);
 	}
 
-	inline Vec4 Vec4::normalize(const Vec4& vec)
+	template<typename T>
+	inline constexpr Vec4T<T> Vec4T<T>::normalize(const Vec4T<T>& vec)
 	{
 		// TODO: Avoid division by zero in Debug mode
-		float magnitude = vec.magnitude();
+		T magnitude = vec.magnitude();
 		return vec / magnitude;
 	}
 
-	inline Vec4 Vec4::normalized()
+	template<typename T>
+	inline constexpr Vec4T<T> Vec4T<T>::normalized()
 	{
-		float magnitude = this->magnitude();
+		T magnitude = this->magnitude();
 
 		return {x / magnitude, y / magnitude, z / magnitude, w / magnitude};
 	}
@@ -103,48 +136,96 @@ namespace nwt
 	// Operators
 	//
 
-	inline constexpr bool Vec4::operator==(const Vec4& other) const
+	template<typename T>
+	inline constexpr bool Vec4T<T>::operator==(const Vec4T<T>& other) const
 	{
 		return Mathf::inEpsilon(x - other.x) && Mathf::inEpsilon(y - other.y) && Mathf::inEpsilon(z - other.z) && Mathf::inEpsilon(w - other.w);
 	}
 
-	inline constexpr bool Vec4::operator!=(const Vec4& other) const
+	template<typename T>
+	inline constexpr bool Vec4T<T>::operator!=(const Vec4T<T>& other) const
 	{
 		return !(*this == other);
 	}
 
-	inline constexpr Vec4 Vec4::operator+(const Vec4& other) const
+	template<typename T>
+	inline constexpr Vec4T<T> Vec4T<T>::operator+(const Vec4T<T>& other) const
 	{
-		return Vec4(x + other.x, y + other.y, z + other.z, w + other.w);
+#if defined(NWT_SIMD_ENABLED)
+		if constexpr (simd::enabled<T>) {
+			if !consteval {
+				Vec4T<T> result;
+				simd::store(&result.x, simd::add(simd::load(&x), simd::load(&other.x)));
+				return result;
+			}
+		}
+#endif
+		return Vec4T<T>(x + other.x, y + other.y, z + other.z, w + other.w);
 	}
 
-	inline constexpr Vec4 Vec4::operator-(const Vec4& other) const
+	template<typename T>
+	inline constexpr Vec4T<T> Vec4T<T>::operator-(const Vec4T<T>& other) const
 	{
-		return Vec4(x - other.x, y - other.y, z - other.z, w - other.w);
+#if defined(NWT_SIMD_ENABLED)
+		if constexpr (simd::enabled<T>) {
+			if !consteval {
+				Vec4T<T> result;
+				simd::store(&result.x, simd::sub(simd::load(&x), simd::load(&other.x)));
+				return result;
+			}
+		}
+#endif
+		return Vec4T<T>(x - other.x, y - other.y, z - other.z, w - other.w);
 	}
 
-	inline constexpr Vec4 Vec4::operator-() const
+	template<typename T>
+	inline constexpr Vec4T<T> Vec4T<T>::operator-() const
 	{
-		return Vec4(-x, -y, -z, -w);
+#if defined(NWT_SIMD_ENABLED)
+		if constexpr (simd::enabled<T>) {
+			if !consteval {
+				Vec4T<T> result;
+				simd::store(&result.x, simd::neg(simd::load(&x)));
+				return result;
+			}
+		}
+#endif
+		return Vec4T<T>(-x, -y, -z, -w);
 	}
 
-	inline constexpr Vec4 Vec4::operator*(float scalar) const
+	template<typename T>
+	inline constexpr Vec4T<T> Vec4T<T>::operator*(T scalar) const
 	{
-		return Vec4(x * scalar, y * scalar, z * scalar, w * scalar);
+#if defined(NWT_SIMD_ENABLED)
+		if constexpr (simd::enabled<T>) {
+			if !consteval {
+				Vec4T<T> result;
+				simd::store(&result.x, simd::mul(simd::load(&x), simd::splat(scalar)));
+				return result;
+			}
+		}
+#endif
+		return Vec4T<T>(x * scalar, y * scalar, z * scalar, w * scalar);
 	}
 
-	inline constexpr Vec4 operator*(float scalar, const Vec4& v)
-	{
-		return v * scalar;
-	}
 
-	inline constexpr Vec4 Vec4::operator/(float scalar) const
+	template<typename T>
+	inline constexpr Vec4T<T> Vec4T<T>::operator/(T scalar) const
 	{
-		return Vec4(x / scalar, y / scalar, z / scalar, w / scalar);
+		return Vec4T<T>(x / scalar, y / scalar, z / scalar, w / scalar);
 	}
 
-	inline constexpr Vec4& Vec4::operator+=(const Vec4& other)
+	template<typename T>
+	inline constexpr Vec4T<T>& Vec4T<T>::operator+=(const Vec4T<T>& other)
 	{
+#if defined(NWT_SIMD_ENABLED)
+		if constexpr (simd::enabled<T>) {
+			if !consteval {
+				simd::store(&x, simd::add(simd::load(&x), simd::load(&other.x)));
+				return *this;
+			}
+		}
+#endif
 		x += other.x;
 		y += other.y;
 		z += other.z;
@@ -152,8 +233,17 @@ namespace nwt
 		return *this;
 	}
 
-	inline constexpr Vec4& Vec4::operator-=(const Vec4& other)
+	template<typename T>
+	inline constexpr Vec4T<T>& Vec4T<T>::operator-=(const Vec4T<T>& other)
 	{
+#if defined(NWT_SIMD_ENABLED)
+		if constexpr (simd::enabled<T>) {
+			if !consteval {
+				simd::store(&x, simd::sub(simd::load(&x), simd::load(&other.x)));
+				return *this;
+			}
+		}
+#endif
 		x -= other.x;
 		y -= other.y;
 		z -= other.z;
@@ -161,8 +251,17 @@ namespace nwt
 		return *this;
 	}
 
-	inline constexpr Vec4& Vec4::operator*=(float scalar)
+	template<typename T>
+	inline constexpr Vec4T<T>& Vec4T<T>::operator*=(T scalar)
 	{
+#if defined(NWT_SIMD_ENABLED)
+		if constexpr (simd::enabled<T>) {
+			if !consteval {
+				simd::store(&x, simd::mul(simd::load(&x), simd::splat(scalar)));
+				return *this;
+			}
+		}
+#endif
 		x *= scalar;
 		y *= scalar;
 		z *= scalar;
@@ -170,7 +269,8 @@ namespace nwt
 		return *this;
 	}
 
-	inline constexpr Vec4& Vec4::operator/=(float scalar)
+	template<typename T>
+	inline constexpr Vec4T<T>& Vec4T<T>::operator/=(T scalar)
 	{
 		x /= scalar;
 		y /= scalar;
@@ -179,24 +279,22 @@ namespace nwt
 		return *this;
 	}
 
-	inline constexpr Vec4::operator Vec3() const {
+	template<typename T>
+	inline constexpr Vec4T<T>::operator Vec3T<T>() const {
 		return { x, y, z };
 	}
 
-	inline std::string Vec4::toString() const {
+	template<typename T>
+	inline std::string Vec4T<T>::toString() const {
 		return ("(" + std::to_string(x) + "," + std::to_string(y) + "," + std::to_string(z) + "," + std::to_string(w) + ")");
 	}
 } // namespace nwt
 
 namespace std {
-	template<>
-	struct hash<nwt::Vec4> {
-		size_t operator()(nwt::Vec4 const& vec) const {
-			size_t combinedHash = hash<float>()(vec.x);
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(vec.y));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(vec.z));
-			nwt::Hash::HashCombine(combinedHash, hash<float>()(vec.w));
-			return combinedHash;
+	template<typename T>
+	struct hash<nwt::Vec4T<T>> {
+		size_t operator()(nwt::Vec4T<T> const& vec) const {
+			return nwt::Hash::HashFloats(vec.x, vec.y, vec.z, vec.w);
 		}
 	};
 }
\ No newline at end of file